@@ -1,4 +1,4 @@
-QT       += core gui sql widgets
+QT       += core gui sql widgets concurrent
 
 TARGET = Baseball_Program
 TEMPLATE = app
@@ -17,21 +17,31 @@ win32 {
 SOURCES += \
     src/main.cpp \
     src/mainwindow.cpp \
-    src/database.cpp \
     src/adminpanel.cpp \
     src/souvenirdialog.cpp \
     src/tripplanner.cpp \
-    src/stadiumgraph.cpp \
-    src/trip.cpp
+    src/benchmarks.cpp \
+    src/teamlistmodel.cpp
 
 HEADERS += \
     src/mainwindow.h \
-    src/database.h \
     src/adminpanel.h \
     src/souvenirdialog.h \
     src/tripplanner.h \
-    src/stadiumgraph.h \
-    src/trip.h
+    src/benchmarks.h \
+    src/teamlistmodel.h
+
+# Everything but the widgets, shared with the tests
+include(src/core.pri)
+
+# Heap allocation counts in --benchmark. This replaces malloc for the whole
+# process, so only build it for benchmarking:
+#   qmake CONFIG+=count_allocations
+count_allocations {
+    SOURCES += src/allocationcounter.cpp
+    HEADERS += src/allocationcounter.h
+    DEFINES += COUNT_ALLOCATIONS
+}
 
 FORMS += \
     src/mainwindow.ui \
@@ -44,6 +54,15 @@ qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
 
+# Regenerate the compiled-in default dataset after editing the bundled CSVs:
+#   make defaultdata
+defaultdata.target = defaultdata
+defaultdata.commands = python3 $$shell_quote($$PWD/tools/embed_defaults.py) \
+    --teams $$shell_quote($$PWD/MLB Information.csv) \
+    --distances $$shell_quote($$PWD/Distance between stadiums.csv) \
+    --output $$shell_quote($$PWD/src/defaultdata.cpp)
+QMAKE_EXTRA_TARGETS += defaultdata
+
 # Ensure the database file is copied to the build directory
 DISTFILES += \
     README.md
@@ -67,6 +67,11 @@ void AdminPanel::setupUi()
     QPushButton* saveButton = new QPushButton("Save Changes", this);
     ui->verticalLayout_2->addWidget(saveButton);
     connect(saveButton, &QPushButton::clicked, this, &AdminPanel::saveStadiumChanges);
+
+    // League-wide price adjustments for souvenirs
+    QPushButton* bulkPriceButton = new QPushButton("Bulk Price Update...", this);
+    ui->verticalLayout_3->addWidget(bulkPriceButton);
+    connect(bulkPriceButton, &QPushButton::clicked, this, &AdminPanel::bulkUpdatePrices);
 }
 
 void AdminPanel::loadTeams()
@@ -118,6 +123,12 @@ void AdminPanel::on_importStadiumButton_clicked()
 
     // Start the import process
     if (db->importFromCSV(fileNames)) {
+        if (hotReloader) {
+            for (const QString &fileName : fileNames) {
+                hotReloader->watchTeamFile(fileName);
+            }
+        }
+
         // Load all teams into the table
         QSqlQuery query = db->getAllTeamsSortedByTeamName();
         while (query.next()) {
@@ -145,9 +156,7 @@ void AdminPanel::on_importStadiumButton_clicked()
 
 void AdminPanel::saveStadiumChanges()
 {
-    db->database().transaction();
-    bool success = true;
-
+    QVector<TeamRow> rows;
     for (int row = 0; row < ui->stadiumTable->rowCount(); ++row) {
         QString teamName = ui->stadiumTable->item(row, 0)->text();
         QString stadiumName = ui->stadiumTable->item(row, 1)->text();
@@ -162,7 +171,6 @@ void AdminPanel::saveStadiumChanges()
                 QString("Invalid capacity value for %1: %2\nPlease enter a valid number.")
                 .arg(teamName)
                 .arg(ui->stadiumTable->item(row, 2)->text()));
-            db->database().rollback();
             return;
         }
 
@@ -182,19 +190,25 @@ void AdminPanel::saveStadiumChanges()
             centerField = feetMatch.captured(1).toInt();
         }
 
-        if (!db->insertTeam(teamName, stadiumName, capacity, location, surface,
-                           league, dateOpened, centerField, typology, roof)) {
-            success = false;
-            break;
-        }
+        TeamRow teamRow;
+        teamRow.teamName = teamName;
+        teamRow.stadiumName = stadiumName;
+        teamRow.capacity = capacity;
+        teamRow.location = location;
+        teamRow.surface = surface;
+        teamRow.league = league;
+        teamRow.dateOpened = dateOpened;
+        teamRow.centerField = centerField;
+        teamRow.typology = typology;
+        teamRow.roof = roof;
+        rows.append(teamRow);
     }
 
-    if (success && db->database().commit()) {
+    // All rows go in as one group; the stadium map is updated immediately
+    if (db->insertTeams(rows)) {
         QMessageBox::information(this, "Success", "Changes saved successfully!");
-        db->reloadStadiumData(); // Use the new public method
         emit dataChanged(); // Emit signal when changes are saved successfully
     } else {
-        db->database().rollback();
         QMessageBox::critical(this, "Error", "Failed to save changes. Please try again.");
     }
 }
@@ -219,16 +233,10 @@ void AdminPanel::on_addSouvenirButton_clicked()
     if (!ok)
         return;
 
-    QSqlQuery query(db->database());
-    query.prepare("INSERT INTO souvenirs (team_name, item_name, price) VALUES (:team, :item, :price)");
-    query.bindValue(":team", teamName);
-    query.bindValue(":item", itemName);
-    query.bindValue(":price", price);
-
-    if (query.exec()) {
+    if (db->addSouvenir(teamName, itemName, price)) {
         loadSouvenirs(teamName);
     } else {
-        QMessageBox::critical(this, "Error", "Failed to add souvenir: " + query.lastError().text());
+        QMessageBox::critical(this, "Error", "Failed to add souvenir: " + itemName);
     }
 }
 
@@ -251,16 +259,10 @@ void AdminPanel::on_editSouvenirButton_clicked()
     if (!ok)
         return;
 
-    QSqlQuery query(db->database());
-    query.prepare("UPDATE souvenirs SET price = :price WHERE team_name = :team AND item_name = :item");
-    query.bindValue(":price", newPrice);
-    query.bindValue(":team", teamName);
-    query.bindValue(":item", currentItemName);
-
-    if (query.exec()) {
+    if (db->updateSouvenirPrice(teamName, currentItemName, newPrice)) {
         loadSouvenirs(teamName);
     } else {
-        QMessageBox::critical(this, "Error", "Failed to update souvenir: " + query.lastError().text());
+        QMessageBox::critical(this, "Error", "Failed to update souvenir: " + currentItemName);
     }
 }
 
@@ -281,15 +283,10 @@ void AdminPanel::on_deleteSouvenirButton_clicked()
         return;
     }
 
-    QSqlQuery query(db->database());
-    query.prepare("DELETE FROM souvenirs WHERE team_name = :team AND item_name = :item");
-    query.bindValue(":team", teamName);
-    query.bindValue(":item", itemName);
-
-    if (query.exec()) {
+    if (db->deleteSouvenir(teamName, itemName)) {
         loadSouvenirs(teamName);
     } else {
-        QMessageBox::critical(this, "Error", "Failed to delete souvenir: " + query.lastError().text());
+        QMessageBox::critical(this, "Error", "Failed to delete souvenir: " + itemName);
     }
 }
 
@@ -342,8 +339,57 @@ void AdminPanel::on_importDistancesButton_clicked() {
     }
 
     if (stadiumGraph->loadMultipleCSVs(filenames)) {
-        QMessageBox::information(this, "Import Successful", "Distances imported successfully.");
+        if (hotReloader) {
+            for (const QString &filename : filenames) {
+                hotReloader->watchDistanceFile(filename);
+            }
+        }
+        GraphValidationReport report = stadiumGraph->validate(db->stadiumNames());
+        if (report.isValid()) {
+            QMessageBox::information(this, "Import Successful", "Distances imported successfully.");
+        } else {
+            QMessageBox::warning(this, "Import Successful",
+                                 "Distances imported, but the graph has problems: " + report.summary());
+        }
     } else {
         QMessageBox::critical(this, "Import Error", "Failed to import distances from CSV(s).");
     }
-} 
\ No newline at end of file
+}
+
+void AdminPanel::bulkUpdatePrices()
+{
+    bool ok;
+    SouvenirPriceUpdate update;
+    update.itemName = QInputDialog::getText(this, "Bulk Price Update",
+                                            "Souvenir name (leave empty for all items):",
+                                            QLineEdit::Normal, "", &ok).trimmed();
+    if (!ok)
+        return;
+
+    QString league = QInputDialog::getItem(this, "Bulk Price Update", "League:",
+                                           {"All", "American", "National"}, 0, false, &ok);
+    if (!ok)
+        return;
+    if (league != "All")
+        update.league = league;
+
+    update.percentChange = QInputDialog::getDouble(this, "Bulk Price Update",
+                                                   "Price change (%):", 0.0, -100.0, 1000.0, 2, &ok);
+    if (!ok)
+        return;
+
+    BulkUpdateResult result = db->bulkUpdateSouvenirPrices(update);
+    if (!result.success) {
+        QMessageBox::critical(this, "Error", "Failed to update souvenir prices.");
+        return;
+    }
+
+    loadSouvenirs(ui->teamComboBox->currentText());
+    emit dataChanged();
+    QMessageBox::information(this, "Bulk Price Update",
+        QString("Updated %1 row(s) in %2 ms (in-memory: %3 entries in %4 ms).")
+            .arg(result.rowsAffected)
+            .arg(result.sqlMicros / 1000.0, 0, 'f', 2)
+            .arg(result.mapEntriesPatched)
+            .arg(result.mapMicros / 1000.0, 0, 'f', 2));
+}
@@ -7,6 +7,7 @@
 #include <QSqlError>
 #include "database.h"
 #include "stadiumgraph.h"
+#include "csvhotreloader.h"
 
 namespace Ui {
 class AdminPanel;
@@ -19,6 +20,7 @@ class AdminPanel : public QDialog
 public:
     explicit AdminPanel(Database* database, StadiumGraph* stadiumGraph, QWidget *parent = nullptr);
     ~AdminPanel();
+    void setHotReloader(CsvHotReloader* reloader) { hotReloader = reloader; }
 
 signals:
     void dataChanged();  // New signal to notify when data is changed
@@ -32,11 +34,13 @@ private slots:
     void on_closeButton_clicked();
     void saveStadiumChanges();
     void on_importDistancesButton_clicked();
+    void bulkUpdatePrices();
 
 private:
     Ui::AdminPanel *ui;
     Database *db;
     StadiumGraph* stadiumGraph;
+    CsvHotReloader* hotReloader = nullptr;
     void setupUi();
     void loadTeams();
     void loadSouvenirs(const QString &teamName);
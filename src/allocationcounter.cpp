@@ -0,0 +1,68 @@
+#include "allocationcounter.h"
+#include <cerrno>
+#include <cstddef>
+
+// Counts this thread's heap allocations by wrapping the glibc allocator
+// entry points, which Qt containers and operator new both go through.
+// Sanitizer builds bring their own allocator, so counting is off there.
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+}
+
+static thread_local qint64 threadAllocations = 0;
+
+extern "C" void* malloc(size_t size) {
+    ++threadAllocations;
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    ++threadAllocations;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* pointer, size_t size) {
+    if (!pointer) {
+        ++threadAllocations;
+    }
+    return __libc_realloc(pointer, size);
+}
+
+// The aligned allocators; over-aligned operator new goes through
+// aligned_alloc. glibc serves all three with its memalign.
+extern "C" void* memalign(size_t alignment, size_t size) {
+    ++threadAllocations;
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" void* aligned_alloc(size_t alignment, size_t size) {
+    ++threadAllocations;
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void** pointer, size_t alignment, size_t size) {
+    // Same checks as glibc: a power of two multiple of sizeof(void*)
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0 || alignment == 0) {
+        return EINVAL;
+    }
+    ++threadAllocations;
+    void* memory = __libc_memalign(alignment, size);
+    if (!memory) {
+        return ENOMEM;
+    }
+    *pointer = memory;
+    return 0;
+}
+
+qint64 threadAllocationCount() {
+    return threadAllocations;
+}
+#else
+qint64 threadAllocationCount() {
+    return -1;
+}
+#endif
@@ -0,0 +1,14 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+// Only built with CONFIG += count_allocations, which defines
+// COUNT_ALLOCATIONS. allocationcounter.cpp replaces the glibc malloc,
+// calloc, realloc and aligned allocation entry points for the whole
+// process, so the default build of the application never links it.
+
+// Heap allocations made by the calling thread so far
+qint64 threadAllocationCount();
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,127 @@
+#include "asynctasks.h"
+#include "database.h"
+#include <QPromise>
+#include <QMetaObject>
+#include <QtConcurrent/QtConcurrent>
+
+void CancellationToken::throwIfCancelled() const
+{
+    if (isCancelled()) {
+        throw OperationCancelled();
+    }
+}
+
+namespace {
+
+// Runs work in context's thread through its event queue. If context is
+// destroyed first, the dropped promise cancels the future.
+template<typename T, typename F>
+QFuture<T> runOnObjectThread(QObject* context, const CancellationToken& token, F work)
+{
+    auto promise = std::make_shared<QPromise<T>>();
+    QFuture<T> future = promise->future();
+    promise->start();
+    QMetaObject::invokeMethod(context, [promise, token, work]() {
+        try {
+            token.throwIfCancelled();
+            T result = work();
+            token.throwIfCancelled();
+            promise->addResult(std::move(result));
+        } catch (const QException& e) {
+            promise->setException(e);
+        } catch (...) {
+            promise->setException(std::current_exception());
+        }
+        promise->finish();
+    }, Qt::QueuedConnection);
+    return future;
+}
+
+template<typename F>
+auto runOnPool(const CancellationToken& token, F work)
+{
+    return QtConcurrent::run([token, work]() {
+        token.throwIfCancelled();
+        auto result = work();
+        token.throwIfCancelled();
+        return result;
+    });
+}
+
+RouteResult shortestRouteNow(const StadiumGraph& graph, const QString& from, const QString& to)
+{
+    RouteResult route;
+    route.distance = graph.dijkstra(from, to, route.path);
+    if (route.distance < 0) {
+        route.path.clear();
+    }
+    return route;
+}
+
+} // namespace
+
+namespace AsyncTasks {
+
+QFuture<StadiumInfo> loadTeam(Database* db, const QString& teamName, const CancellationToken& token)
+{
+    return runOnObjectThread<StadiumInfo>(db, token, [db, teamName]() {
+        return db->getStadiumInfo(teamName);
+    });
+}
+
+QFuture<QVector<QPair<QString, double>>> fetchSouvenirs(Database* db, const QString& teamName,
+                                                        const CancellationToken& token)
+{
+    // Pure SQL, so it reads through the pool thread's own connection
+    return runOnPool(token, [db, teamName]() {
+        return db->getSouvenirs(teamName);
+    });
+}
+
+QFuture<RouteResult> shortestRoute(StadiumGraph::Snapshot graph, const QString& from, const QString& to,
+                                   const CancellationToken& token)
+{
+    return runOnPool(token, [graph, from, to]() {
+        return shortestRouteNow(*graph, from, to);
+    });
+}
+
+QFuture<RouteResult> greedyRoute(StadiumGraph::Snapshot graph, const QString& start, const QVector<QString>& stops,
+                                 const CancellationToken& token)
+{
+    return runOnPool(token, [graph, start, stops]() {
+        RouteResult route;
+        route.distance = graph->greedyTrip(start, stops, route.path);
+        if (route.distance < 0) {
+            route.path.clear();
+        }
+        return route;
+    });
+}
+
+QFuture<TripQuote> quoteTrip(Database* db, StadiumGraph::Snapshot graph,
+                             const QString& fromTeam, const QString& toTeam,
+                             const CancellationToken& token)
+{
+    // Team lookups read the stadium map, so one hop to the database thread
+    // for all reads, then the rest on the pool
+    return runOnObjectThread<TripQuote>(db, token, [db, fromTeam, toTeam]() {
+        TripQuote quote;
+        quote.from = db->getStadiumInfo(fromTeam);
+        quote.to = db->getStadiumInfo(toTeam);
+        quote.souvenirs = db->getSouvenirs(toTeam);
+        return quote;
+    }).then(QtFuture::Launch::Async, [graph, token](TripQuote quote) {
+        token.throwIfCancelled();
+        quote.route = shortestRouteNow(*graph, quote.from.stadiumName, quote.to.stadiumName);
+        for (int i = 0; i < quote.souvenirs.size(); ++i) {
+            const double price = quote.souvenirs[i].second;
+            quote.allSouvenirs += price;
+            quote.cheapestSouvenir = i == 0 ? price : qMin(quote.cheapestSouvenir, price);
+        }
+        token.throwIfCancelled();
+        return quote;
+    });
+}
+
+} // namespace AsyncTasks
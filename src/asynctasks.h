@@ -0,0 +1,82 @@
+#ifndef ASYNCTASKS_H
+#define ASYNCTASKS_H
+
+#include <QString>
+#include <QVector>
+#include <QPair>
+#include <QFuture>
+#include <QException>
+#include <atomic>
+#include <memory>
+#include "stadiuminfo.h"
+#include "stadiumgraph.h"
+
+class Database;
+
+// Shared cancel flag for every step of one workflow. Copies refer to the
+// same flag, so the UI keeps one and hands copies to the tasks it starts.
+class CancellationToken {
+public:
+    CancellationToken() : state(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() const { state->store(true); }
+    bool isCancelled() const { return state->load(); }
+    // Throws OperationCancelled, which fails the future chain
+    void throwIfCancelled() const;
+
+private:
+    std::shared_ptr<std::atomic<bool>> state;
+};
+
+// Failure reported by a task whose token was cancelled; catch it with
+// QFuture::onFailed(context, [](const OperationCancelled&) { ... })
+class OperationCancelled : public QException {
+public:
+    void raise() const override { throw *this; }
+    OperationCancelled* clone() const override { return new OperationCancelled(*this); }
+};
+
+struct RouteResult {
+    QVector<QString> path;   // normalized stadium keys
+    double distance = -1.0;  // -1 when there is no path
+};
+
+struct TripQuote {
+    StadiumInfo from;
+    StadiumInfo to;
+    RouteResult route;
+    QVector<QPair<QString, double>> souvenirs;  // offered at the destination
+    double cheapestSouvenir = 0.0;
+    double allSouvenirs = 0.0;                   // one of each
+};
+
+// Asynchronous wrappers around the synchronous Database and StadiumGraph
+// calls, returned as QFutures so workflows compose with then() instead of
+// blocking a thread or nesting callbacks. UI code resumes on the event loop
+// with then(this, ...), which runs the continuation in the widget's thread.
+//
+// Steps that read the stadium map run on the Database object's thread;
+// pure SQL reads run on the global thread pool through that thread's pooled
+// connection, as do graph steps against an immutable snapshot. Every step checks its
+// token before and after the work and fails with OperationCancelled.
+namespace AsyncTasks {
+
+QFuture<StadiumInfo> loadTeam(Database* db, const QString& teamName,
+                              const CancellationToken& token = CancellationToken());
+QFuture<QVector<QPair<QString, double>>> fetchSouvenirs(Database* db, const QString& teamName,
+                                                        const CancellationToken& token = CancellationToken());
+
+QFuture<RouteResult> shortestRoute(StadiumGraph::Snapshot graph, const QString& from, const QString& to,
+                                   const CancellationToken& token = CancellationToken());
+QFuture<RouteResult> greedyRoute(StadiumGraph::Snapshot graph, const QString& start, const QVector<QString>& stops,
+                                 const CancellationToken& token = CancellationToken());
+
+// Load both teams and the destination's souvenirs, route between the two
+// stadiums and price the souvenirs
+QFuture<TripQuote> quoteTrip(Database* db, StadiumGraph::Snapshot graph,
+                             const QString& fromTeam, const QString& toTeam,
+                             const CancellationToken& token = CancellationToken());
+
+} // namespace AsyncTasks
+
+#endif // ASYNCTASKS_H
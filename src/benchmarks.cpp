@@ -0,0 +1,643 @@
+#include "benchmarks.h"
+#include "itinerarykernel.h"
+#include "stadiumregistry.h"
+#include "database.h"
+#include "teamsearchindex.h"
+#include "perfecthash.h"
+#include "densegraph.h"
+#include "compressedgraph.h"
+#include "graphorder.h"
+#ifdef COUNT_ALLOCATIONS
+#include "allocationcounter.h"
+#endif
+#include <QElapsedTimer>
+#include <QHash>
+#include <QRandomGenerator>
+#include <QThread>
+#include <QDebug>
+#include <algorithm>
+#ifdef Q_OS_LINUX
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Heap allocations made by this thread so far; -1 unless the build counts
+// them (CONFIG += count_allocations)
+qint64 allocationCount() {
+#ifdef COUNT_ALLOCATIONS
+    return threadAllocationCount();
+#else
+    return -1;
+#endif
+}
+
+// Hardware cache misses of this thread in user space, from a Linux perf
+// event; isValid() is false elsewhere or when perf events are restricted
+class CacheMissCounter {
+public:
+    CacheMissCounter() {
+#ifdef Q_OS_LINUX
+        perf_event_attr attr = {};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = int(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+    ~CacheMissCounter() {
+#ifdef Q_OS_LINUX
+        if (fd >= 0) {
+            close(fd);
+        }
+#endif
+    }
+
+    bool isValid() const { return fd >= 0; }
+
+    void start() {
+#ifdef Q_OS_LINUX
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // Misses since start(), or -1
+    qint64 stop() {
+        qint64 count = -1;
+#ifdef Q_OS_LINUX
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &count, sizeof(count)) != sizeof(count)) {
+                count = -1;
+            }
+        }
+#endif
+        return count;
+    }
+
+private:
+    int fd = -1;
+};
+
+// Node IDs in name order with sorted targets, the same rows freeze() builds
+void buildGraphRows(const StadiumGraph& graph, QVector<QString>& names, QVector<int>& rowStart,
+                    QVector<int>& targets, QVector<double>& weights) {
+    const QVector<NameKey> keys = graph.stadiumKeys();
+    QHash<NameKey, int> ids;
+    names.clear();
+    for (int i = 0; i < keys.size(); ++i) {
+        ids.insert(keys[i], i);
+        names.append(keys[i].toString());
+    }
+    rowStart.clear();
+    targets.clear();
+    weights.clear();
+    for (const NameKey& key : keys) {
+        rowStart.append(targets.size());
+        graph.forEachNeighbor(key, [&](const NameKey& neighbor, double distance) {
+            targets.append(ids.value(neighbor));
+            weights.append(distance);
+        });
+    }
+    rowStart.append(targets.size());
+}
+
+// Nanoseconds per call of query(i) for i in [0, count)
+template<typename Query>
+double timeQueries(int count, Query query) {
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < count; ++i) {
+        query(i);
+    }
+    return double(qMax<qint64>(timer.nsecsElapsed(), 1)) / count;
+}
+
+// Fills the matrix from the graph, or with a synthetic complete graph when
+// no distance data is loaded so the kernels still have something to chew on
+void buildBenchmarkMatrix(const StadiumGraph& graph, DistanceMatrix& matrix) {
+    HashMap<QString, StadiumInfo> noTeams;
+    StadiumRegistry registry;
+    registry.rebuild(noTeams, &graph);
+    if (registry.nodeCount() > 1) {
+        matrix.build(graph, registry);
+        return;
+    }
+    QRandomGenerator rng(7);
+    const int n = 30;
+    matrix.resize(n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = i + 1; j < n; ++j) {
+            float d = float(50 + rng.bounded(2950));
+            matrix.set(i, j, d);
+            matrix.set(j, i, d);
+        }
+    }
+}
+
+} // namespace
+
+double benchmarkItineraryKernel(const StadiumGraph& graph, int itineraryCount,
+                                int stopsPerItinerary, int threadCount) {
+    DistanceMatrix matrix;
+    buildBenchmarkMatrix(graph, matrix);
+    const int n = matrix.size();
+
+    QRandomGenerator rng(42);
+    QVector<qint32> spend(n);
+    for (int i = 0; i < n; ++i) {
+        spend[i] = qint32(rng.bounded(50000));
+    }
+
+    QVector<quint16> stops(itineraryCount * stopsPerItinerary);
+    QVector<quint32> offsets(itineraryCount + 1);
+    for (int i = 0; i < stops.size(); ++i) {
+        stops[i] = quint16(rng.bounded(n));
+    }
+    for (int k = 0; k <= itineraryCount; ++k) {
+        offsets[k] = quint32(k * stopsPerItinerary);
+    }
+
+    ItineraryBatch batch;
+    batch.stops = stops.constData();
+    batch.offsets = offsets.constData();
+    batch.count = itineraryCount;
+
+    ItineraryKernel kernel(matrix, spend);
+    ItineraryResults results;
+    if (!kernel.evaluate(batch, results, threadCount)) {  // warm-up
+        return 0.0;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    kernel.evaluate(batch, results, threadCount);
+    qint64 nanos = qMax<qint64>(timer.nsecsElapsed(), 1);
+    return double(itineraryCount) * 1e9 / double(nanos);
+}
+
+void reportStadiumMemory() {
+    Database db;
+    if (!db.initialize()) {
+        return;
+    }
+    db.importFromCSV(QStringList() << "MLB Information.csv" << "MLB Information Expansion.csv");
+    StadiumMemoryStats stats = db.stadiumMemoryStats();
+    qDebug() << "=== Stadium map memory ===";
+    qDebug() << stats.teams << "teams:"
+             << qRound(stats.plainBytesPerTeam()) << "bytes/team plain,"
+             << qRound(stats.encodedBytesPerTeam()) << "bytes/team dictionary encoded"
+             << "(" << stats.dictionaryBytes << "bytes of shared dictionaries)";
+}
+
+double benchmarkTeamSearch(int teamCount, int queryCount) {
+    // Synthetic catalog: names built from a small vocabulary, like real team names
+    const QStringList cities = {"Boston", "New York", "Los Angeles", "Chicago", "Houston", "Seattle",
+                                "Miami", "Denver", "Atlanta", "Detroit", "Phoenix", "Oakland"};
+    const QStringList mascots = {"Red Sox", "Yankees", "Dodgers", "Cubs", "Astros", "Mariners",
+                                 "Marlins", "Rockies", "Braves", "Tigers", "Diamondbacks", "Athletics"};
+    QRandomGenerator rng(11);
+    HashMap<QString, StadiumInfo> teams;
+    for (int i = 0; i < teamCount; ++i) {
+        StadiumInfo info;
+        const QString city = cities[rng.bounded(cities.size())];
+        info.teamName = QString("%1 %2 %3").arg(city, mascots[rng.bounded(mascots.size())]).arg(i);
+        info.stadiumName = QString("%1 Park %2").arg(mascots[rng.bounded(mascots.size())]).arg(i);
+        info.setLocation(city);
+        teams.insert(info.teamName, info);
+    }
+    StadiumRegistry registry;
+    registry.rebuild(teams, nullptr);
+    TeamSearchIndex index;
+    index.rebuild(registry, teams);
+
+    const QStringList queries = {"bos", "new yor", "dodgrs", "chicago cub", "astro", "seatle mar",
+                                 "park 12", "detriot", "phoenix dia", "oak"};
+    QElapsedTimer timer;
+    timer.start();
+    int hits = 0;
+    for (int q = 0; q < queryCount; ++q) {
+        hits += index.search(queries[q % queries.size()], 10).size();
+    }
+    qint64 nanos = qMax<qint64>(timer.nsecsElapsed(), 1);
+    Q_UNUSED(hits);
+    return double(nanos) / 1000.0 / queryCount;
+}
+
+void benchmarkNameLookup(int keyCount, int lookupCount) {
+    HashMap<QString, StadiumInfo> map;
+    HashMap<NameKey, StadiumInfo> keyedMap;
+    QVector<QString> keys;
+    for (int i = 0; i < keyCount; ++i) {
+        StadiumInfo info;
+        info.teamName = QString("Team %1 Baseball Club").arg(i);
+        keys.append(info.teamName.toLower());
+        map.insert(keys.last(), info);
+        keyedMap.insert(NameKey(keys.last()), info);
+    }
+    // Every fourth probe misses, like typos from the search box
+    QRandomGenerator rng(17);
+    QVector<QString> probes;
+    QVector<NameKey> keyedProbes;
+    for (int i = 0; i < 4096; ++i) {
+        probes.append(i % 4 == 3 ? QString("team %1 baseball clu").arg(i)
+                                 : keys[rng.bounded(keyCount)]);
+        keyedProbes.append(NameKey(probes.last()));
+    }
+
+    auto timeLookups = [lookupCount](auto lookup) {
+        QElapsedTimer timer;
+        timer.start();
+        int hits = 0;
+        for (int i = 0; i < lookupCount; ++i) {
+            hits += lookup(i & 4095) ? 1 : 0;
+        }
+        Q_UNUSED(hits);
+        return double(qMax<qint64>(timer.nsecsElapsed(), 1)) / lookupCount;
+    };
+
+    double chained = timeLookups([&](int i) { return map.find(probes[i]) != nullptr; });
+    double keyedChained = timeLookups([&](int i) { return keyedMap.find(keyedProbes[i]) != nullptr; });
+    map.freeze();
+    keyedMap.freeze();
+    double frozen = timeLookups([&](int i) { return map.find(probes[i]) != nullptr; });
+    double keyedFrozen = timeLookups([&](int i) { return keyedMap.find(keyedProbes[i]) != nullptr; });
+
+    QElapsedTimer buildTimer;
+    buildTimer.start();
+    MinimalPerfectHash mph;
+    mph.build(keys);
+    double buildMs = buildTimer.nsecsElapsed() / 1e6;
+    double bare = timeLookups([&](int i) { return mph.find(probes[i]) >= 0; });
+
+    qDebug() << keyCount << "keys:" << chained << "ns/op chained," << frozen << "ns/op frozen,"
+             << bare << "ns/op bare MPH (build" << buildMs << "ms,"
+             << double(mph.memoryBytes()) / qMax(keyCount, 1) << "bytes/key)";
+    qDebug() << keyCount << "NameKey keys:" << keyedChained << "ns/op chained,"
+             << keyedFrozen << "ns/op frozen";
+}
+
+void benchmarkGraphValidation(int nodeCount, int degree) {
+    // Ring lattice: node i links to the next degree / 2 nodes, so every row
+    // is sorted and every edge has its reverse; then a few faults are planted
+    QVector<QVector<QPair<int, double>>> rows(nodeCount);
+    const int half = qMax(1, degree / 2);
+    for (int i = 0; i < nodeCount; ++i) {
+        for (int k = 1; k <= half; ++k) {
+            const int j = (i + k) % nodeCount;
+            const double miles = 100.0 + (i * 31 + j * 17) % 900;
+            rows[i].append(qMakePair(j, miles));
+            rows[j].append(qMakePair(i, miles));
+        }
+    }
+    rows[0][0].second += 1.0;      // asymmetric
+    rows[1].removeLast();          // missing reverse
+    rows[2].append(qMakePair(2, 5.0));  // self loop
+    rows[nodeCount - 1].clear();   // no edges out, but still reached
+    QVector<int> rowStart;
+    QVector<int> targets;
+    QVector<double> weights;
+    rowStart.reserve(nodeCount + 1);
+    for (QVector<QPair<int, double>>& row : rows) {
+        std::sort(row.begin(), row.end());
+        rowStart.append(targets.size());
+        for (const auto& edge : row) {
+            targets.append(edge.first);
+            weights.append(edge.second);
+        }
+    }
+    rowStart.append(targets.size());
+
+    GraphValidationReport report = GraphValidator::validate(rowStart, targets, weights,
+        [](int node) { return QString("stadium%1").arg(node); });
+    qDebug() << nodeCount << "nodes," << targets.size() << "edges:" << report.micros / 1000.0 << "ms,"
+             << double(report.micros) * 1000.0 / qMax(1, int(targets.size())) << "ns/edge -" << report.summary();
+}
+
+void benchmarkDenseGraph(int nodeCount, int queryCount) {
+    StadiumGraph graph;
+    for (int i = 0; i < nodeCount; ++i) {
+        for (int j = i + 1; j < nodeCount; ++j) {
+            graph.addEdge(QString("Stadium %1").arg(i), QString("Stadium %1").arg(j),
+                          100.0 + (i * 31 + j * 17) % 900);
+        }
+    }
+    QVector<QString> names;
+    QVector<int> rowStart;
+    QVector<int> targets;
+    QVector<double> weights;
+    buildGraphRows(graph, names, rowStart, targets, weights);
+    DenseAdjacency dense;
+    dense.build(rowStart, targets, weights);
+    const CsrAdjacency rows(rowStart, targets, weights);
+
+    const int n = names.size();
+    const int mapQueries = qMax(1, queryCount / 100);
+    QVector<QString> path;
+    QVector<QPair<QString, QString>> mst;
+    QVector<int> nodes;
+    QVector<QPair<int, int>> edges;
+    double mapDijkstra = timeQueries(mapQueries, [&](int i) {
+        graph.dijkstra(names[i % n], names[(i * 7 + 1) % n], path);
+    });
+    double mapPrim = timeQueries(qMax(1, mapQueries / 10), [&](int) { graph.minimumSpanningTree(mst); });
+    auto kernelTimes = [&](const auto& adjacency) {
+        return GraphKernels::dispatchSize(n, [&](auto maxNodes) {
+            const int size = decltype(maxNodes)::value;
+            double dijkstra = timeQueries(queryCount, [&](int i) {
+                GraphKernels::shortestPath<size>(adjacency, i % n, (i * 7 + 1) % n, nodes);
+            });
+            double prim = timeQueries(qMax(1, queryCount / 10), [&](int) {
+                GraphKernels::spanningTree<size>(adjacency, edges);
+            });
+            return qMakePair(dijkstra, prim);
+        });
+    };
+    const QPair<double, double> csr = kernelTimes(rows);
+    const QPair<double, double> flat = kernelTimes(dense);
+    qDebug() << n << "nodes: Dijkstra" << mapDijkstra << "ns map," << csr.first << "ns CSR,"
+             << flat.first << "ns dense; Prim" << mapPrim << "ns map," << csr.second << "ns CSR,"
+             << flat.second << "ns dense";
+}
+
+void benchmarkKernelSizes(const StadiumGraph& graph, int queryCount) {
+    QVector<QString> names;
+    QVector<int> rowStart;
+    QVector<int> targets;
+    QVector<double> weights;
+    buildGraphRows(graph, names, rowStart, targets, weights);
+    const int n = names.size();
+    if (n == 0) {
+        qDebug() << "No distance data loaded";
+        return;
+    }
+    DenseAdjacency dense;
+    dense.build(rowStart, targets, weights);
+
+    // Output vectors are reused, as a caller running many queries would
+    QVector<int> nodes;
+    QVector<QPair<int, int>> edges;
+    QVector<int> stops;
+    for (int i = 1; i < n; i += 3) {
+        stops.append(i);
+    }
+    nodes.reserve(n);
+    edges.reserve(n);
+    auto run = [&](auto maxNodes) {
+        const int size = decltype(maxNodes)::value;
+        if (size != GraphKernels::Dynamic && n > size) {
+            return;
+        }
+        const qint64 before = allocationCount();
+        double dijkstra = timeQueries(queryCount, [&](int i) {
+            GraphKernels::shortestPath<size>(dense, i % n, (i * 7 + 1) % n, nodes);
+        });
+        double prim = timeQueries(queryCount, [&](int) { GraphKernels::spanningTree<size>(dense, edges); });
+        double tour = timeQueries(queryCount, [&](int i) {
+            GraphKernels::nearestNeighbourTour<size>(dense, i % n, stops, nodes);
+        });
+        const qint64 allocations = allocationCount() - before;
+        const QString label = size == GraphKernels::Dynamic ? QString("dynamic") : QString::number(size);
+        qDebug() << n << "nodes, max" << label << ": Dijkstra" << dijkstra << "ns, Prim" << prim
+                 << "ns, nearest neighbour" << tour << "ns,"
+                 << (before < 0 ? QString("allocations not counted in this build")
+                                : QString("%1 heap allocations/query").arg(double(allocations) / (3 * queryCount)));
+    };
+    run(std::integral_constant<int, 32>());
+    run(std::integral_constant<int, 64>());
+    run(std::integral_constant<int, 128>());
+    run(std::integral_constant<int, GraphKernels::Dynamic>());
+
+    // The public API on a published snapshot, names in and out
+    StadiumGraph frozen = graph;
+    frozen.publish();
+    const StadiumGraph::Snapshot snapshot = frozen.snapshot();
+    QVector<QString> path;
+    path.reserve(n);
+    const qint64 before = allocationCount();
+    double byName = timeQueries(queryCount / 10, [&](int i) {
+        snapshot->dijkstra(names[i % n], names[(i * 7 + 1) % n], path);
+    });
+    const qint64 allocations = allocationCount() - before;
+    qDebug() << "StadiumGraph::dijkstra on a snapshot:" << byName << "ns,"
+             << (before < 0 ? QString("allocations not counted in this build")
+                            : QString("%1 heap allocations/query").arg(double(allocations) / (queryCount / 10)));
+}
+
+void benchmarkCompressedGraph(int nodeCount, int degree, int queryCount) {
+    // Road-like rows: the degree - 2 nearest IDs on a ring plus two random
+    // long links, or every other node when degree >= nodeCount
+    QRandomGenerator rng(29);
+    QVector<QVector<QPair<int, double>>> adjacency(nodeCount);
+    auto link = [&](int a, int b) {
+        const double miles = 5.0 + ((a * 131 + b * 71) % 30000) / 10.0;
+        adjacency[a].append(qMakePair(b, miles));
+        adjacency[b].append(qMakePair(a, miles));
+    };
+    if (degree >= nodeCount - 1) {
+        for (int a = 0; a < nodeCount; ++a) {
+            for (int b = a + 1; b < nodeCount; ++b) {
+                link(a, b);
+            }
+        }
+    } else {
+        for (int a = 0; a < nodeCount; ++a) {
+            for (int k = 1; k <= (degree - 2) / 2; ++k) {
+                link(a, (a + k) % nodeCount);
+            }
+            link(a, rng.bounded(nodeCount));
+        }
+    }
+    QVector<int> rowStart;
+    QVector<int> targets;
+    QVector<double> weights;
+    rowStart.reserve(nodeCount + 1);
+    for (int a = 0; a < nodeCount; ++a) {
+        QVector<QPair<int, double>>& row = adjacency[a];
+        std::sort(row.begin(), row.end());
+        rowStart.append(targets.size());
+        for (int i = 0; i < row.size(); ++i) {
+            if (row[i].first != a && (i == 0 || row[i].first != row[i - 1].first)) {
+                targets.append(row[i].first);
+                weights.append(row[i].second);
+            }
+        }
+        row.clear();
+        row.squeeze();
+    }
+    rowStart.append(targets.size());
+
+    CompressedGraph compressed;
+    QElapsedTimer buildTimer;
+    buildTimer.start();
+    compressed.build(rowStart, targets, weights);
+    const double buildMs = buildTimer.nsecsElapsed() / 1e6;
+    const CsrAdjacency rows(rowStart, targets, weights);
+
+    const double edges = qMax(1, int(targets.size()));
+    const double csrBytes = (targets.size() * (sizeof(int) + sizeof(double)) + rowStart.size() * sizeof(int)) / edges;
+    // One QMap (std::map) node per edge: three links and a colour word, the
+    // NameKey and the double, plus the allocator's header
+    const double mapBytes = 4 * sizeof(void*) + sizeof(NameKey) + sizeof(double) + 16;
+
+    QVector<int> path;
+    auto pair = [nodeCount](int i) { return qMakePair(int((i * 7919LL) % nodeCount), int((i * 104729LL + nodeCount / 2) % nodeCount)); };
+    double csrMicros = timeQueries(queryCount, [&](int i) {
+        GraphKernels::shortestPathSparse(rows, pair(i).first, pair(i).second, path);
+    }) / 1000.0;
+    double compressedMicros = timeQueries(queryCount, [&](int i) {
+        GraphKernels::shortestPathSparse(compressed, pair(i).first, pair(i).second, path);
+    }) / 1000.0;
+    qDebug() << nodeCount << "nodes," << compressed.edgeCount() << "edges:" << compressed.bytesPerEdge()
+             << "bytes/edge compressed (built in" << buildMs << "ms)," << csrBytes << "CSR, ~" << mapBytes
+             << "map; Dijkstra" << compressedMicros << "us compressed vs" << csrMicros << "us CSR ("
+             << compressedMicros / qMax(csrMicros, 1e-3) << "x)";
+}
+
+void benchmarkNodeOrder(int width, int queryCount) {
+    // width x width grid with diagonals, numbered in random order the way
+    // name order scatters neighbouring venues
+    const int n = width * width;
+    QVector<int> scrambled(n);
+    for (int i = 0; i < n; ++i) {
+        scrambled[i] = i;
+    }
+    QRandomGenerator rng(41);
+    for (int i = n - 1; i > 0; --i) {
+        std::swap(scrambled[i], scrambled[rng.bounded(i + 1)]);
+    }
+    QVector<QVector<QPair<int, double>>> adjacency(n);
+    for (int y = 0; y < width; ++y) {
+        for (int x = 0; x < width; ++x) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    const int nx = x + dx;
+                    const int ny = y + dy;
+                    if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= width || ny >= width) {
+                        continue;
+                    }
+                    adjacency[scrambled[y * width + x]].append(
+                        qMakePair(scrambled[ny * width + nx], dx != 0 && dy != 0 ? 14.1 : 10.0));
+                }
+            }
+        }
+    }
+    QVector<int> baseStart;
+    QVector<int> baseTargets;
+    QVector<double> baseWeights;
+    for (QVector<QPair<int, double>>& row : adjacency) {
+        std::sort(row.begin(), row.end());
+        baseStart.append(baseTargets.size());
+        for (const auto& edge : row) {
+            baseTargets.append(edge.first);
+            baseWeights.append(edge.second);
+        }
+    }
+    baseStart.append(baseTargets.size());
+    adjacency.clear();
+
+    CacheMissCounter misses;
+    const struct {
+        NodeOrder first;
+        const char* second;
+    } orders[] = {
+        {NodeOrder::KeyOrder, "key order"},
+        {NodeOrder::BreadthFirst, "BFS"},
+        {NodeOrder::ReverseCuthillMcKee, "RCM"},
+    };
+    for (const auto& order : orders) {
+        QVector<int> rowStart = baseStart;
+        QVector<int> targets = baseTargets;
+        QVector<double> weights = baseWeights;
+        QElapsedTimer orderTimer;
+        orderTimer.start();
+        const QVector<int> permutation = GraphOrder::compute(order.first, rowStart, targets);
+        GraphOrder::permuteRows(permutation, rowStart, targets, weights);
+        const double orderMs = orderTimer.nsecsElapsed() / 1e6;
+        QVector<int> newId(n);
+        for (int i = 0; i < n; ++i) {
+            newId[permutation[i]] = i;
+        }
+
+        // The same venue pairs under every order
+        const CsrAdjacency rows(rowStart, targets, weights);
+        QVector<int> path;
+        misses.start();
+        double millis = timeQueries(queryCount, [&](int i) {
+            const int from = newId[int((i * 7919LL) % n)];
+            const int to = newId[int((i * 104729LL + n / 2) % n)];
+            GraphKernels::shortestPathSparse(rows, from, to, path);
+        }) / 1e6;
+        const qint64 missCount = misses.stop();
+
+        CompressedGraph compressed;
+        compressed.build(rowStart, targets, weights);
+        qDebug() << n << "nodes," << order.second << ": reordered in" << orderMs << "ms, mean edge span"
+                 << GraphOrder::meanEdgeSpan(rowStart, targets) << ", Dijkstra" << millis << "ms,"
+                 << (missCount < 0 ? QString("cache misses unavailable")
+                                   : QString("%1 cache misses/query").arg(missCount / queryCount))
+                 << "," << compressed.bytesPerEdge() << "compressed bytes/edge";
+    }
+}
+
+int runBenchmarks(const StadiumGraph& graph) {
+    qDebug() << "=== Itinerary kernel ===";
+    qDebug() << "AVX2 gathers:" << (ItineraryKernel::hasSimdSupport() ? "yes" : "no");
+    const int itineraries = 1000000;
+    for (int stopsPerItinerary : {5, 10, 30}) {
+        double single = benchmarkItineraryKernel(graph, itineraries, stopsPerItinerary, 1);
+        double parallel = benchmarkItineraryKernel(graph, itineraries, stopsPerItinerary, 0);
+        qDebug() << stopsPerItinerary << "stops:"
+                 << qRound64(single) << "itineraries/s (1 thread),"
+                 << qRound64(parallel) << "itineraries/s (" << QThread::idealThreadCount() << "threads)";
+    }
+    reportStadiumMemory();
+
+    qDebug() << "=== Team search ===";
+    for (int teams : {1000, 20000}) {
+        qDebug() << teams << "teams:" << benchmarkTeamSearch(teams, 200) << "us/query";
+    }
+
+    qDebug() << "=== Name lookup ===";
+    for (int keys : {30, 1000, 20000}) {
+        benchmarkNameLookup(keys, 1000000);
+    }
+
+    qDebug() << "=== Graph validation ===";
+    Database db;
+    if (db.initialize()) {
+        qDebug() << "Default graph:" << graph.validate(db.stadiumNames()).summary();
+    }
+    for (int nodes : {25000, 100000}) {
+        benchmarkGraphValidation(nodes, 10);
+    }
+
+    qDebug() << "=== Dense graph kernels ===";
+    qDebug() << "AVX2 row scans:" << (DenseAdjacency::hasSimdSupport() ? "yes" : "no");
+    for (int nodes : {31, 64, 128}) {
+        benchmarkDenseGraph(nodes, 100000);
+    }
+
+    qDebug() << "=== Fixed-size kernels ===";
+    benchmarkKernelSizes(graph, 100000);
+
+    qDebug() << "=== Compressed adjacency ===";
+    qDebug() << "SIMD decode:" << (CompressedGraph::hasSimdSupport() ? "yes" : "no");
+    benchmarkCompressedGraph(50000, 12, 50);
+    benchmarkCompressedGraph(2000, 2000, 20);
+
+    qDebug() << "=== Node order ===";
+    for (int width : {200, 500}) {
+        benchmarkNodeOrder(width, 20);
+    }
+    return 0;
+}
@@ -0,0 +1,49 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include "stadiumgraph.h"
+
+// Offline performance benchmarks. Started with the --benchmark command line
+// switch; results are written to the debug log.
+int runBenchmarks(const StadiumGraph& graph);
+
+// Returns itineraries evaluated per second
+double benchmarkItineraryKernel(const StadiumGraph& graph, int itineraryCount,
+                                int stopsPerItinerary, int threadCount);
+
+// Returns microseconds per ranked fuzzy search over a synthetic catalog
+double benchmarkTeamSearch(int teamCount, int queryCount);
+
+// Logs ns per name lookup: chained HashMap vs frozen minimal perfect hash,
+// for QString and NameKey keys
+void benchmarkNameLookup(int keyCount, int lookupCount);
+
+// Logs the time of one GraphValidator pass over a synthetic ring lattice of
+// nodeCount * degree directed edges with a few planted faults
+void benchmarkGraphValidation(int nodeCount, int degree);
+
+// Logs ns per Dijkstra and Prim query on a synthetic complete graph of
+// nodeCount stadiums: the thawed map-based StadiumGraph, then the
+// GraphKernels over CSR rows and over the dense matrix
+void benchmarkDenseGraph(int nodeCount, int queryCount);
+
+// Logs ns and heap allocations per Dijkstra, Prim and nearest-neighbour
+// query on the graph's dense matrix for each GraphKernels size that holds
+// it, then for StadiumGraph::dijkstra on a published snapshot
+void benchmarkKernelSizes(const StadiumGraph& graph, int queryCount);
+
+// Logs bytes per edge of CompressedGraph vs CSR rows and the map, and the
+// heap Dijkstra time over each, on a synthetic road-like graph (degree
+// edges per node) or an all-pairs table when degree >= nodeCount
+void benchmarkCompressedGraph(int nodeCount, int degree, int queryCount);
+
+// Logs, for key order, BFS and RCM numbering of a width x width grid whose
+// IDs start out shuffled: reordering time, mean edge span, heap Dijkstra
+// time and hardware cache misses per query (Linux perf events, when
+// permitted) and compressed bytes per edge
+void benchmarkNodeOrder(int width, int queryCount);
+
+// Logs estimated stadium map bytes per team, plain vs dictionary encoded
+void reportStadiumMemory();
+
+#endif // BENCHMARKS_H
@@ -0,0 +1,365 @@
+#include "changejournal.h"
+#include <QDataStream>
+#include <QRandomGenerator>
+#include <QDebug>
+
+namespace {
+
+const quint32 JournalMagic = 0x42424A31;  // "BBJ1"
+const quint16 JournalVersion = 1;
+const qint64 HeaderBytes = 16;
+// Anything larger is garbage, not a record
+const quint32 MaxRecordBytes = 1 << 20;
+
+void prepareStream(QDataStream &stream)
+{
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream.setByteOrder(QDataStream::BigEndian);
+}
+
+} // namespace
+
+ChangeJournal::~ChangeJournal()
+{
+    close();
+}
+
+quint32 ChangeJournal::crc32(const QByteArray &data)
+{
+    static const QVector<quint32> table = [] {
+        QVector<quint32> t(256);
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    quint32 crc = 0xFFFFFFFFu;
+    for (char byte : data) {
+        crc = table[(crc ^ static_cast<quint8>(byte)) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+bool ChangeJournal::open(const QString &path)
+{
+    close();
+
+    quint64 existingId = 0;
+    QVector<JournalRecord> records;
+    qint64 validBytes = 0;
+    bool truncated = false;
+    bool resume = QFile::exists(path) && QFile(path).size() > 0;
+    if (resume && !readFile(path, existingId, records, &truncated, &validBytes)) {
+        qDebug() << "Not a change journal, refusing to append:" << path;
+        return false;
+    }
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadWrite)) {
+        qDebug() << "Error opening change journal:" << file.errorString();
+        return false;
+    }
+
+    if (resume) {
+        if (truncated) {
+            qDebug() << "Dropping torn tail of change journal at byte" << validBytes;
+            file.resize(validBytes);
+        }
+        id = existingId;
+        sequence = records.isEmpty() ? 0 : records.last().sequence;
+        file.seek(validBytes);
+    } else {
+        id = QRandomGenerator::global()->generate64();
+        sequence = 0;
+        QByteArray header;
+        QDataStream out(&header, QIODevice::WriteOnly);
+        prepareStream(out);
+        out << JournalMagic << JournalVersion << quint16(0) << id;
+        if (file.write(header) != header.size() || !file.flush()) {
+            qDebug() << "Error writing change journal header:" << file.errorString();
+            file.close();
+            return false;
+        }
+    }
+    qDebug() << "Change journal" << path << "at sequence" << sequence;
+    return true;
+}
+
+void ChangeJournal::close()
+{
+    if (file.isOpen()) {
+        flush();
+        file.close();
+    }
+}
+
+bool ChangeJournal::flush()
+{
+    if (pending.isEmpty()) {
+        return true;
+    }
+    // One write and one flush for the whole group of records
+    bool ok = file.write(pending) == pending.size() && file.flush();
+    if (!ok) {
+        qDebug() << "Error writing change journal:" << file.errorString();
+    }
+    pending.clear();
+    pendingRecords = 0;
+    return ok;
+}
+
+void ChangeJournal::append(JournalRecord record)
+{
+    if (!file.isOpen()) {
+        return;
+    }
+    record.sequence = ++sequence;
+    const QByteArray body = encode(record);
+
+    QDataStream out(&pending, QIODevice::WriteOnly | QIODevice::Append);
+    prepareStream(out);
+    out << quint32(body.size());
+    out.writeRawData(body.constData(), body.size());
+    out << crc32(body);
+
+    if (++pendingRecords >= groupSize) {
+        flush();
+    }
+}
+
+void ChangeJournal::teamUpserted(const TeamRow &row, bool withDefaultSouvenirs)
+{
+    JournalRecord record;
+    record.type = JournalRecord::TeamUpsert;
+    record.team = row;
+    record.withDefaultSouvenirs = withDefaultSouvenirs;
+    append(record);
+}
+
+void ChangeJournal::teamDeleted(const QString &teamName)
+{
+    JournalRecord record;
+    record.type = JournalRecord::TeamDelete;
+    record.teamName = teamName;
+    append(record);
+}
+
+void ChangeJournal::souvenirAdded(const QString &teamName, const QString &itemName, double price)
+{
+    JournalRecord record;
+    record.type = JournalRecord::SouvenirAdd;
+    record.teamName = teamName;
+    record.itemName = itemName;
+    record.value = price;
+    append(record);
+}
+
+void ChangeJournal::souvenirUpdated(const QString &teamName, const QString &itemName, double price)
+{
+    JournalRecord record;
+    record.type = JournalRecord::SouvenirUpdate;
+    record.teamName = teamName;
+    record.itemName = itemName;
+    record.value = price;
+    append(record);
+}
+
+void ChangeJournal::souvenirDeleted(const QString &teamName, const QString &itemName)
+{
+    JournalRecord record;
+    record.type = JournalRecord::SouvenirDelete;
+    record.teamName = teamName;
+    record.itemName = itemName;
+    append(record);
+}
+
+void ChangeJournal::souvenirPricesUpdated(const SouvenirPriceUpdate &update)
+{
+    JournalRecord record;
+    record.type = JournalRecord::SouvenirBulkUpdate;
+    record.priceUpdate = update;
+    append(record);
+}
+
+void ChangeJournal::edgeSet(const QString &from, const QString &to, double distance)
+{
+    JournalRecord record;
+    record.type = JournalRecord::EdgeSet;
+    record.from = from;
+    record.to = to;
+    record.value = distance;
+    append(record);
+}
+
+void ChangeJournal::edgeRemoved(const QString &from, const QString &to)
+{
+    JournalRecord record;
+    record.type = JournalRecord::EdgeRemove;
+    record.from = from;
+    record.to = to;
+    append(record);
+}
+
+void ChangeJournal::graphCleared()
+{
+    JournalRecord record;
+    record.type = JournalRecord::GraphClear;
+    append(record);
+}
+
+QByteArray ChangeJournal::encode(const JournalRecord &record)
+{
+    QByteArray body;
+    QDataStream out(&body, QIODevice::WriteOnly);
+    prepareStream(out);
+    out << record.sequence << quint8(record.type);
+    switch (record.type) {
+    case JournalRecord::TeamUpsert: {
+        const TeamRow &row = record.team;
+        out << row.teamName << row.stadiumName << qint32(row.capacity) << row.location
+            << row.surface << row.league << row.dateOpened << qint32(row.centerField)
+            << row.typology << row.roof << record.withDefaultSouvenirs;
+        break;
+    }
+    case JournalRecord::TeamDelete:
+        out << record.teamName;
+        break;
+    case JournalRecord::SouvenirAdd:
+    case JournalRecord::SouvenirUpdate:
+        out << record.teamName << record.itemName << record.value;
+        break;
+    case JournalRecord::SouvenirDelete:
+        out << record.teamName << record.itemName;
+        break;
+    case JournalRecord::SouvenirBulkUpdate: {
+        const SouvenirPriceUpdate &update = record.priceUpdate;
+        out << update.itemName << update.league << update.teams
+            << update.percentChange << update.amountChange;
+        break;
+    }
+    case JournalRecord::EdgeSet:
+        out << record.from << record.to << record.value;
+        break;
+    case JournalRecord::EdgeRemove:
+        out << record.from << record.to;
+        break;
+    case JournalRecord::GraphClear:
+        break;
+    }
+    return body;
+}
+
+bool ChangeJournal::decode(const QByteArray &body, JournalRecord &record)
+{
+    QDataStream in(body);
+    prepareStream(in);
+    quint8 type = 0;
+    in >> record.sequence >> type;
+    record.type = static_cast<JournalRecord::Type>(type);
+    switch (record.type) {
+    case JournalRecord::TeamUpsert: {
+        TeamRow &row = record.team;
+        qint32 capacity = 0;
+        qint32 centerField = 0;
+        in >> row.teamName >> row.stadiumName >> capacity >> row.location
+           >> row.surface >> row.league >> row.dateOpened >> centerField
+           >> row.typology >> row.roof >> record.withDefaultSouvenirs;
+        row.capacity = capacity;
+        row.centerField = centerField;
+        break;
+    }
+    case JournalRecord::TeamDelete:
+        in >> record.teamName;
+        break;
+    case JournalRecord::SouvenirAdd:
+    case JournalRecord::SouvenirUpdate:
+        in >> record.teamName >> record.itemName >> record.value;
+        break;
+    case JournalRecord::SouvenirDelete:
+        in >> record.teamName >> record.itemName;
+        break;
+    case JournalRecord::SouvenirBulkUpdate: {
+        SouvenirPriceUpdate &update = record.priceUpdate;
+        in >> update.itemName >> update.league >> update.teams
+           >> update.percentChange >> update.amountChange;
+        break;
+    }
+    case JournalRecord::EdgeSet:
+        in >> record.from >> record.to >> record.value;
+        break;
+    case JournalRecord::EdgeRemove:
+        in >> record.from >> record.to;
+        break;
+    case JournalRecord::GraphClear:
+        break;
+    default:
+        return false;
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+bool ChangeJournal::readFile(const QString &path, quint64 &journalId, QVector<JournalRecord> &records,
+                             bool *truncated, qint64 *validBytes)
+{
+    QFile in(path);
+    if (!in.open(QIODevice::ReadOnly)) {
+        qDebug() << "Error opening change journal:" << in.errorString();
+        return false;
+    }
+    const QByteArray data = in.readAll();
+    in.close();
+
+    QDataStream stream(data);
+    prepareStream(stream);
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint16 reserved = 0;
+    stream >> magic >> version >> reserved >> journalId;
+    if (stream.status() != QDataStream::Ok || magic != JournalMagic || version != JournalVersion) {
+        qDebug() << "Bad change journal header:" << path;
+        return false;
+    }
+
+    qint64 offset = HeaderBytes;
+    bool torn = false;
+    while (offset < data.size()) {
+        // length + body + checksum must all be present
+        if (data.size() - offset < 8) {
+            torn = true;
+            break;
+        }
+        stream.device()->seek(offset);
+        quint32 length = 0;
+        stream >> length;
+        if (length > MaxRecordBytes || data.size() - offset - 8 < qint64(length)) {
+            torn = true;
+            break;
+        }
+        const QByteArray body = data.mid(offset + 4, length);
+        stream.device()->seek(offset + 4 + length);
+        quint32 checksum = 0;
+        stream >> checksum;
+
+        JournalRecord record;
+        if (checksum != crc32(body) || !decode(body, record)) {
+            qDebug() << "Corrupt change journal record at byte" << offset << "in" << path;
+            torn = true;
+            break;
+        }
+        records.append(record);
+        offset += 8 + length;
+    }
+
+    if (truncated) {
+        *truncated = torn;
+    }
+    if (validBytes) {
+        *validBytes = offset;
+    }
+    return true;
+}
@@ -0,0 +1,100 @@
+#ifndef CHANGEJOURNAL_H
+#define CHANGEJOURNAL_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QFile>
+#include <QVector>
+#include "database.h"
+
+// One mutation of the team/souvenir tables or the distance graph
+struct JournalRecord {
+    enum Type : quint8 {
+        TeamUpsert = 1,
+        TeamDelete,
+        SouvenirAdd,
+        SouvenirUpdate,
+        SouvenirDelete,
+        SouvenirBulkUpdate,
+        EdgeSet,
+        EdgeRemove,
+        GraphClear
+    };
+
+    quint64 sequence = 0;
+    Type type = TeamUpsert;
+
+    TeamRow team;                     // TeamUpsert
+    bool withDefaultSouvenirs = false;  // TeamUpsert: new teams get the default souvenirs
+    QString teamName;                 // TeamDelete, Souvenir*
+    QString itemName;                 // Souvenir*
+    double value = 0.0;               // souvenir price or edge distance
+    SouvenirPriceUpdate priceUpdate;  // SouvenirBulkUpdate
+    QString from;                     // Edge*
+    QString to;
+
+    bool isGraphChange() const { return type >= EdgeSet; }
+};
+
+// Append-only binary change journal.
+//
+// File layout (QDataStream, big endian):
+//   header: magic "BBJ1", quint16 version, quint16 reserved, quint64 journal ID
+//   record: quint32 body length, body, quint32 CRC-32 of body
+//   body:   quint64 sequence, quint8 type, type-specific fields
+//
+// Sequence numbers start at 1 and increase by one per record. The journal
+// ID is random per file, so appliers can track progress per source kiosk.
+// Records are buffered and written as a group every groupSize() appends or
+// on flush(); unflushed records are lost if the process dies. Opening an
+// existing file resumes its sequence and cuts off a torn final record.
+class ChangeJournal {
+public:
+    ChangeJournal() = default;
+    ~ChangeJournal();
+
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+    bool flush();
+
+    void setGroupSize(int records) { groupSize = qMax(1, records); }
+    int groupSizeLimit() const { return groupSize; }
+
+    quint64 journalId() const { return id; }
+    quint64 lastSequence() const { return sequence; }
+
+    void teamUpserted(const TeamRow &row, bool withDefaultSouvenirs);
+    void teamDeleted(const QString &teamName);
+    void souvenirAdded(const QString &teamName, const QString &itemName, double price);
+    void souvenirUpdated(const QString &teamName, const QString &itemName, double price);
+    void souvenirDeleted(const QString &teamName, const QString &itemName);
+    void souvenirPricesUpdated(const SouvenirPriceUpdate &update);
+    void edgeSet(const QString &from, const QString &to, double distance);
+    void edgeRemoved(const QString &from, const QString &to);
+    void graphCleared();
+
+    void append(JournalRecord record);
+
+    // Reads every intact record of a journal file. Returns false when the
+    // file cannot be opened or has a bad header; a torn or corrupt record
+    // ends the read and sets truncated.
+    static bool readFile(const QString &path, quint64 &journalId, QVector<JournalRecord> &records,
+                         bool *truncated = nullptr, qint64 *validBytes = nullptr);
+
+    static quint32 crc32(const QByteArray &data);
+
+private:
+    static QByteArray encode(const JournalRecord &record);
+    static bool decode(const QByteArray &body, JournalRecord &record);
+
+    QFile file;
+    QByteArray pending;
+    int pendingRecords = 0;
+    int groupSize = 64;
+    quint64 id = 0;
+    quint64 sequence = 0;
+};
+
+#endif // CHANGEJOURNAL_H
@@ -0,0 +1,374 @@
+#include "compressedgraph.h"
+#include "densegraph.h"
+#include "stadiumgraph.h"
+#include <QHash>
+#include <QSet>
+#include <QDebug>
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define COMPRESSED_GRAPH_SIMD 1
+#endif
+
+namespace {
+
+// Bytes past the last row, so a 16-byte load at any value start stays
+// inside the buffer
+const int Padding = 16;
+
+// Weights are whole tenths of a mile
+const float WeightScale = 0.1f;
+
+quint32 zigzag(qint32 value)
+{
+    return (quint32(value) << 1) ^ quint32(value >> 31);
+}
+
+quint32 unzigzag(quint32 value)
+{
+    return (value >> 1) ^ (0u - (value & 1));
+}
+
+int valueLength(quint32 value)
+{
+    return value < (1u << 8) ? 1 : value < (1u << 16) ? 2 : value < (1u << 24) ? 3 : 4;
+}
+
+// Appends four values after their control byte at out[control]
+void appendValues(QVector<quint8>& out, qint64 control, const quint32* values)
+{
+    quint8 code = 0;
+    for (int k = 0; k < 4; ++k) {
+        const int length = valueLength(values[k]);
+        code |= quint8((length - 1) << (2 * k));
+        for (int b = 0; b < length; ++b) {
+            out.append(quint8(values[k] >> (8 * b)));
+        }
+    }
+    out[control] = code;
+}
+
+const quint8* decodeValuesScalar(const quint8* data, quint8 control, quint32* values)
+{
+    for (int k = 0; k < 4; ++k) {
+        const int length = ((control >> (2 * k)) & 3) + 1;
+        quint32 value = 0;
+        for (int b = 0; b < length; ++b) {
+            value |= quint32(data[b]) << (8 * b);
+        }
+        values[k] = value;
+        data += length;
+    }
+    return data;
+}
+
+#ifdef COMPRESSED_GRAPH_SIMD
+// Per control byte: the pshufb mask that spreads its four values over
+// 32-bit lanes, and their total length in bytes
+struct DecodeTables {
+    alignas(16) quint8 shuffle[256][16];
+    quint8 length[256];
+
+    DecodeTables()
+    {
+        for (int control = 0; control < 256; ++control) {
+            int offset = 0;
+            for (int k = 0; k < 4; ++k) {
+                const int length = ((control >> (2 * k)) & 3) + 1;
+                for (int b = 0; b < 4; ++b) {
+                    shuffle[control][4 * k + b] = b < length ? quint8(offset + b) : 0x80;
+                }
+                offset += length;
+            }
+            length[control] = quint8(offset);
+        }
+    }
+};
+
+const DecodeTables& decodeTables()
+{
+    static const DecodeTables tables;
+    return tables;
+}
+
+__attribute__((target("ssse3,sse4.1")))
+void decodeBlockSimd(const quint8*& data, int groups, quint32& previous, bool& first, int* targets, float* weights)
+{
+    const DecodeTables& tables = decodeTables();
+    const __m128 scale = _mm_set1_ps(WeightScale);
+    const quint8* p = data;
+    for (int g = 0; g < groups; ++g) {
+        const quint8 targetControl = p[0];
+        const quint8 weightControl = p[1];
+        p += 2;
+        __m128i deltas = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)),
+                                          _mm_load_si128(reinterpret_cast<const __m128i*>(tables.shuffle[targetControl])));
+        p += tables.length[targetControl];
+        const __m128i tenths = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)),
+                                                _mm_load_si128(reinterpret_cast<const __m128i*>(tables.shuffle[weightControl])));
+        p += tables.length[weightControl];
+
+        if (first) {
+            // previous is still the row's node; fold the first target's
+            // zigzag offset into it so the plain prefix sum below applies
+            const quint32 raw = quint32(_mm_cvtsi128_si32(deltas));
+            previous += unzigzag(raw) - raw;
+            first = false;
+        }
+        // Inclusive prefix sum over the four deltas
+        deltas = _mm_add_epi32(deltas, _mm_slli_si128(deltas, 4));
+        deltas = _mm_add_epi32(deltas, _mm_slli_si128(deltas, 8));
+        const __m128i ids = _mm_add_epi32(deltas, _mm_set1_epi32(int(previous)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(targets + 4 * g), ids);
+        _mm_storeu_ps(weights + 4 * g, _mm_mul_ps(_mm_cvtepi32_ps(tenths), scale));
+        previous = quint32(_mm_extract_epi32(ids, 3));
+    }
+    data = p;
+}
+#endif
+
+struct DirectedEdge {
+    int from;
+    int to;
+    double distance;
+
+    bool operator<(const DirectedEdge& other) const
+    {
+        return from != other.from ? from < other.from : to < other.to;
+    }
+};
+
+bool useSimd()
+{
+    static const bool supported = CompressedGraph::hasSimdSupport();
+    return supported;
+}
+
+} // namespace
+
+bool CompressedGraph::build(const QVector<int>& rowStart, const QVector<int>& targets, const QVector<double>& weights,
+                            const QVector<QString>& names)
+{
+    clear();
+    const int n = qMax(0, int(rowStart.size()) - 1);
+    rowOffsets.reserve(n + 1);
+    degrees.reserve(n);
+    bytes.reserve(targets.size() * 3 + Padding);
+    QVector<quint32> rowTargets;
+    QVector<quint32> rowTenths;
+    for (int u = 0; u < n; ++u) {
+        rowTargets.clear();
+        rowTenths.clear();
+        for (int e = rowStart[u]; e < rowStart[u + 1]; ++e) {
+            if (targets[e] == u || !(weights[e] > 0)) {
+                continue;
+            }
+            rowTargets.append(quint32(targets[e]));
+            rowTenths.append(qMax<quint32>(1, quint32(qRound64(weights[e] * 10.0))));
+        }
+        rowOffsets.append(bytes.size());
+        degrees.append(rowTargets.size());
+        edges += rowTargets.size();
+
+        quint32 previous = quint32(u);
+        for (int first = 0; first < rowTargets.size(); first += 4) {
+            quint32 deltas[4] = {0, 0, 0, 0};
+            quint32 tenths[4] = {0, 0, 0, 0};
+            for (int k = 0; k < 4 && first + k < rowTargets.size(); ++k) {
+                const quint32 target = rowTargets[first + k];
+                deltas[k] = first + k == 0 ? zigzag(qint32(target - quint32(u))) : target - previous;
+                tenths[k] = rowTenths[first + k];
+                previous = target;
+            }
+            const qint64 control = bytes.size();
+            bytes.append(0);
+            bytes.append(0);
+            appendValues(bytes, control, deltas);
+            appendValues(bytes, control + 1, tenths);
+        }
+    }
+    rowOffsets.append(bytes.size());
+    for (int i = 0; i < Padding; ++i) {
+        bytes.append(0);
+    }
+    bytes.squeeze();
+
+    if (!names.isEmpty() && !index.build(names)) {
+        qDebug() << "CompressedGraph: could not index" << names.size() << "node names";
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool CompressedGraph::loadFromCSVs(const QStringList& filenames, CsvMergeRule rule)
+{
+    const QVector<CsvStagedFile<DistanceRow>> files = CsvImport::parseDistanceFiles(filenames);
+    QVector<DistanceRow> merged;
+    if (!CsvImport::mergeDistances(files, rule, merged)) {
+        return false;
+    }
+
+    QSet<QString> seen;
+    for (const DistanceRow& row : merged) {
+        seen.insert(row.from);
+        seen.insert(row.to);
+    }
+    QVector<QString> names = seen.values();
+    std::sort(names.begin(), names.end());
+    QHash<QString, int> ids;
+    ids.reserve(names.size());
+    for (int i = 0; i < names.size(); ++i) {
+        ids.insert(names[i], i);
+    }
+
+    // Both directions of every row, grouped by source and sorted by target
+    QVector<DirectedEdge> directed;
+    directed.reserve(merged.size() * 2);
+    for (const DistanceRow& row : merged) {
+        const int a = ids.value(row.from);
+        const int b = ids.value(row.to);
+        directed.append({a, b, row.distance});
+        directed.append({b, a, row.distance});
+    }
+    merged.clear();
+    std::sort(directed.begin(), directed.end());
+
+    QVector<int> rowStart(names.size() + 1, 0);
+    QVector<int> targets;
+    QVector<double> weights;
+    targets.reserve(directed.size());
+    weights.reserve(directed.size());
+    for (const DirectedEdge& edge : directed) {
+        ++rowStart[edge.from + 1];
+        targets.append(edge.to);
+        weights.append(edge.distance);
+    }
+    for (int u = 0; u < names.size(); ++u) {
+        rowStart[u + 1] += rowStart[u];
+    }
+    directed.clear();
+    return build(rowStart, targets, weights, names);
+}
+
+void CompressedGraph::clear()
+{
+    bytes.clear();
+    rowOffsets.clear();
+    degrees.clear();
+    edges = 0;
+    index.clear();
+}
+
+qint64 CompressedGraph::memoryBytes() const
+{
+    return qint64(bytes.capacity()) + qint64(rowOffsets.capacity()) * sizeof(qint64)
+         + qint64(degrees.capacity()) * sizeof(qint32);
+}
+
+double CompressedGraph::dijkstra(const QString& start, const QString& end, QVector<QString>& path) const
+{
+    path.clear();
+    const QString nStart = StadiumGraph::normalizeStadiumName(start);
+    const QString nEnd = StadiumGraph::normalizeStadiumName(end);
+    const int source = nStart.isEmpty() ? -1 : nodeId(nStart);
+    const int target = nEnd.isEmpty() ? -1 : nodeId(nEnd);
+    if (source < 0 || target < 0) {
+        return -1.0;
+    }
+    QVector<int> nodes;
+    if (!GraphKernels::shortestPathSparse(*this, source, target, nodes)) {
+        return -1.0;
+    }
+    // Whole tenths sum exactly
+    qint64 tenths = 0;
+    for (int i = 0; i < nodes.size(); ++i) {
+        path.append(nodeName(nodes[i]));
+        if (i > 0) {
+            forEachEdge(nodes[i - 1], [&](int v, float weight) {
+                if (v == nodes[i]) {
+                    tenths += qRound64(weight * 10.0);
+                }
+            });
+        }
+    }
+    return tenths / 10.0;
+}
+
+void CompressedGraph::relax(int u, float base, float* dist, int* previous, const quint64* done) const
+{
+    forEachEdge(u, [&](int v, float weight) {
+        const float alt = base + weight;
+        if (alt < dist[v] && !GraphKernels::isDone(done, v)) {
+            dist[v] = alt;
+            previous[v] = u;
+        }
+    });
+}
+
+int CompressedGraph::nearest(int u, const quint64* done) const
+{
+    int best = -1;
+    float bestWeight = std::numeric_limits<float>::infinity();
+    forEachEdge(u, [&](int v, float weight) {
+        if (weight < bestWeight && !GraphKernels::isDone(done, v)) {
+            bestWeight = weight;
+            best = v;
+        }
+    });
+    return best;
+}
+
+bool CompressedGraph::hasSimdSupport()
+{
+#ifdef COMPRESSED_GRAPH_SIMD
+    return __builtin_cpu_supports("ssse3") && __builtin_cpu_supports("sse4.1");
+#else
+    return false;
+#endif
+}
+
+CompressedGraph::Cursor CompressedGraph::rowCursor(int u) const
+{
+    Cursor cursor;
+    cursor.data = bytes.constData() + rowOffsets[u];
+    cursor.remaining = degrees[u];
+    cursor.previous = quint32(u);
+    cursor.first = true;
+    return cursor;
+}
+
+int CompressedGraph::decodeBlock(Cursor& cursor, int* targets, float* weights) const
+{
+    // BlockEdges is a multiple of four, so only a row's last block ends in a
+    // partly padded group
+    const int count = qMin(cursor.remaining, int(BlockEdges));
+    const int groups = (count + 3) / 4;
+    cursor.remaining -= count;
+#ifdef COMPRESSED_GRAPH_SIMD
+    if (simdEnabled && useSimd()) {
+        decodeBlockSimd(cursor.data, groups, cursor.previous, cursor.first, targets, weights);
+        return count;
+    }
+#endif
+    quint32 deltas[4];
+    quint32 tenths[4];
+    for (int g = 0; g < groups; ++g) {
+        const quint8 targetControl = cursor.data[0];
+        const quint8 weightControl = cursor.data[1];
+        cursor.data = decodeValuesScalar(cursor.data + 2, targetControl, deltas);
+        cursor.data = decodeValuesScalar(cursor.data, weightControl, tenths);
+        for (int k = 0; k < 4; ++k) {
+            if (cursor.first) {
+                cursor.previous += unzigzag(deltas[0]);
+                cursor.first = false;
+            } else {
+                cursor.previous += deltas[k];
+            }
+            targets[4 * g + k] = int(cursor.previous);
+            weights[4 * g + k] = float(qint32(tenths[k])) * WeightScale;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,94 @@
+#ifndef COMPRESSEDGRAPH_H
+#define COMPRESSEDGRAPH_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QtGlobal>
+#include "namekey.h"
+#include "perfecthash.h"
+#include "csvimport.h"
+
+// Read-only distance graph for tables far larger than StadiumGraph's map is
+// meant for (road-derived or all-pairs distances between tens of thousands
+// of venues). Each row is stored as Stream VByte groups of four edges: two
+// control bytes with a 2-bit length per value, then 1 to 4 bytes per value.
+// Targets are sorted and delta-encoded (the first one as a zigzag offset
+// from the row's own node), weights are whole tenths of a mile. Groups are
+// decoded with SSSE3 byte shuffles when the CPU supports it.
+//
+// Implements the adjacency interface of the GraphKernels templates
+// (relax, nearest and forEachEdge) so they run on it directly.
+class CompressedGraph {
+public:
+    // Edges decoded per forEachEdge step
+    static const int BlockEdges = 64;
+
+    // CSR rows as built by StadiumGraph, each sorted by target. Self loops
+    // and non-positive weights are dropped; names[u] is node u's name and may
+    // be empty.
+    bool build(const QVector<int>& rowStart, const QVector<int>& targets, const QVector<double>& weights,
+               const QVector<QString>& names = QVector<QString>());
+    // Loads undirected "from,to,distance" tables without going through a
+    // StadiumGraph; node IDs follow normalized name order
+    bool loadFromCSVs(const QStringList& filenames, CsvMergeRule rule = CsvMergeRule::LastFileWins);
+    void clear();
+
+    int size() const { return int(degrees.size()); }
+    qint64 edgeCount() const { return edges; }
+    int degree(int u) const { return degrees[u]; }
+    int nodeId(const QString& normalizedName) const { return index.find(normalizedName); }
+    QString nodeName(int u) const { return u < index.size() ? index.key(u).toString() : QString(); }
+
+    // Encoded rows plus the per-node tables, excluding the name index
+    qint64 memoryBytes() const;
+    double bytesPerEdge() const { return edges > 0 ? double(memoryBytes()) / edges : 0.0; }
+
+    // Shortest path by stadium name (any spelling) over the heap Dijkstra
+    // kernel, in miles; -1 when either name is unknown or there is no path
+    double dijkstra(const QString& start, const QString& end, QVector<QString>& path) const;
+
+    void relax(int u, float base, float* dist, int* previous, const quint64* done) const;
+    int nearest(int u, const quint64* done) const;
+
+    // Calls fn(v, weight) for every edge of u in target order
+    template<typename Fn>
+    void forEachEdge(int u, Fn fn) const
+    {
+        int targets[BlockEdges];
+        float weights[BlockEdges];
+        Cursor cursor = rowCursor(u);
+        while (cursor.remaining > 0) {
+            const int count = decodeBlock(cursor, targets, weights);
+            for (int i = 0; i < count; ++i) {
+                fn(targets[i], weights[i]);
+            }
+        }
+    }
+
+    static bool hasSimdSupport();
+    // Off forces the scalar decoder even where SIMD is supported, so the
+    // two can be compared
+    void setSimdEnabled(bool enabled) { simdEnabled = enabled; }
+
+private:
+    struct Cursor {
+        const quint8* data;
+        int remaining;
+        quint32 previous;  // last decoded target; the row's node before any
+        bool first;
+    };
+
+    Cursor rowCursor(int u) const;
+    // Decodes up to BlockEdges edges and advances the cursor
+    int decodeBlock(Cursor& cursor, int* targets, float* weights) const;
+
+    QVector<quint8> bytes;        // all rows, then padding for 16-byte loads
+    QVector<qint64> rowOffsets;   // start of each row in bytes
+    QVector<qint32> degrees;
+    qint64 edges = 0;
+    MinimalPerfectHash index;     // normalized name -> node ID, when named
+    bool simdEnabled = true;
+};
+
+#endif // COMPRESSEDGRAPH_H
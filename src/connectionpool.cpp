@@ -0,0 +1,105 @@
+#include "connectionpool.h"
+#include <QThread>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QMutexLocker>
+#include <QAtomicInt>
+#include <QDebug>
+
+namespace {
+
+QAtomicInt poolCounter;
+
+} // namespace
+
+ConnectionPool::ConnectionPool(const QString &databaseName)
+    : prefix(QString("pool%1").arg(poolCounter.fetchAndAddRelaxed(1)))
+    , inMemory(databaseName.isEmpty() || databaseName == ":memory:")
+    , owner(QThread::currentThread())
+    , state(std::make_shared<State>())
+{
+    if (inMemory) {
+        sqliteName = QString("file:%1?mode=memory&cache=shared").arg(prefix);
+        options = "QSQLITE_OPEN_URI;QSQLITE_BUSY_TIMEOUT=5000";
+    } else {
+        sqliteName = databaseName;
+        options = "QSQLITE_BUSY_TIMEOUT=5000";
+    }
+    // Open the owner's connection now so an in-memory database exists for
+    // as long as the pool does
+    connection();
+}
+
+ConnectionPool::~ConnectionPool()
+{
+    // Other threads' connections are removed when those threads finish
+    QString name;
+    {
+        QMutexLocker locker(&state->mutex);
+        name = state->names.take(owner);
+    }
+    if (!name.isEmpty()) {
+        QSqlDatabase::database(name, false).close();
+        QSqlDatabase::removeDatabase(name);
+    }
+}
+
+QSqlDatabase ConnectionPool::connection() const
+{
+    QThread *thread = QThread::currentThread();
+    QString name;
+    {
+        QMutexLocker locker(&state->mutex);
+        name = state->names.value(thread);
+        if (name.isEmpty()) {
+            name = prefix + "-" + QString::number(quintptr(thread), 16);
+            state->names.insert(thread, name);
+        } else {
+            locker.unlock();
+            return QSqlDatabase::database(name, false);
+        }
+    }
+
+    if (thread != owner) {
+        // finished is emitted from the exiting thread itself, so the
+        // connection is closed by the thread that owns it
+        std::weak_ptr<State> weakState = state;
+        QObject::connect(thread, &QThread::finished, thread, [weakState, thread, name]() {
+            if (std::shared_ptr<State> alive = weakState.lock()) {
+                QMutexLocker locker(&alive->mutex);
+                alive->names.remove(thread);
+            }
+            QSqlDatabase::database(name, false).close();
+            QSqlDatabase::removeDatabase(name);
+        }, Qt::DirectConnection);
+    }
+    return open(name);
+}
+
+QSqlDatabase ConnectionPool::open(const QString &connectionName) const
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(sqliteName);
+    db.setConnectOptions(options);
+    if (!db.open()) {
+        qDebug() << "Error opening connection" << connectionName << ":" << db.lastError().text();
+        return db;
+    }
+    QSqlQuery pragma(db);
+    if (!inMemory) {
+        if (!pragma.exec("PRAGMA journal_mode=WAL") || !pragma.exec("PRAGMA synchronous=NORMAL")) {
+            qDebug() << "Error enabling WAL on" << connectionName << ":" << pragma.lastError().text();
+        }
+    } else if (!pragma.exec("PRAGMA read_uncommitted=true")) {
+        // Shared-cache readers would otherwise fail with SQLITE_LOCKED while
+        // another connection writes
+        qDebug() << "Error enabling read_uncommitted on" << connectionName << ":" << pragma.lastError().text();
+    }
+    return db;
+}
+
+int ConnectionPool::connectionCount() const
+{
+    QMutexLocker locker(&state->mutex);
+    return state->names.size();
+}
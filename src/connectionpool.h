@@ -0,0 +1,55 @@
+#ifndef CONNECTIONPOOL_H
+#define CONNECTIONPOOL_H
+
+#include <QString>
+#include <QHash>
+#include <QMutex>
+#include <QSqlDatabase>
+#include <memory>
+
+class QThread;
+
+// One SQLite database, one Qt connection per thread. Qt connections may only
+// be used by the thread that opened them, so connection() lazily opens a
+// uniquely named connection the first time a thread asks and removes it
+// when that thread finishes.
+//
+// A file name opens the database in WAL mode, so readers on worker threads
+// do not block on the writer. ":memory:" (the default) opens a named
+// shared-cache in-memory database that every thread's connection sees; the
+// creating thread's connection stays open for the pool's lifetime because
+// SQLite drops the database with its last connection. Shared-cache
+// connections read uncommitted, so readers do not fail with SQLITE_LOCKED
+// while another connection writes, but they can see rows of a transaction
+// that later rolls back; callers keep such readers out of open write
+// transactions themselves (see Database::getSouvenirs). Two writers can
+// still fail with SQLITE_LOCKED, and the query's lastError() reports it.
+class ConnectionPool {
+public:
+    explicit ConnectionPool(const QString &databaseName = ":memory:");
+    ~ConnectionPool();
+
+    // The calling thread's connection, opened on first use. Check isOpen()
+    // and lastError() for failures.
+    QSqlDatabase connection() const;
+
+    bool isInMemory() const { return inMemory; }
+    int connectionCount() const;
+
+private:
+    struct State {
+        QMutex mutex;
+        QHash<QThread*, QString> names;
+    };
+
+    QSqlDatabase open(const QString &connectionName) const;
+
+    QString prefix;
+    QString sqliteName;
+    QString options;
+    bool inMemory;
+    QThread *owner;
+    std::shared_ptr<State> state;  // shared with thread-exit handlers
+};
+
+#endif // CONNECTIONPOOL_H
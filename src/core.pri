@@ -0,0 +1,62 @@
+# Non-GUI sources: the data layer, graph and kernels. Included by the
+# application and by the tests under tests/.
+
+QT += sql concurrent
+CONFIG += c++17
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/database.cpp \
+    $$PWD/stadiumgraph.cpp \
+    $$PWD/trip.cpp \
+    $$PWD/stadiumregistry.cpp \
+    $$PWD/souvenircart.cpp \
+    $$PWD/itinerarykernel.cpp \
+    $$PWD/stadiuminfo.cpp \
+    $$PWD/stringdictionary.cpp \
+    $$PWD/stadiumrangeindex.cpp \
+    $$PWD/stadiumaggregator.cpp \
+    $$PWD/teamsearchindex.cpp \
+    $$PWD/csvhotreloader.cpp \
+    $$PWD/changejournal.cpp \
+    $$PWD/journalapplier.cpp \
+    $$PWD/sharedgraph.cpp \
+    $$PWD/defaultdata.cpp \
+    $$PWD/perfecthash.cpp \
+    $$PWD/namekey.cpp \
+    $$PWD/asynctasks.cpp \
+    $$PWD/connectionpool.cpp \
+    $$PWD/writebehindqueue.cpp \
+    $$PWD/csvimport.cpp \
+    $$PWD/graphvalidator.cpp \
+    $$PWD/densegraph.cpp \
+    $$PWD/compressedgraph.cpp \
+    $$PWD/graphorder.cpp
+
+HEADERS += \
+    $$PWD/database.h \
+    $$PWD/stadiumgraph.h \
+    $$PWD/trip.h \
+    $$PWD/stadiumregistry.h \
+    $$PWD/souvenircart.h \
+    $$PWD/itinerarykernel.h \
+    $$PWD/stadiuminfo.h \
+    $$PWD/stringdictionary.h \
+    $$PWD/stadiumrangeindex.h \
+    $$PWD/stadiumaggregator.h \
+    $$PWD/teamsearchindex.h \
+    $$PWD/csvhotreloader.h \
+    $$PWD/changejournal.h \
+    $$PWD/journalapplier.h \
+    $$PWD/sharedgraph.h \
+    $$PWD/defaultdata.h \
+    $$PWD/perfecthash.h \
+    $$PWD/namekey.h \
+    $$PWD/asynctasks.h \
+    $$PWD/connectionpool.h \
+    $$PWD/writebehindqueue.h \
+    $$PWD/csvimport.h \
+    $$PWD/graphvalidator.h \
+    $$PWD/densegraph.h \
+    $$PWD/compressedgraph.h \
+    $$PWD/graphorder.h
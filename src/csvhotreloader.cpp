@@ -0,0 +1,298 @@
+#include "csvhotreloader.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QDebug>
+
+namespace {
+
+// Writers often truncate and rewrite in several steps; wait for them to settle
+const int DebounceMs = 500;
+
+quint64 fnv1a(quint64 hash, const QString &text)
+{
+    for (QChar c : text) {
+        hash ^= c.unicode();
+        hash *= 1099511628211ULL;
+    }
+    // Field separator so ("ab", "c") and ("a", "bc") differ
+    hash ^= 0x1f;
+    hash *= 1099511628211ULL;
+    return hash;
+}
+
+} // namespace
+
+CsvHotReloader::CsvHotReloader(Database *db, StadiumGraph *graph, QObject *parent)
+    : QObject(parent)
+    , db(db)
+    , graph(graph)
+{
+    debounce.setSingleShot(true);
+    debounce.setInterval(DebounceMs);
+    connect(&watcher, &QFileSystemWatcher::fileChanged, this, &CsvHotReloader::onFileChanged);
+    connect(&debounce, &QTimer::timeout, this, &CsvHotReloader::processPending);
+}
+
+quint64 CsvHotReloader::hashTeamRow(const TeamRow &row)
+{
+    quint64 hash = 14695981039346656037ULL;
+    hash = fnv1a(hash, row.teamName);
+    hash = fnv1a(hash, row.stadiumName);
+    hash = fnv1a(hash, QString::number(row.capacity));
+    hash = fnv1a(hash, row.location);
+    hash = fnv1a(hash, row.surface);
+    hash = fnv1a(hash, row.league);
+    hash = fnv1a(hash, row.dateOpened);
+    hash = fnv1a(hash, QString::number(row.centerField));
+    hash = fnv1a(hash, row.typology);
+    hash = fnv1a(hash, row.roof);
+    return hash;
+}
+
+CsvHotReloader::EdgeKey CsvHotReloader::edgeKey(const QString &from, const QString &to)
+{
+    QString a = StadiumGraph::normalizeStadiumName(from);
+    QString b = StadiumGraph::normalizeStadiumName(to);
+    return a < b ? qMakePair(a, b) : qMakePair(b, a);
+}
+
+bool CsvHotReloader::watchTeamFile(const QString &path)
+{
+    return watchFile(path, TeamFile);
+}
+
+bool CsvHotReloader::watchDistanceFile(const QString &path)
+{
+    return watchFile(path, DistanceFile);
+}
+
+bool CsvHotReloader::watchFile(const QString &path, FileKind kind)
+{
+    QString canonical = QFileInfo(path).canonicalFilePath();
+    if (canonical.isEmpty()) {
+        qDebug() << "Cannot watch missing file:" << path;
+        return false;
+    }
+    ReloadStats stats;
+    if (snapshots.contains(canonical)) {
+        return reloadNow(canonical, stats);
+    }
+
+    // The caller has just imported the file, and teams already in the
+    // database kept their (possibly edited) rows, so the file's current rows
+    // are only the baseline; applying them would overwrite those edits
+    Snapshot snapshot;
+    snapshot.kind = kind;
+    bool ok = kind == TeamFile ? reloadTeams(canonical, snapshot, stats, false)
+                               : reloadDistances(canonical, snapshot, stats, false);
+    if (!ok) {
+        return false;
+    }
+    snapshots.insert(canonical, snapshot);
+    watcher.addPath(canonical);
+    return true;
+}
+
+void CsvHotReloader::setPaused(bool newPaused)
+{
+    paused = newPaused;
+    if (!paused && !pending.isEmpty()) {
+        debounce.start();
+    }
+}
+
+void CsvHotReloader::onFileChanged(const QString &path)
+{
+    pending.insert(path);
+    if (!paused) {
+        debounce.start();
+    }
+}
+
+void CsvHotReloader::processPending()
+{
+    if (paused) {
+        return;
+    }
+    const QSet<QString> files = pending;
+    pending.clear();
+    for (const QString &path : files) {
+        // Files replaced by rename drop out of the watcher; pick them up again
+        if (QFile::exists(path) && !watcher.files().contains(path)) {
+            watcher.addPath(path);
+        }
+        ReloadStats stats;
+        if (!reloadNow(path, stats)) {
+            qDebug() << "Hot reload failed, keeping previous data for" << path;
+        }
+    }
+}
+
+bool CsvHotReloader::reloadNow(const QString &path, ReloadStats &stats)
+{
+    auto it = snapshots.find(path);
+    if (it == snapshots.end()) {
+        return false;
+    }
+    // Work on a copy so a failed apply leaves the snapshot matching the data
+    Snapshot snapshot = it.value();
+    bool ok = snapshot.kind == TeamFile ? reloadTeams(path, snapshot, stats, true)
+                                        : reloadDistances(path, snapshot, stats, true);
+    if (!ok) {
+        return false;
+    }
+    it.value() = snapshot;
+    qDebug() << "Hot reload" << path << ":" << stats.inserted << "inserted,"
+             << stats.changed << "changed," << stats.deleted << "deleted";
+    if (stats.inserted || stats.changed || stats.deleted) {
+        emit reloaded(path, stats.inserted, stats.changed, stats.deleted);
+    }
+    return true;
+}
+
+bool CsvHotReloader::reloadTeams(const QString &path, Snapshot &snapshot, ReloadStats &stats, bool apply)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+    QTextStream in(&file);
+    if (!in.atEnd()) {
+        in.readLine();  // header
+    }
+
+    QHash<QString, quint64> current;
+    QHash<QString, TeamRow> currentRows;
+    QVector<TeamRow> upserts;
+    while (!in.atEnd()) {
+        TeamRow row;
+        if (!Database::parseTeamRow(in.readLine(), row)) {
+            continue;
+        }
+        quint64 hash = hashTeamRow(row);
+        current.insert(row.teamName, hash);
+        currentRows.insert(row.teamName, row);
+        auto previous = snapshot.teamHashes.constFind(row.teamName);
+        if (previous == snapshot.teamHashes.constEnd()) {
+            ++stats.inserted;
+            upserts.append(row);
+        } else if (previous.value() != hash) {
+            ++stats.changed;
+            upserts.append(row);
+        }
+    }
+    file.close();
+
+    QStringList deleted;
+    for (auto it = snapshot.teamHashes.constBegin(); it != snapshot.teamHashes.constEnd(); ++it) {
+        if (current.contains(it.key())) {
+            continue;
+        }
+        TeamRow fallback;
+        quint64 fallbackHash = 0;
+        if (!teamInOtherFile(path, it.key(), fallback, fallbackHash)) {
+            ++stats.deleted;
+            deleted << it.key();
+        } else if (fallbackHash != it.value()) {
+            ++stats.changed;
+            upserts.append(fallback);
+        }
+    }
+
+    if (apply && !db->applyTeamDiff(upserts, deleted)) {
+        return false;
+    }
+    snapshot.teamHashes = current;
+    snapshot.teamRows = currentRows;
+    return true;
+}
+
+bool CsvHotReloader::reloadDistances(const QString &path, Snapshot &snapshot, ReloadStats &stats, bool apply)
+{
+    if (!graph) {
+        return false;
+    }
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+    QTextStream in(&file);
+
+    // The header and malformed lines fail to parse and are skipped
+    QHash<EdgeKey, double> current;
+    while (!in.atEnd()) {
+        QString from;
+        QString to;
+        double distance = 0.0;
+        if (StadiumGraph::parseDistanceRow(in.readLine(), from, to, distance)) {
+            current.insert(edgeKey(from, to), distance);
+        }
+    }
+    file.close();
+    if (!apply) {
+        snapshot.distances = current;
+        return true;
+    }
+
+    for (auto it = current.constBegin(); it != current.constEnd(); ++it) {
+        auto previous = snapshot.distances.constFind(it.key());
+        if (previous == snapshot.distances.constEnd()) {
+            ++stats.inserted;
+        } else if (previous.value() != it.value()) {
+            ++stats.changed;
+        } else {
+            continue;
+        }
+        graph->addEdge(it.key().first, it.key().second, it.value());
+    }
+    for (auto it = snapshot.distances.constBegin(); it != snapshot.distances.constEnd(); ++it) {
+        if (current.contains(it.key())) {
+            continue;
+        }
+        double fallback = 0.0;
+        if (!distanceInOtherFile(path, it.key(), fallback)) {
+            ++stats.deleted;
+            graph->removeEdge(it.key().first, it.key().second);
+        } else if (fallback != it.value()) {
+            ++stats.changed;
+            graph->addEdge(it.key().first, it.key().second, fallback);
+        }
+    }
+    snapshot.distances = current;
+    if (stats.inserted + stats.changed + stats.deleted > 0) {
+        graph->publish();
+        GraphValidationReport report = graph->validate(db->stadiumNames());
+        if (!report.isValid()) {
+            qDebug() << "Reloaded distance graph:" << report.summary();
+        }
+    }
+    return true;
+}
+
+bool CsvHotReloader::teamInOtherFile(const QString &path, const QString &teamName,
+                                     TeamRow &row, quint64 &hash) const
+{
+    for (auto it = snapshots.constBegin(); it != snapshots.constEnd(); ++it) {
+        if (it.key() != path && it.value().kind == TeamFile && it.value().teamHashes.contains(teamName)) {
+            row = it.value().teamRows.value(teamName);
+            hash = it.value().teamHashes.value(teamName);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CsvHotReloader::distanceInOtherFile(const QString &path, const EdgeKey &key, double &distance) const
+{
+    for (auto it = snapshots.constBegin(); it != snapshots.constEnd(); ++it) {
+        if (it.key() != path && it.value().kind == DistanceFile) {
+            auto found = it.value().distances.constFind(key);
+            if (found != it.value().distances.constEnd()) {
+                distance = found.value();
+                return true;
+            }
+        }
+    }
+    return false;
+}
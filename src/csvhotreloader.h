@@ -0,0 +1,87 @@
+#ifndef CSVHOTRELOADER_H
+#define CSVHOTRELOADER_H
+
+#include <QObject>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QHash>
+#include <QSet>
+#include <QPair>
+#include <QStringList>
+#include "database.h"
+#include "stadiumgraph.h"
+
+struct ReloadStats {
+    int inserted = 0;
+    int changed = 0;
+    int deleted = 0;
+};
+
+// Watches imported team and distance CSVs and applies only what changed.
+// Each file keeps a snapshot of per-row content hashes keyed by team name
+// (team files) or by the unordered stadium pair (distance files). When a
+// file changes, it is re-read, diffed against its snapshot, and inserted,
+// changed and deleted rows are applied to SQLite, the stadium map and the
+// graph. A row removed from one file survives if another watched file
+// still provides it: that file's row is applied in its place and counted
+// as changed if it differs, never as deleted.
+class CsvHotReloader : public QObject
+{
+    Q_OBJECT
+
+public:
+    CsvHotReloader(Database *db, StadiumGraph *graph, QObject *parent = nullptr);
+
+    void setGraph(StadiumGraph *graph) { this->graph = graph; }
+
+    // Start watching a file that was just imported. Its current rows become
+    // the baseline and nothing is applied; later saves apply what changed.
+    // Watching a file again reloads it.
+    bool watchTeamFile(const QString &path);
+    bool watchDistanceFile(const QString &path);
+    QStringList watchedFiles() const { return snapshots.keys(); }
+
+    // While paused, changes are queued and applied on resume
+    void setPaused(bool paused);
+
+    bool reloadNow(const QString &path, ReloadStats &stats);
+
+signals:
+    void reloaded(const QString &path, int inserted, int changed, int deleted);
+
+private slots:
+    void onFileChanged(const QString &path);
+    void processPending();
+
+private:
+    enum FileKind { TeamFile, DistanceFile };
+    typedef QPair<QString, QString> EdgeKey;  // normalized, ordered stadium pair
+
+    struct Snapshot {
+        FileKind kind = TeamFile;
+        QHash<QString, quint64> teamHashes;
+        QHash<QString, TeamRow> teamRows;  // applied when another file drops the team
+        QHash<EdgeKey, double> distances;
+    };
+
+    bool watchFile(const QString &path, FileKind kind);
+    // Diffs the file against snapshot and, when apply is set, applies the
+    // difference; either way snapshot ends up holding the file's rows
+    bool reloadTeams(const QString &path, Snapshot &snapshot, ReloadStats &stats, bool apply);
+    bool reloadDistances(const QString &path, Snapshot &snapshot, ReloadStats &stats, bool apply);
+    bool teamInOtherFile(const QString &path, const QString &teamName, TeamRow &row, quint64 &hash) const;
+    bool distanceInOtherFile(const QString &path, const EdgeKey &key, double &distance) const;
+
+    static quint64 hashTeamRow(const TeamRow &row);
+    static EdgeKey edgeKey(const QString &from, const QString &to);
+
+    Database *db;
+    StadiumGraph *graph;
+    QFileSystemWatcher watcher;
+    QTimer debounce;
+    QHash<QString, Snapshot> snapshots;
+    QSet<QString> pending;
+    bool paused = false;
+};
+
+#endif // CSVHOTRELOADER_H
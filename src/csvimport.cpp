@@ -0,0 +1,179 @@
+#include "csvimport.h"
+#include "database.h"
+#include "stadiumgraph.h"
+#include <QFile>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPair>
+#include <QDebug>
+#include <QtConcurrent/QtConcurrent>
+
+double CsvFileStats::rowsPerSecond() const
+{
+    return parseMicros > 0 ? rows * 1e6 / parseMicros : 0.0;
+}
+
+double CsvFileStats::megabytesPerSecond() const
+{
+    return parseMicros > 0 ? bytes / double(parseMicros) : 0.0;
+}
+
+namespace {
+
+template<typename Row, typename Parse>
+CsvStagedFile<Row> parseFile(const QString &filename, bool skipHeader, Parse parse)
+{
+    CsvStagedFile<Row> staged;
+    staged.stats.fileName = filename;
+
+    QElapsedTimer timer;
+    timer.start();
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qDebug() << "Error opening file:" << filename << file.errorString();
+        return staged;
+    }
+    staged.stats.opened = true;
+    staged.stats.bytes = file.size();
+
+    QTextStream in(&file);
+    if (skipHeader && !in.atEnd()) {
+        in.readLine();
+    }
+    while (!in.atEnd()) {
+        Row row;
+        if (parse(in.readLine(), row)) {
+            staged.rows.append(row);
+        } else {
+            ++staged.stats.skipped;
+        }
+    }
+    staged.stats.rows = staged.rows.size();
+    staged.stats.parseMicros = timer.nsecsElapsed() / 1000;
+    return staged;
+}
+
+template<typename Row, typename Parse>
+QVector<CsvStagedFile<Row>> parseFiles(const QStringList &filenames, bool skipHeader, Parse parse)
+{
+    // blockingMapped returns the results in list order
+    return QtConcurrent::blockingMapped<QVector<CsvStagedFile<Row>>>(filenames,
+        [skipHeader, parse](const QString &filename) {
+            return parseFile<Row>(filename, skipHeader, parse);
+        });
+}
+
+// Keeps each key at its first position in merged; sameRow decides whether a
+// repeated key is a conflict
+template<typename Row, typename Key, typename KeyOf, typename SameRow>
+bool mergeFiles(const QVector<CsvStagedFile<Row>> &files, CsvMergeRule rule,
+                QVector<Row> &merged, KeyOf keyOf, SameRow sameRow,
+                QVector<CsvConflict<Row>> *conflictRows = nullptr)
+{
+    merged.clear();
+    if (conflictRows) {
+        conflictRows->clear();
+    }
+    QHash<Key, int> positions;
+    int conflicts = 0;
+    for (const CsvStagedFile<Row> &file : files) {
+        for (const Row &row : file.rows) {
+            const Key key = keyOf(row);
+            auto it = positions.constFind(key);
+            if (it == positions.constEnd()) {
+                positions.insert(key, merged.size());
+                merged.append(row);
+                continue;
+            }
+            Row &kept = merged[it.value()];
+            if (sameRow(kept, row)) {
+                continue;
+            }
+            if (conflictRows) {
+                conflictRows->append(CsvConflict<Row>{kept, row, file.stats.fileName});
+            }
+            if (rule == CsvMergeRule::ErrorOnConflict) {
+                qDebug() << "Import conflict for" << key << "in" << file.stats.fileName;
+                ++conflicts;
+                continue;
+            }
+            kept = row;
+        }
+    }
+    if (conflicts > 0) {
+        qDebug() << conflicts << "conflicting row(s); nothing imported";
+        merged.clear();
+        return false;
+    }
+    return true;
+}
+
+bool sameTeamRow(const TeamRow &a, const TeamRow &b)
+{
+    return a.teamName == b.teamName && a.stadiumName == b.stadiumName && a.capacity == b.capacity
+           && a.location == b.location && a.surface == b.surface && a.league == b.league
+           && a.dateOpened == b.dateOpened && a.centerField == b.centerField
+           && a.typology == b.typology && a.roof == b.roof;
+}
+
+} // namespace
+
+namespace CsvImport {
+
+QVector<CsvStagedFile<TeamRow>> parseTeamFiles(const QStringList &filenames)
+{
+    return parseFiles<TeamRow>(filenames, true, [](const QString &line, TeamRow &row) {
+        return Database::parseTeamRow(line, row);
+    });
+}
+
+QVector<CsvStagedFile<DistanceRow>> parseDistanceFiles(const QStringList &filenames)
+{
+    // Header lines fail to parse and are counted as skipped
+    return parseFiles<DistanceRow>(filenames, false, [](const QString &line, DistanceRow &row) {
+        QString from;
+        QString to;
+        if (!StadiumGraph::parseDistanceRow(line, from, to, row.distance)) {
+            return false;
+        }
+        row.from = StadiumGraph::normalizeStadiumName(from);
+        row.to = StadiumGraph::normalizeStadiumName(to);
+        return true;
+    });
+}
+
+bool mergeTeams(const QVector<CsvStagedFile<TeamRow>> &files, CsvMergeRule rule,
+                QVector<TeamRow> &merged)
+{
+    return mergeFiles<TeamRow, QString>(files, rule, merged,
+        [](const TeamRow &row) { return row.teamName; },
+        sameTeamRow);
+}
+
+bool mergeDistances(const QVector<CsvStagedFile<DistanceRow>> &files, CsvMergeRule rule,
+                    QVector<DistanceRow> &merged, QVector<CsvConflict<DistanceRow>> *conflicts)
+{
+    typedef QPair<QString, QString> EdgeKey;
+    return mergeFiles<DistanceRow, EdgeKey>(files, rule, merged,
+        [](const DistanceRow &row) {
+            return row.from < row.to ? EdgeKey(row.from, row.to) : EdgeKey(row.to, row.from);
+        },
+        [](const DistanceRow &a, const DistanceRow &b) { return a.distance == b.distance; },
+        conflicts);
+}
+
+void logStats(const QVector<CsvFileStats> &stats)
+{
+    for (const CsvFileStats &file : stats) {
+        if (!file.opened) {
+            qDebug() << "  " << file.fileName << ": not opened";
+            continue;
+        }
+        qDebug() << "  " << file.fileName << ":" << file.rows << "rows," << file.skipped << "skipped,"
+                 << file.bytes << "bytes in" << file.parseMicros / 1000.0 << "ms ("
+                 << qRound64(file.rowsPerSecond()) << "rows/s," << file.megabytesPerSecond() << "MB/s)";
+    }
+}
+
+} // namespace CsvImport
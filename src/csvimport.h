@@ -0,0 +1,77 @@
+#ifndef CSVIMPORT_H
+#define CSVIMPORT_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+struct TeamRow;
+
+// How a key that appears more than once across the imported files is
+// resolved. Team rows are keyed by team name and distance rows by the
+// unordered stadium pair; identical duplicates are never a conflict.
+enum class CsvMergeRule {
+    LastFileWins,    // the row from the later file in the list is kept
+    ErrorOnConflict  // the import fails and nothing is written
+};
+
+// Parse results for one file
+struct CsvFileStats {
+    QString fileName;
+    bool opened = false;
+    int rows = 0;     // rows staged
+    int skipped = 0;  // blank, header and malformed lines
+    qint64 bytes = 0;
+    qint64 parseMicros = 0;
+
+    double rowsPerSecond() const;
+    double megabytesPerSecond() const;
+};
+
+// One distance row with normalized stadium names
+struct DistanceRow {
+    QString from;
+    QString to;
+    double distance = 0.0;
+};
+
+// A key listed again with a different value. earlier is the row the merge
+// held when later, from fileName, was read.
+template<typename Row>
+struct CsvConflict {
+    Row earlier;
+    Row later;
+    QString fileName;
+};
+
+// One file's rows in file order, waiting for the merge
+template<typename Row>
+struct CsvStagedFile {
+    CsvFileStats stats;
+    QVector<Row> rows;
+};
+
+// Multi-file CSV import. Every file is parsed on the global thread pool into
+// its own staging buffer; the buffers are then merged in list order, so the
+// result does not depend on which worker finished first.
+namespace CsvImport {
+
+QVector<CsvStagedFile<TeamRow>> parseTeamFiles(const QStringList &filenames);
+QVector<CsvStagedFile<DistanceRow>> parseDistanceFiles(const QStringList &filenames);
+
+// Merges rows in list order; merged keeps each key at its first position
+// with the value the rule picks. Returns false on a conflict under
+// ErrorOnConflict, after logging every conflicting key. conflicts receives
+// every conflict under either rule, including those LastFileWins resolves.
+bool mergeTeams(const QVector<CsvStagedFile<TeamRow>> &files, CsvMergeRule rule,
+                QVector<TeamRow> &merged);
+bool mergeDistances(const QVector<CsvStagedFile<DistanceRow>> &files, CsvMergeRule rule,
+                    QVector<DistanceRow> &merged,
+                    QVector<CsvConflict<DistanceRow>> *conflicts = nullptr);
+
+// Per-file parse throughput, one qDebug line per file
+void logStats(const QVector<CsvFileStats> &stats);
+
+} // namespace CsvImport
+
+#endif // CSVIMPORT_H
@@ -6,60 +6,266 @@
 #include <QSqlError>
 #include <QStringList>
 #include <QDebug>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QMutexLocker>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <algorithm>
+#include <cmath>
+#include "stringdictionary.h"
+#include "changejournal.h"
+#include "defaultdata.h"
+#include "writebehindqueue.h"
+
+namespace {
+
+const char souvenirQueryText[] = "SELECT item_name, price FROM souvenirs WHERE team_name = :team";
+
+// Every team starts with the same souvenirs; the names come from the shared
+// souvenir-name dictionary so all teams reference one copy of each
+const QVector<QPair<QString, double>> &defaultSouvenirList()
+{
+    static const QVector<QPair<QString, double>> souvenirs = {
+        {StringDictionary::souvenirNames().shared("Baseball cap"), 19.99},
+        {StringDictionary::souvenirNames().shared("Baseball bat"), 89.39},
+        {StringDictionary::souvenirNames().shared("Team pennant"), 17.99},
+        {StringDictionary::souvenirNames().shared("Autographed baseball"), 29.99},
+        {StringDictionary::souvenirNames().shared("Team jersey"), 199.99}
+    };
+    return souvenirs;
+}
+
+// The map entry for a team row, parsed the same way as a row read back
+// from SQL; souvenirs are left empty
+StadiumInfo stadiumInfoFromRow(const TeamRow &row)
+{
+    StadiumInfo info;
+    info.teamName = row.teamName;
+    info.stadiumName = row.stadiumName;
+    info.seatingCapacity = row.capacity;
+    info.setLocation(row.location);
+    info.playingSurface = playingSurfaceFromString(row.surface);
+    info.league = leagueFromString(row.league);
+    info.dateOpened = row.dateOpened;
+    info.openedDay = epochDayFromString(row.dateOpened);
+    info.distanceToCenter = row.centerField;
+    info.setBallparkTypology(row.typology);
+    info.roofType = roofTypeFromString(row.roof);
+    return info;
+}
+
+} // namespace
 
 Database::Database(QObject *parent)
     : QObject(parent)
 {
-    db = QSqlDatabase::addDatabase("QSQLITE");
-    db.setDatabaseName(":memory:"); // Use in-memory database for this application
+    // Use in-memory database for this application; the pool's default
+}
+
+Database::Database(const QString &fileName, QObject *parent)
+    : QObject(parent)
+    , pool(fileName)
+{
 }
 
 Database::~Database()
 {
-    if (db.isOpen()) {
-        db.close();
+    if (writeQueue) {
+        if (!flushWrites()) {
+            qDebug() << "Some queued edits were not saved:" << writeQueue->failedGroups() << "group(s) failed";
+        }
+        // Journal the last commits; the window listening for failures is gone
+        blockSignals(true);
+        drainWrites();
+    }
+}
+
+QSqlDatabase Database::connection() const
+{
+    return pool.connection();
+}
+
+QSqlDatabase Database::syncedConnection()
+{
+    syncWrites();
+    return pool.connection();
+}
+
+// Barrier for SQL that must see, or be ordered after, the queued edits.
+// Worker threads only wait; the owning thread also journals or reconciles
+// what was written.
+void Database::syncWrites()
+{
+    if (!writeQueue) {
+        return;
+    }
+    writeQueue->flush();
+    if (QThread::currentThread() == thread()) {
+        drainWrites();
+    }
+}
+
+void Database::enableWriteBehind(int maxDelayMs, int maxBatch)
+{
+    if (!writeQueue) {
+        writeQueue = std::make_unique<WriteBehindQueue>([this](const QVector<JournalRecord> &records) {
+            return writeRecords(records);
+        }, maxDelayMs, maxBatch, [this](const QVector<JournalRecord> &records, bool committed) {
+            {
+                QMutexLocker locker(&writtenMutex);
+                writtenGroups.append(WrittenGroup{records, committed});
+            }
+            QMetaObject::invokeMethod(this, [this]() { drainWrites(); }, Qt::QueuedConnection);
+        });
+    }
+}
+
+// Owning thread: journals committed groups in commit order and reloads the
+// teams of failed ones from SQLite, since the map already shows their edits
+void Database::drainWrites()
+{
+    QStringList failedTeams;
+    for (;;) {
+        QVector<WrittenGroup> groups;
+        {
+            QMutexLocker locker(&writtenMutex);
+            groups.swap(writtenGroups);
+        }
+        if (groups.isEmpty()) {
+            break;
+        }
+        for (const WrittenGroup &group : groups) {
+            for (const JournalRecord &record : group.records) {
+                if (group.committed) {
+                    if (journal) {
+                        journal->append(record);
+                    }
+                    continue;
+                }
+                const QString teamName = record.type == JournalRecord::TeamUpsert
+                    ? record.team.teamName.trimmed() : record.teamName.trimmed();
+                if (!failedTeams.contains(teamName)) {
+                    failedTeams.append(teamName);
+                }
+            }
+        }
+        if (failedTeams.isEmpty()) {
+            break;
+        }
+        // Later queued edits to these teams must be in SQLite before it is re-read
+        writeQueue->flush();
+    }
+    if (!failedTeams.isEmpty()) {
+        patchStadiumMap(failedTeams);
+        emit writeFailed(failedTeams);
+    }
+}
+
+bool Database::flushWrites()
+{
+    bool ok = !writeQueue || writeQueue->flush();
+    if (!pool.isInMemory()) {
+        // With synchronous=NORMAL the last commits live only in the WAL until
+        // a checkpoint syncs it
+        QSqlQuery query(pool.connection());
+        if (!query.exec("PRAGMA wal_checkpoint(FULL)")) {
+            qDebug() << "Error checkpointing database:" << query.lastError().text();
+            ok = false;
+        }
     }
+    return ok;
 }
 
 void Database::loadStadiumMap()
 {
+    QSqlDatabase db = syncedConnection();
     QSqlQuery query(db);
     query.exec("SELECT * FROM teams");
+    QSqlQuery souvenirQuery(db);
+    souvenirQuery.prepare(souvenirQueryText);
     
     while (query.next()) {
         StadiumInfo info;
-        info.teamName = query.value("team_name").toString();
-        info.stadiumName = query.value("stadium_name").toString();
-        info.seatingCapacity = query.value("capacity").toInt();
-        info.location = query.value("location").toString();
-        info.playingSurface = query.value("surface").toString();
-        info.league = query.value("league").toString();
-        info.dateOpened = query.value("date_opened").toString();
-        info.distanceToCenter = query.value("center_field").toInt();
-        info.ballparkTypology = query.value("typology").toString();
-        info.roofType = query.value("roof").toString();
-        
-        // Load souvenirs for this team
-        QSqlQuery souvenirQuery(db);
-        souvenirQuery.prepare("SELECT item_name, price FROM souvenirs WHERE team_name = :team");
-        souvenirQuery.bindValue(":team", info.teamName);
-        souvenirQuery.exec();
-        
-        while (souvenirQuery.next()) {
-            info.souvenirs.append(qMakePair(
-                souvenirQuery.value("item_name").toString(),
-                souvenirQuery.value("price").toDouble()
-            ));
-        }
-        
+        readStadiumInfo(query, souvenirQuery, info);
+
         // Insert into our custom HashMap
         stadiumMap.insert(info.teamName, info);
     }
+    stadiumMapChanged();
+
+    StadiumMemoryStats stats = stadiumMemoryStats();
+    qDebug() << "Stadium map memory per team:" << qRound(stats.plainBytesPerTeam()) << "bytes plain,"
+             << qRound(stats.encodedBytesPerTeam()) << "bytes dictionary encoded";
+}
+
+void Database::stadiumMapChanged()
+{
+    // Derived indexes follow the map; they are rebuilt on their next use, so
+    // a burst of edits costs one rebuild
+    rangeIndexDirty = true;
+    aggregatorDirty = true;
+}
+
+void Database::refreshIndexes() const
+{
+    // Only a new or removed key thaws the map; updates keep the perfect hash
+    if (!stadiumMap.isFrozen()) {
+        stadiumMap.freeze();
+    }
+    if (rangeIndexDirty) {
+        rangeIndex.rebuild(stadiumMap);
+        rangeIndexDirty = false;
+    }
+}
+
+void Database::readStadiumInfo(const QSqlQuery &query, QSqlQuery &souvenirQuery, StadiumInfo &info)
+{
+    info.teamName = query.value("team_name").toString();
+    info.stadiumName = query.value("stadium_name").toString();
+    info.seatingCapacity = query.value("capacity").toInt();
+    info.setLocation(query.value("location").toString());
+    info.playingSurface = playingSurfaceFromString(query.value("surface").toString());
+    info.league = leagueFromString(query.value("league").toString());
+    info.dateOpened = query.value("date_opened").toString();
+    if (!query.value("opened_day").isNull()) {
+        info.openedDay = query.value("opened_day").toInt();
+    }
+    info.distanceToCenter = query.value("center_field").toInt();
+    info.setBallparkTypology(query.value("typology").toString());
+    info.roofType = roofTypeFromString(query.value("roof").toString());
+    
+    // Load souvenirs for this team
+    souvenirQuery.bindValue(":team", info.teamName);
+    souvenirQuery.exec();
+    
+    while (souvenirQuery.next()) {
+        info.souvenirs.append(qMakePair(
+            StringDictionary::souvenirNames().shared(souvenirQuery.value("item_name").toString()),
+            souvenirQuery.value("price").toDouble()
+        ));
+    }
+}
+
+StadiumMemoryStats Database::stadiumMemoryStats() const
+{
+    StadiumMemoryStats stats;
+    stadiumMap.forEach([&stats](const QString &, const StadiumInfo &info) {
+        ++stats.teams;
+        stats.plainBytes += plainStadiumInfoBytes(info);
+        stats.encodedBytes += encodedStadiumInfoBytes(info);
+    });
+    stats.dictionaryBytes = StringDictionary::locations().memoryBytes()
+                          + StringDictionary::typologies().memoryBytes()
+                          + StringDictionary::souvenirNames().memoryBytes();
+    return stats;
 }
 
 bool Database::initialize()
 {
-    if (!db.open()) {
+    QSqlDatabase db = connection();
+    if (!db.isOpen()) {
         qDebug() << "Error opening database:" << db.lastError().text();
         return false;
     }
@@ -71,7 +277,16 @@ bool Database::initialize()
     // Start a transaction for faster inserts
     db.transaction();
     
-    insertInitialData();  // This now handles both teams and souvenirs
+    // A reopened file database keeps its teams and edits; only a new one is seeded
+    QSqlQuery countQuery(db);
+    if (!countQuery.exec("SELECT COUNT(*) FROM teams") || !countQuery.next()) {
+        qDebug() << "Error counting teams:" << countQuery.lastError().text();
+        db.rollback();
+        return false;
+    }
+    if (countQuery.value(0).toInt() == 0) {
+        insertInitialData();  // This now handles both teams and souvenirs
+    }
     loadStadiumMap();     // Update the stadium map with the new data
     
     // Commit the transaction
@@ -86,6 +301,7 @@ bool Database::initialize()
 
 bool Database::createTables()
 {
+    QSqlDatabase db = connection();
     QSqlQuery query(db);
     
     // Create teams table
@@ -97,6 +313,7 @@ bool Database::createTables()
                    "surface TEXT,"
         "league TEXT,"
                    "date_opened TEXT,"
+                   "opened_day INTEGER,"
                    "center_field INTEGER,"
                    "typology TEXT,"
                    "roof TEXT)")) {
@@ -115,44 +332,75 @@ bool Database::createTables()
         return false;
     }
 
+    // Replay progress per source journal; IDs are stored as their signed
+    // 64-bit pattern
+    if (!query.exec("CREATE TABLE IF NOT EXISTS journal_progress ("
+                   "journal_id INTEGER PRIMARY KEY,"
+                   "last_sequence INTEGER NOT NULL)")) {
+        qDebug() << "Error creating journal progress table:" << query.lastError().text();
+        return false;
+    }
+
     return true;
 }
 
 void Database::insertInitialData()
 {
-    // Insert initial teams
-    insertTeam("Boston Red Sox", "Fenway Park", 37755, "Boston, MA", "Grass", 
-               "American", "1912-04-20", 390, "Jewel Box", "Open");
-               
-    insertTeam("New York Yankees", "Yankee Stadium", 47309, "Bronx, NY", "Grass",
-               "American", "2009-04-16", 408, "Retro-Modern", "Open");
-               
-    insertTeam("Los Angeles Dodgers", "Dodger Stadium", 56000, "Los Angeles, CA", "Grass",
-               "National", "1962-04-10", 395, "Modern", "Open");
-
-    // Add default souvenirs for each team
-    QStringList teams = {"Boston Red Sox", "New York Yankees", "Los Angeles Dodgers"};
-    QVector<QPair<QString, double>> defaultSouvenirs = {
-        {"Baseball cap", 19.99},
-        {"Baseball bat", 89.39},
-        {"Team pennant", 17.99},
-        {"Autographed baseball", 29.99},
-        {"Team jersey", 199.99}
+    // The defaults are compiled in (defaultdata.cpp), so there is nothing to
+    // open or parse; each table goes in with one batched statement
+    QSqlDatabase db = connection();
+    const DefaultTeamRecord *teams = DefaultData::teams();
+    const int teamCount = DefaultData::teamCount();
+    auto text = [](QStringView view) {
+        return QVariant(QString::fromRawData(view.data(), view.size()));
     };
 
-    for (const QString &team : teams) {
-        for (const auto &souvenir : defaultSouvenirs) {
-            QSqlQuery query(db);
-            query.prepare("INSERT INTO souvenirs (team_name, item_name, price) VALUES (:team, :item, :price)");
-            query.bindValue(":team", team);
-            query.bindValue(":item", souvenir.first);
-            query.bindValue(":price", souvenir.second);
-            if (!query.exec()) {
-                qDebug() << "Error adding souvenir" << souvenir.first << "for team" << team 
-                        << ":" << query.lastError().text();
-            }
+    QVariantList names, stadiums, capacities, locations, surfaces, leagues;
+    QVariantList dates, openedDays, centerFields, typologies, roofs;
+    for (int i = 0; i < teamCount; ++i) {
+        const DefaultTeamRecord &team = teams[i];
+        names << text(team.teamName);
+        stadiums << text(team.stadiumName);
+        capacities << team.capacity;
+        locations << text(team.location);
+        surfaces << text(team.surface);
+        leagues << text(team.league);
+        dates << text(team.dateOpened);
+        openedDays << (team.openedDay == StadiumInfo::UnknownDay ? QVariant() : QVariant(team.openedDay));
+        centerFields << team.centerField;
+        typologies << text(team.typology);
+        roofs << text(team.roof);
+    }
+
+    QSqlQuery query(db);
+    query.prepare("INSERT OR REPLACE INTO teams (team_name, stadium_name, capacity, location, "
+                  "surface, league, date_opened, opened_day, center_field, typology, roof) "
+                  "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    for (const QVariantList &column : {names, stadiums, capacities, locations, surfaces, leagues,
+                                       dates, openedDays, centerFields, typologies, roofs}) {
+        query.addBindValue(column);
+    }
+    if (!query.execBatch()) {
+        qDebug() << "Error inserting default teams:" << query.lastError().text();
+        return;
+    }
+
+    // Add default souvenirs for each team
+    QVariantList souvenirTeams, items, prices;
+    for (const QVariant &team : names) {
+        for (const auto &souvenir : defaultSouvenirList()) {
+            souvenirTeams << team;
+            items << souvenir.first;
+            prices << souvenir.second;
         }
     }
+    query.prepare("INSERT OR IGNORE INTO souvenirs (team_name, item_name, price) VALUES (?, ?, ?)");
+    query.addBindValue(souvenirTeams);
+    query.addBindValue(items);
+    query.addBindValue(prices);
+    if (!query.execBatch()) {
+        qDebug() << "Error adding default souvenirs:" << query.lastError().text();
+    }
 }
 
 void Database::initializeSouvenirs()
@@ -163,6 +411,7 @@ void Database::initializeSouvenirs()
 
 QSqlQuery Database::getTeamInfo(const QString &teamName)
 {
+    QSqlDatabase db = syncedConnection();
     QSqlQuery query(db);
     query.prepare(
         "SELECT team_name, stadium_name, "
@@ -183,6 +432,7 @@ QSqlQuery Database::getTeamInfo(const QString &teamName)
 
 QSqlQuery Database::getAllTeamsSortedByTeamName()
 {
+    QSqlDatabase db = syncedConnection();
     QSqlQuery query(db);
     if (!query.exec("SELECT TRIM(team_name) as team_name, TRIM(stadium_name) as stadium_name "
                    "FROM teams WHERE team_name IS NOT NULL AND team_name != '' "
@@ -194,6 +444,7 @@ QSqlQuery Database::getAllTeamsSortedByTeamName()
 
 QSqlQuery Database::getAllTeamsSortedByStadiumName()
 {
+    QSqlDatabase db = syncedConnection();
     QSqlQuery query(db);
     if (!query.exec("SELECT TRIM(team_name) as team_name, TRIM(stadium_name) as stadium_name "
                    "FROM teams WHERE stadium_name IS NOT NULL AND stadium_name != '' "
@@ -205,6 +456,7 @@ QSqlQuery Database::getAllTeamsSortedByStadiumName()
 
 QSqlQuery Database::getAmericanLeagueTeams()
 {
+    QSqlDatabase db = syncedConnection();
     QSqlQuery query(db);
     if (!query.exec("SELECT TRIM(team_name) as team_name, TRIM(stadium_name) as stadium_name "
                    "FROM teams WHERE TRIM(UPPER(league)) = 'AMERICAN' "
@@ -216,6 +468,7 @@ QSqlQuery Database::getAmericanLeagueTeams()
 
 QSqlQuery Database::getNationalLeagueTeams()
 {
+    QSqlDatabase db = syncedConnection();
     QSqlQuery query(db);
     if (!query.exec("SELECT TRIM(team_name) as team_name, TRIM(stadium_name) as stadium_name "
                    "FROM teams WHERE TRIM(UPPER(league)) = 'NATIONAL' "
@@ -227,6 +480,7 @@ QSqlQuery Database::getNationalLeagueTeams()
 
 QSqlQuery Database::getTeamsByTypology()
 {
+    QSqlDatabase db = syncedConnection();
     QSqlQuery query(db);
     if (!query.exec("SELECT TRIM(stadium_name) as stadium_name, TRIM(team_name) as team_name, "
                    "TRIM(typology) as typology FROM teams "
@@ -239,6 +493,7 @@ QSqlQuery Database::getTeamsByTypology()
 
 QSqlQuery Database::getOpenRoofTeams()
 {
+    QSqlDatabase db = syncedConnection();
     QSqlQuery query(db);
     if (!query.exec("SELECT TRIM(team_name) as team_name FROM teams "
                    "WHERE TRIM(UPPER(roof)) = 'OPEN' AND team_name IS NOT NULL "
@@ -250,11 +505,12 @@ QSqlQuery Database::getOpenRoofTeams()
 
 QSqlQuery Database::getTeamsByDateOpened()
 {
+    QSqlDatabase db = syncedConnection();
     QSqlQuery query(db);
     if (!query.exec("SELECT TRIM(stadium_name) as stadium_name, TRIM(team_name) as team_name, "
                    "TRIM(date_opened) as date_opened FROM teams "
                    "WHERE date_opened IS NOT NULL AND date_opened != '' "
-                   "ORDER BY date_opened")) {
+                   "ORDER BY opened_day, date_opened")) {
         qDebug() << "Error getting teams by date:" << query.lastError().text();
     }
     return query;
@@ -262,6 +518,7 @@ QSqlQuery Database::getTeamsByDateOpened()
 
 QSqlQuery Database::getTeamsByCapacity()
 {
+    QSqlDatabase db = syncedConnection();
     QSqlQuery query(db);
     if (!query.exec("SELECT stadium_name, team_name, capacity FROM teams ORDER BY capacity DESC")) {
         qDebug() << "Error getting teams by capacity:" << query.lastError().text();
@@ -271,6 +528,7 @@ QSqlQuery Database::getTeamsByCapacity()
 
 QSqlQuery Database::getTeamsWithGreatestCenterField()
 {
+    QSqlDatabase db = syncedConnection();
     QSqlQuery query(db);
     if (!query.exec(
         "WITH MaxDistance AS ("
@@ -291,6 +549,7 @@ QSqlQuery Database::getTeamsWithGreatestCenterField()
 
 QSqlQuery Database::getTeamsWithSmallestCenterField()
 {
+    QSqlDatabase db = syncedConnection();
     QSqlQuery query(db);
     if (!query.exec(
         "WITH MinDistance AS ("
@@ -309,41 +568,309 @@ QSqlQuery Database::getTeamsWithSmallestCenterField()
     return query;
 }
 
-bool Database::importFromCSV(const QStringList &filenames)
+bool Database::importFromCSV(const QStringList &filenames, CsvMergeRule rule, QVector<CsvFileStats> *stats)
 {
     if (filenames.isEmpty()) {
         qDebug() << "No files provided for import";
         return false;
     }
 
+    // Parse every file in parallel, then merge in list order
+    const QVector<CsvStagedFile<TeamRow>> files = CsvImport::parseTeamFiles(filenames);
+    QVector<CsvFileStats> fileStats;
+    for (const CsvStagedFile<TeamRow> &file : files) {
+        fileStats.append(file.stats);
+    }
+    qDebug() << "Parsed" << files.size() << "team file(s):";
+    CsvImport::logStats(fileStats);
+    if (stats) {
+        *stats = fileStats;
+    }
+    for (const CsvFileStats &file : fileStats) {
+        if (!file.opened) {
+            qDebug() << "Failed to import file:" << file.fileName;
+            return false;
+        }
+    }
+
+    QVector<TeamRow> merged;
+    if (!CsvImport::mergeTeams(files, rule, merged)) {
+        return false;
+    }
+
+    // Teams already in the database are kept
+    QSet<QString> existing;
+    QSqlDatabase db = syncedConnection();
+    QSqlQuery query(db);
+    query.exec("SELECT team_name FROM teams");
+    while (query.next()) {
+        existing.insert(query.value(0).toString());
+    }
+    QVector<TeamRow> rows;
+    for (const TeamRow &row : merged) {
+        if (existing.contains(row.teamName)) {
+            qDebug() << "Team already exists, skipping:" << row.teamName;
+        } else {
+            rows.append(row);
+        }
+    }
+
+    QWriteLocker transaction(&transactionLock);
     db.transaction();
+    if (!insertTeamRows(rows)) {
+        db.rollback();
+        return false;
+    }
+    if (!db.commit()) {
+        qDebug() << "Error committing data:" << db.lastError().text();
+        db.rollback();
+        return false;
+    }
 
-    bool success = true;
-    for (const QString &filename : filenames) {
-        if (!importSingleCSV(filename)) {
-            qDebug() << "Failed to import file:" << filename;
-            success = false;
-            break;
+    if (journal) {
+        for (const TeamRow &row : rows) {
+            journal->teamUpserted(row, true);
+        }
+    }
+    // Reload the stadium map after import
+    loadStadiumMap();
+    return true;
+}
+
+bool Database::parseTeamRow(const QString &line, TeamRow &row)
+{
+    QStringList fields;
+    bool inQuotes = false;
+    QString currentField;
+
+    // Custom CSV parsing to handle quoted fields
+    for (int i = 0; i < line.length(); ++i) {
+        QChar currentChar = line[i];
+
+        if (currentChar == '"') {
+            inQuotes = !inQuotes;
+        } else if (currentChar == ',' && !inQuotes) {
+            fields.append(currentField.trimmed());
+            currentField.clear();
+        } else {
+            currentField += currentChar;
         }
     }
+    // Add the last field
+    fields.append(currentField.trimmed());
 
-    if (success) {
-        if (!db.commit()) {
-            qDebug() << "Error committing data:" << db.lastError().text();
-            db.rollback();
+    // Remove quotes from fields
+    for (int i = 0; i < fields.size(); ++i) {
+        fields[i].remove('"');
+    }
+
+    if (fields.size() < 10 || fields[0].trimmed().isEmpty()) {
+        return false;
+    }
+
+    row.teamName = fields[0].trimmed();
+    row.stadiumName = fields[1].trimmed();
+
+    // Clean up capacity data
+    QString capacityStr = fields[2].trimmed();
+    capacityStr.remove(QRegularExpression("[^0-9]"));
+    row.capacity = capacityStr.toInt();
+
+    row.location = fields[3].trimmed();
+    row.surface = fields[4].trimmed();
+    row.league = fields[5].trimmed();
+
+    // Clean up date opened
+    row.dateOpened = fields[6].trimmed();
+    QRegularExpression yearRegex("\\b\\d{4}\\b");
+    auto match = yearRegex.match(row.dateOpened);
+    if (match.hasMatch()) {
+        row.dateOpened = match.captured(0);
+    }
+
+    // Clean up center field distance; feet come first, e.g. "407 feet (124 m)"
+    row.centerField = feetFromString(fields[7].trimmed());
+
+    // Validate the center field value
+    if (row.centerField <= 0 || row.centerField > 1000) { // Sanity check for reasonable values
+        row.centerField = 0;
+    }
+
+    row.typology = fields[8].trimmed();
+    row.roof = fields[9].trimmed();
+
+    // Validate and clean data
+    if (row.league.isEmpty()) row.league = "Unknown";
+    if (row.surface.isEmpty()) row.surface = "Unknown";
+    if (row.typology.isEmpty()) row.typology = "Unknown";
+    if (row.roof.isEmpty()) row.roof = "Unknown";
+
+    // Ensure capacity is valid
+    if (row.capacity <= 0) row.capacity = 0;
+    return true;
+}
+
+bool Database::insertTeamRow(const TeamRow &row)
+{
+    QSqlDatabase db = connection();
+    QSqlQuery query(db);
+    query.prepare("INSERT OR REPLACE INTO teams (team_name, stadium_name, capacity, location, "
+                 "surface, league, date_opened, opened_day, center_field, typology, roof) "
+                 "VALUES (:team, :stadium, :capacity, :location, :surface, :league, "
+                 ":opened, :openedDay, :center, :typology, :roof)");
+    
+    query.bindValue(":team", row.teamName);
+    query.bindValue(":stadium", row.stadiumName);
+    query.bindValue(":capacity", row.capacity);
+    query.bindValue(":location", row.location);
+    query.bindValue(":surface", row.surface);
+    query.bindValue(":league", row.league);
+    query.bindValue(":opened", row.dateOpened);
+    qint32 openedDay = epochDayFromString(row.dateOpened);
+    query.bindValue(":openedDay", openedDay == StadiumInfo::UnknownDay ? QVariant() : QVariant(openedDay));
+    query.bindValue(":center", row.centerField);
+    query.bindValue(":typology", row.typology);
+    query.bindValue(":roof", row.roof);
+
+    if (!query.exec()) {
+        qDebug() << "Error inserting team:" << query.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+bool Database::insertTeamRows(const QVector<TeamRow> &rows)
+{
+    // One batched statement per table, each new team with the default souvenirs
+    if (rows.isEmpty()) {
+        return true;
+    }
+    QSqlDatabase db = connection();
+    QVariantList names, stadiums, capacities, locations, surfaces, leagues;
+    QVariantList dates, openedDays, centerFields, typologies, roofs;
+    QVariantList souvenirTeams, items, prices;
+    for (const TeamRow &row : rows) {
+        names << row.teamName;
+        stadiums << row.stadiumName;
+        capacities << row.capacity;
+        locations << row.location;
+        surfaces << row.surface;
+        leagues << row.league;
+        dates << row.dateOpened;
+        qint32 openedDay = epochDayFromString(row.dateOpened);
+        openedDays << (openedDay == StadiumInfo::UnknownDay ? QVariant() : QVariant(openedDay));
+        centerFields << row.centerField;
+        typologies << row.typology;
+        roofs << row.roof;
+        for (const auto &souvenir : defaultSouvenirList()) {
+            souvenirTeams << row.teamName;
+            items << souvenir.first;
+            prices << souvenir.second;
+        }
+    }
+
+    QSqlQuery query(db);
+    query.prepare("INSERT OR REPLACE INTO teams (team_name, stadium_name, capacity, location, "
+                  "surface, league, date_opened, opened_day, center_field, typology, roof) "
+                  "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    for (const QVariantList &column : {names, stadiums, capacities, locations, surfaces, leagues,
+                                       dates, openedDays, centerFields, typologies, roofs}) {
+        query.addBindValue(column);
+    }
+    if (!query.execBatch()) {
+        qDebug() << "Error inserting teams:" << query.lastError().text();
+        return false;
+    }
+
+    query.prepare("INSERT OR IGNORE INTO souvenirs (team_name, item_name, price) VALUES (?, ?, ?)");
+    query.addBindValue(souvenirTeams);
+    query.addBindValue(items);
+    query.addBindValue(prices);
+    if (!query.execBatch()) {
+        qDebug() << "Error adding default souvenirs:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool Database::insertDefaultSouvenirs(const QString &teamName)
+{
+    QSqlDatabase db = connection();
+    for (const auto &souvenir : defaultSouvenirList()) {
+        QSqlQuery souvenirQuery(db);
+        souvenirQuery.prepare(
+            "INSERT INTO souvenirs (team_name, item_name, price) "
+            "VALUES (:team, :item, :price)"
+        );
+        souvenirQuery.bindValue(":team", teamName);
+        souvenirQuery.bindValue(":item", souvenir.first);
+        souvenirQuery.bindValue(":price", souvenir.second);
+
+        if (!souvenirQuery.exec()) {
+            qDebug() << "Error adding souvenir" << souvenir.first
+                    << "for team" << teamName
+                    << ":" << souvenirQuery.lastError().text();
             return false;
         }
-        // Reload the stadium map after import
-        loadStadiumMap();
-    } else {
-        db.rollback();
+        qDebug() << "Added souvenir" << souvenir.first << "for team" << teamName;
     }
+    return true;
+}
+
+bool Database::teamExists(const QString &teamName)
+{
+    QSqlDatabase db = connection();
+    QSqlQuery checkQuery(db);
+    checkQuery.prepare("SELECT COUNT(*) FROM teams WHERE team_name = :team");
+    checkQuery.bindValue(":team", teamName);
+    checkQuery.exec();
+    checkQuery.next();
+    return checkQuery.value(0).toInt() > 0;
+}
+
+bool Database::souvenirExists(const QString &teamName, const QString &itemName)
+{
+    QSqlDatabase db = connection();
+    QSqlQuery checkQuery(db);
+    checkQuery.prepare("SELECT COUNT(*) FROM souvenirs WHERE team_name = :team AND item_name = :item");
+    checkQuery.bindValue(":team", teamName);
+    checkQuery.bindValue(":item", itemName);
+    checkQuery.exec();
+    checkQuery.next();
+    return checkQuery.value(0).toInt() > 0;
+}
+
+quint64 Database::journalProgress(quint64 journalId)
+{
+    QSqlDatabase db = connection();
+    QSqlQuery query(db);
+    query.prepare("SELECT last_sequence FROM journal_progress WHERE journal_id = :id");
+    query.bindValue(":id", qint64(journalId));
+    if (!query.exec()) {
+        qDebug() << "Error reading journal progress:" << query.lastError().text();
+        return 0;
+    }
+    return query.next() ? quint64(query.value(0).toLongLong()) : 0;
+}
 
-    return success;
+bool Database::setJournalProgress(quint64 journalId, quint64 sequence)
+{
+    QSqlDatabase db = connection();
+    QSqlQuery query(db);
+    query.prepare("INSERT OR REPLACE INTO journal_progress (journal_id, last_sequence) VALUES (:id, :sequence)");
+    query.bindValue(":id", qint64(journalId));
+    query.bindValue(":sequence", qint64(sequence));
+    if (!query.exec()) {
+        qDebug() << "Error storing journal progress:" << query.lastError().text();
+        return false;
+    }
+    return true;
 }
 
 bool Database::importSingleCSV(const QString &filename)
 {
+    syncWrites();
     QFile file(filename);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         qDebug() << "Error opening file:" << file.errorString();
@@ -356,146 +883,32 @@ bool Database::importSingleCSV(const QString &filename)
         in.readLine();
     }
 
-    // Default souvenirs that each team should have
-    QVector<QPair<QString, double>> defaultSouvenirs = {
-        {"Baseball cap", 19.99},
-        {"Baseball bat", 89.39},
-        {"Team pennant", 17.99},
-        {"Autographed baseball", 29.99},
-        {"Team jersey", 199.99}
-    };
-
     while (!in.atEnd()) {
-        QString line = in.readLine();
-        QStringList fields;
-        bool inQuotes = false;
-        QString currentField;
-        
-        // Custom CSV parsing to handle quoted fields
-        for (int i = 0; i < line.length(); ++i) {
-            QChar currentChar = line[i];
-            
-            if (currentChar == '"') {
-                inQuotes = !inQuotes;
-            } else if (currentChar == ',' && !inQuotes) {
-                fields.append(currentField.trimmed());
-                currentField.clear();
-            } else {
-                currentField += currentChar;
-            }
-        }
-        // Add the last field
-        fields.append(currentField.trimmed());
-        
-        // Remove quotes from fields
-        for (int i = 0; i < fields.size(); ++i) {
-            fields[i].remove('"');
-        }
-        
-        if (fields.size() >= 10) {
-            QString teamName = fields[0].trimmed();
-            
-            // Skip empty team names
-            if (teamName.isEmpty()) {
+        TeamRow row;
+        if (!parseTeamRow(in.readLine(), row)) {
             continue;
         }
 
-        // Check if team already exists
-            QSqlQuery checkQuery(db);
-            checkQuery.prepare("SELECT COUNT(*) FROM teams WHERE team_name = :team");
-            checkQuery.bindValue(":team", teamName);
-        checkQuery.exec();
-            checkQuery.next();
-            bool teamExists = checkQuery.value(0).toInt() > 0;
-
-            // If team exists, skip it
-            if (teamExists) {
-                qDebug() << "Team already exists, skipping:" << teamName;
-                continue;
-            }
+        // If team exists, skip it
+        if (teamExists(row.teamName)) {
+            qDebug() << "Team already exists, skipping:" << row.teamName;
+            continue;
+        }
 
-            QString stadiumName = fields[1].trimmed();
-            
-            // Clean up capacity data
-            QString capacityStr = fields[2].trimmed();
-            capacityStr.remove(QRegularExpression("[^0-9]"));
-            int capacity = capacityStr.toInt();
-            
-            QString location = fields[3].trimmed();
-            QString surface = fields[4].trimmed();
-            QString league = fields[5].trimmed();
-            
-            // Clean up date opened
-            QString dateOpened = fields[6].trimmed();
-            QRegularExpression yearRegex("\\b\\d{4}\\b");
-            auto match = yearRegex.match(dateOpened);
-            if (match.hasMatch()) {
-                dateOpened = match.captured(0);
-            }
-            
-            // Clean up center field distance
-            QString centerFieldStr = fields[7].trimmed();
-            // Extract just the feet value (before any parentheses)
-            QRegularExpression feetRegex("(\\d+)\\s*(?:feet|$)");
-            auto feetMatch = feetRegex.match(centerFieldStr);
-            int centerField = 0;
-            if (feetMatch.hasMatch()) {
-                centerField = feetMatch.captured(1).toInt();
-        } else {
-                // If no "feet" found, try to extract just the first number
-                QRegularExpression numberRegex("\\d+");
-                auto numberMatch = numberRegex.match(centerFieldStr);
-                if (numberMatch.hasMatch()) {
-                    centerField = numberMatch.captured(0).toInt();
-                }
-            }
-            
-            // Validate the center field value
-            if (centerField <= 0 || centerField > 1000) { // Sanity check for reasonable values
-                centerField = 0;
-            }
-            
-            QString typology = fields[8].trimmed();
-            QString roof = fields[9].trimmed();
-
-            // Validate and clean data
-            if (league.isEmpty()) league = "Unknown";
-            if (surface.isEmpty()) surface = "Unknown";
-            if (typology.isEmpty()) typology = "Unknown";
-            if (roof.isEmpty()) roof = "Unknown";
-            
-            // Ensure capacity and center field are valid
-            if (capacity <= 0) capacity = 0;
-            if (centerField <= 0) centerField = 0;
-
-            qDebug() << "Inserting team:" << teamName;
-            if (!insertTeam(teamName, stadiumName, capacity, location, surface,
-                          league, dateOpened, centerField, typology, roof)) {
-                qDebug() << "Error inserting team:" << teamName;
-                file.close();
-                return false;
-            }
+        qDebug() << "Inserting team:" << row.teamName;
+        if (!insertTeamRow(row)) {
+            qDebug() << "Error inserting team:" << row.teamName;
+            file.close();
+            return false;
+        }
 
-            // Add default souvenirs for this team
-            for (const auto &souvenir : defaultSouvenirs) {
-                QSqlQuery souvenirQuery(db);
-                souvenirQuery.prepare(
-                    "INSERT INTO souvenirs (team_name, item_name, price) "
-                    "VALUES (:team, :item, :price)"
-                );
-                souvenirQuery.bindValue(":team", teamName);
-                souvenirQuery.bindValue(":item", souvenir.first);
-                souvenirQuery.bindValue(":price", souvenir.second);
-                
-                if (!souvenirQuery.exec()) {
-                    qDebug() << "Error adding souvenir" << souvenir.first 
-                            << "for team" << teamName 
-                            << ":" << souvenirQuery.lastError().text();
-                    file.close();
-                    return false;
-                }
-                qDebug() << "Added souvenir" << souvenir.first << "for team" << teamName;
-            }
+        // Add default souvenirs for this team
+        if (!insertDefaultSouvenirs(row.teamName)) {
+            file.close();
+            return false;
+        }
+        if (journal) {
+            journal->teamUpserted(row, true);
         }
     }
 
@@ -508,34 +921,50 @@ bool Database::insertTeam(const QString &teamName, const QString &stadiumName,
                          const QString &league, const QString &dateOpened,
                          int centerField, const QString &typology, const QString &roof)
 {
-    QSqlQuery query(db);
-    query.prepare("INSERT OR REPLACE INTO teams (team_name, stadium_name, capacity, location, "
-                 "surface, league, date_opened, center_field, typology, roof) "
-                 "VALUES (:team, :stadium, :capacity, :location, :surface, :league, "
-                 ":opened, :center, :typology, :roof)");
-    
-    query.bindValue(":team", teamName);
-    query.bindValue(":stadium", stadiumName);
-    query.bindValue(":capacity", capacity);
-    query.bindValue(":location", location);
-    query.bindValue(":surface", surface);
-    query.bindValue(":league", league);
-    query.bindValue(":opened", dateOpened);
-    query.bindValue(":center", centerField);
-    query.bindValue(":typology", typology);
-    query.bindValue(":roof", roof);
+    TeamRow row;
+    row.teamName = teamName;
+    row.stadiumName = stadiumName;
+    row.capacity = capacity;
+    row.location = location;
+    row.surface = surface;
+    row.league = league;
+    row.dateOpened = dateOpened;
+    row.centerField = centerField;
+    row.typology = typology;
+    row.roof = roof;
+    return insertTeams({row});
+}
 
-    if (!query.exec()) {
-        qDebug() << "Error inserting team:" << query.lastError().text();
-        return false;
+bool Database::insertTeams(const QVector<TeamRow> &rows)
+{
+    QVector<JournalRecord> records;
+    for (const TeamRow &row : rows) {
+        JournalRecord record;
+        record.type = JournalRecord::TeamUpsert;
+        record.team = row;
+        records.append(record);
     }
-
-    return true;
+    return submit(records);
 }
 
 QVector<QPair<QString, double>> Database::getSouvenirs(const QString &teamName)
 {
     QVector<QPair<QString, double>> souvenirs;
+    if (writeQueue && QThread::currentThread() == thread()) {
+        // The map already holds the queued edits; same order as the query
+        if (const StadiumInfo *info = stadiumMap.find(teamName.trimmed())) {
+            souvenirs = info->souvenirs;
+            std::sort(souvenirs.begin(), souvenirs.end(), [](const auto &a, const auto &b) {
+                return a.first < b.first;
+            });
+        }
+        return souvenirs;
+    }
+
+    // Shared-cache connections read uncommitted rows; wait out any write
+    // transaction so a group that later rolls back is never seen
+    QSqlDatabase db = syncedConnection();
+    QReadLocker transaction(&transactionLock);
     
     QSqlQuery query(db);
     query.prepare(
@@ -564,62 +993,229 @@ QVector<QPair<QString, double>> Database::getSouvenirs(const QString &teamName)
 
 bool Database::addSouvenir(const QString &teamName, const QString &itemName, double price)
 {
-    QSqlQuery query(db);
-    query.prepare(
-        "INSERT INTO souvenirs (team_name, item_name, price) "
-        "VALUES (:team_name, :item_name, :price)"
-    );
-    query.bindValue(":team_name", teamName);
-    query.bindValue(":item_name", itemName);
-    query.bindValue(":price", price);
-    
-    if (!query.exec()) {
-        qDebug() << "Error adding souvenir:" << query.lastError().text();
-        return false;
+    JournalRecord record;
+    record.type = JournalRecord::SouvenirAdd;
+    record.teamName = teamName;
+    record.itemName = itemName;
+    record.value = price;
+    return submit({record});
+}
+
+bool Database::updateSouvenirPrice(const QString &teamName, const QString &itemName, double newPrice)
+{
+    JournalRecord record;
+    record.type = JournalRecord::SouvenirUpdate;
+    record.teamName = teamName;
+    record.itemName = itemName;
+    record.value = newPrice;
+    return submit({record});
+}
+
+bool Database::deleteSouvenir(const QString &teamName, const QString &itemName)
+{
+    JournalRecord record;
+    record.type = JournalRecord::SouvenirDelete;
+    record.teamName = teamName;
+    record.itemName = itemName;
+    return submit({record});
+}
+
+bool Database::submit(const QVector<JournalRecord> &records)
+{
+    bool queueable = writeQueue != nullptr;
+    for (const JournalRecord &record : records) {
+        queueable = queueable && (record.type == JournalRecord::TeamUpsert
+                                  || stadiumMap.find(record.teamName.trimmed()));
+    }
+
+    if (queueable) {
+        // The map changes now and the writer thread commits later. Souvenir
+        // edits are submitted one at a time, so a miss leaves nothing applied.
+        for (const JournalRecord &record : records) {
+            if (!applyToMap(record)) {
+                return false;
+            }
+        }
+        writeQueue->enqueue(records);
+    } else {
+        QSqlDatabase db = syncedConnection();
+        QWriteLocker transaction(&transactionLock);
+        const bool grouped = records.size() > 1;
+        if (grouped) {
+            db.transaction();
+        }
+        for (const JournalRecord &record : records) {
+            if (!writeRecord(record)) {
+                if (grouped) {
+                    db.rollback();
+                }
+                return false;
+            }
+        }
+        if (grouped && !db.commit()) {
+            qDebug() << "Error committing edits:" << db.lastError().text();
+            db.rollback();
+            return false;
+        }
+        for (const JournalRecord &record : records) {
+            applyToMap(record);
+        }
+        if (journal) {
+            for (const JournalRecord &record : records) {
+                journal->append(record);
+            }
+        }
+    }
+
+    for (const JournalRecord &record : records) {
+        if (record.type == JournalRecord::TeamUpsert) {
+            stadiumMapChanged();
+            break;
+        }
     }
     return true;
 }
 
-bool Database::updateSouvenirPrice(const QString &teamName, const QString &itemName, double newPrice)
+bool Database::applyToMap(const JournalRecord &record)
 {
-    QSqlQuery query(db);
-    query.prepare(
-        "UPDATE souvenirs "
-        "SET price = :price "
-        "WHERE TRIM(team_name) = TRIM(:team_name) "
-        "AND TRIM(item_name) = TRIM(:item_name)"
-    );
-    query.bindValue(":team_name", teamName);
-    query.bindValue(":item_name", itemName);
-    query.bindValue(":price", newPrice);
-    
-    if (!query.exec()) {
-        qDebug() << "Error updating souvenir price:" << query.lastError().text();
+    if (record.type == JournalRecord::TeamUpsert) {
+        StadiumInfo info = stadiumInfoFromRow(record.team);
+        if (const StadiumInfo *existing = stadiumMap.find(info.teamName)) {
+            info.souvenirs = existing->souvenirs;
+        } else if (record.withDefaultSouvenirs) {
+            info.souvenirs = defaultSouvenirList();
+        }
+        stadiumMap.insert(info.teamName, info);
+        return true;
+    }
+
+    StadiumInfo *info = stadiumMap.find(record.teamName.trimmed());
+    if (!info) {
         return false;
     }
-    return query.numRowsAffected() > 0;
+    bool matched = false;
+    if (record.type == JournalRecord::SouvenirAdd) {
+        // (team_name, item_name) is the souvenirs primary key
+        for (const auto &souvenir : info->souvenirs) {
+            if (souvenir.first == record.itemName) {
+                return false;
+            }
+        }
+        info->souvenirs.append(qMakePair(StringDictionary::souvenirNames().shared(record.itemName),
+                                         record.value));
+        matched = true;
+    } else if (record.type == JournalRecord::SouvenirUpdate || record.type == JournalRecord::SouvenirDelete) {
+        // Same TRIM() matching as the SQL statements
+        const QString itemName = record.itemName.trimmed();
+        for (int i = info->souvenirs.size() - 1; i >= 0; --i) {
+            if (info->souvenirs[i].first.trimmed() != itemName) {
+                continue;
+            }
+            if (record.type == JournalRecord::SouvenirUpdate) {
+                info->souvenirs[i].second = record.value;
+            } else {
+                info->souvenirs.removeAt(i);
+            }
+            matched = true;
+        }
+    }
+    if (matched) {
+        aggregatorDirty = true;
+    }
+    return matched;
 }
 
-bool Database::deleteSouvenir(const QString &teamName, const QString &itemName)
+bool Database::writeRecord(const JournalRecord &record)
 {
-    QSqlQuery query(db);
-    query.prepare(
-        "DELETE FROM souvenirs "
-        "WHERE TRIM(team_name) = TRIM(:team_name) "
-        "AND TRIM(item_name) = TRIM(:item_name)"
-    );
-    query.bindValue(":team_name", teamName);
-    query.bindValue(":item_name", itemName);
-    
-    if (!query.exec()) {
-        qDebug() << "Error deleting souvenir:" << query.lastError().text();
+    QSqlDatabase db = connection();
+    switch (record.type) {
+    case JournalRecord::TeamUpsert: {
+        bool isNew = record.withDefaultSouvenirs && !teamExists(record.team.teamName);
+        return insertTeamRow(record.team) && (!isNew || insertDefaultSouvenirs(record.team.teamName));
+    }
+    case JournalRecord::TeamDelete:
+        return deleteTeamRows(record.teamName);
+    case JournalRecord::SouvenirAdd: {
+        QSqlQuery query(db);
+        query.prepare(
+            "INSERT INTO souvenirs (team_name, item_name, price) "
+            "VALUES (:team_name, :item_name, :price)"
+        );
+        query.bindValue(":team_name", record.teamName);
+        query.bindValue(":item_name", record.itemName);
+        query.bindValue(":price", record.value);
+
+        if (!query.exec()) {
+            qDebug() << "Error adding souvenir:" << query.lastError().text();
+            return false;
+        }
+        return true;
+    }
+    case JournalRecord::SouvenirUpdate: {
+        QSqlQuery query(db);
+        query.prepare(
+            "UPDATE souvenirs "
+            "SET price = :price "
+            "WHERE TRIM(team_name) = TRIM(:team_name) "
+            "AND TRIM(item_name) = TRIM(:item_name)"
+        );
+        query.bindValue(":team_name", record.teamName);
+        query.bindValue(":item_name", record.itemName);
+        query.bindValue(":price", record.value);
+
+        if (!query.exec()) {
+            qDebug() << "Error updating souvenir price:" << query.lastError().text();
+            return false;
+        }
+        return query.numRowsAffected() > 0;
+    }
+    case JournalRecord::SouvenirDelete: {
+        QSqlQuery query(db);
+        query.prepare(
+            "DELETE FROM souvenirs "
+            "WHERE TRIM(team_name) = TRIM(:team_name) "
+            "AND TRIM(item_name) = TRIM(:item_name)"
+        );
+        query.bindValue(":team_name", record.teamName);
+        query.bindValue(":item_name", record.itemName);
+
+        if (!query.exec()) {
+            qDebug() << "Error deleting souvenir:" << query.lastError().text();
+            return false;
+        }
+        return query.numRowsAffected() > 0;
+    }
+    default:
+        return false;
+    }
+}
+
+bool Database::writeRecords(const QVector<JournalRecord> &records)
+{
+    QSqlDatabase db = connection();
+    QWriteLocker transaction(&transactionLock);
+    db.transaction();
+    for (const JournalRecord &record : records) {
+        // Updates and deletes already matched in the map; no matching row
+        // here is not worth losing the rest of the batch over
+        const bool optional = record.type == JournalRecord::SouvenirUpdate
+                              || record.type == JournalRecord::SouvenirDelete;
+        if (!writeRecord(record) && !optional) {
+            db.rollback();
+            return false;
+        }
+    }
+    if (!db.commit()) {
+        qDebug() << "Error committing queued edits:" << db.lastError().text();
+        db.rollback();
         return false;
     }
-    return query.numRowsAffected() > 0;
+    return true;
 }
 
 StadiumInfo Database::getStadiumInfo(const QString &teamName) const
 {
+    refreshIndexes();
     StadiumInfo info;
     if (!stadiumMap.get(teamName, info)) {
         qDebug() << "Team not found:" << teamName;
@@ -627,6 +1223,228 @@ StadiumInfo Database::getStadiumInfo(const QString &teamName) const
     return info;
 }
 
+QVector<StadiumInfo> Database::getStadiumsOpenedBetween(const QDate &from, const QDate &to) const
+{
+    refreshIndexes();
+    return stadiumsForTeams(rangeIndex.teamsInRange(StadiumRangeIndex::OpenedDay,
+                                                    epochDayFromDate(from), epochDayFromDate(to)));
+}
+
+QVector<StadiumInfo> Database::getStadiumsByCapacity(int minCapacity, int maxCapacity) const
+{
+    refreshIndexes();
+    return stadiumsForTeams(rangeIndex.teamsInRange(StadiumRangeIndex::Capacity, minCapacity, maxCapacity));
+}
+
+QVector<StadiumInfo> Database::getStadiumsByCenterField(int minFeet, int maxFeet) const
+{
+    refreshIndexes();
+    return stadiumsForTeams(rangeIndex.teamsInRange(StadiumRangeIndex::CenterField, minFeet, maxFeet));
+}
+
+QVector<StadiumInfo> Database::getStadiumsOpenedBetweenWithCapacity(const QDate &from, const QDate &to,
+                                                                    int minCapacity, int maxCapacity) const
+{
+    refreshIndexes();
+    QVector<StadiumRangeIndex::Range> ranges = {
+        {StadiumRangeIndex::OpenedDay, epochDayFromDate(from), epochDayFromDate(to)},
+        {StadiumRangeIndex::Capacity, minCapacity, maxCapacity}
+    };
+    return stadiumsForTeams(rangeIndex.teamsMatching(ranges));
+}
+
+bool Database::applyTeamDiff(const QVector<TeamRow> &upserts, const QStringList &deletedTeams)
+{
+    QSqlDatabase db = syncedConnection();
+    if (upserts.isEmpty() && deletedTeams.isEmpty()) {
+        return true;
+    }
+
+    QWriteLocker transaction(&transactionLock);
+    db.transaction();
+    QStringList changedTeams;
+    for (const TeamRow &row : upserts) {
+        // INSERT OR REPLACE keeps the team's souvenirs; new teams get the defaults
+        bool isNew = !teamExists(row.teamName);
+        if (!insertTeamRow(row) || (isNew && !insertDefaultSouvenirs(row.teamName))) {
+            db.rollback();
+            return false;
+        }
+        changedTeams << row.teamName;
+    }
+    for (const QString &teamName : deletedTeams) {
+        if (!deleteTeamRows(teamName)) {
+            db.rollback();
+            return false;
+        }
+    }
+    if (!db.commit()) {
+        qDebug() << "Error committing team diff:" << db.lastError().text();
+        db.rollback();
+        return false;
+    }
+
+    if (journal) {
+        for (const TeamRow &row : upserts) {
+            journal->teamUpserted(row, true);
+        }
+        for (const QString &teamName : deletedTeams) {
+            journal->teamDeleted(teamName);
+        }
+    }
+
+    // Patch only the touched entries of the map
+    patchStadiumMap(changedTeams + deletedTeams);
+    return true;
+}
+
+bool Database::deleteTeamRows(const QString &teamName)
+{
+    QSqlDatabase db = connection();
+    QSqlQuery query(db);
+    query.prepare("DELETE FROM souvenirs WHERE team_name = :team");
+    query.bindValue(":team", teamName);
+    bool ok = query.exec();
+    if (ok) {
+        query.prepare("DELETE FROM teams WHERE team_name = :team");
+        query.bindValue(":team", teamName);
+        ok = query.exec();
+    }
+    if (!ok) {
+        qDebug() << "Error deleting team" << teamName << ":" << query.lastError().text();
+    }
+    return ok;
+}
+
+void Database::patchStadiumMap(const QStringList &teamNames)
+{
+    QSqlDatabase db = connection();
+    QSqlQuery souvenirQuery(db);
+    souvenirQuery.prepare(souvenirQueryText);
+    // Re-read each team from SQL; teams no longer in the table leave the map
+    for (const QString &teamName : teamNames) {
+        QSqlQuery query(db);
+        query.prepare("SELECT * FROM teams WHERE team_name = :team");
+        query.bindValue(":team", teamName);
+        if (query.exec() && query.next()) {
+            StadiumInfo info;
+            readStadiumInfo(query, souvenirQuery, info);
+            stadiumMap.insert(info.teamName, info);
+        } else {
+            stadiumMap.remove(teamName);
+        }
+    }
+    stadiumMapChanged();
+}
+
+bool Database::applyJournalRecords(quint64 journalId, const QVector<JournalRecord> &records)
+{
+    if (records.isEmpty()) {
+        return true;
+    }
+    QSqlDatabase db = syncedConnection();
+    QSet<QString> touched;
+    bool touchedAll = false;
+
+    QWriteLocker transaction(&transactionLock);
+    db.transaction();
+    // Read inside the transaction, so a group is applied at most once even
+    // when the caller's idea of the progress is stale
+    const quint64 applied = journalProgress(journalId);
+    for (const JournalRecord &record : records) {
+        if (record.sequence <= applied) {
+            continue;
+        }
+        bool ok = true;
+        switch (record.type) {
+        case JournalRecord::TeamUpsert:
+            ok = writeRecord(record);
+            touched.insert(record.team.teamName);
+            break;
+        case JournalRecord::TeamDelete:
+            ok = writeRecord(record);
+            touched.insert(record.teamName);
+            break;
+        case JournalRecord::SouvenirAdd:
+            // Already there: the record was applied before (or the souvenir
+            // was added here too); inserting again would fail the group
+            if (!souvenirExists(record.teamName, record.itemName)) {
+                ok = writeRecord(record);
+                touched.insert(record.teamName);
+            }
+            break;
+        case JournalRecord::SouvenirUpdate:
+        case JournalRecord::SouvenirDelete: {
+            // A row missing here is a no-op on this kiosk, not a failed replay
+            bool changed = writeRecord(record);
+            if (!changed) {
+                qDebug() << "Journal record" << record.sequence << "matched no souvenir:"
+                         << record.teamName << record.itemName;
+            }
+            touched.insert(record.teamName);
+            break;
+        }
+        case JournalRecord::SouvenirBulkUpdate: {
+            BulkUpdateResult result;
+            ok = applyBulkPriceUpdate(record.priceUpdate, result);
+            // Teams match with TRIM(), so the map keys may be spelled differently
+            touchedAll = true;
+            break;
+        }
+        default:
+            break;
+        }
+        if (!ok) {
+            qDebug() << "Error applying journal record" << record.sequence;
+            db.rollback();
+            return false;
+        }
+    }
+    if (records.last().sequence > applied && !setJournalProgress(journalId, records.last().sequence)) {
+        db.rollback();
+        return false;
+    }
+    if (!db.commit()) {
+        qDebug() << "Error committing journal group:" << db.lastError().text();
+        db.rollback();
+        return false;
+    }
+
+    if (touchedAll) {
+        stadiumMap.forEach([&touched](const QString &teamName, const StadiumInfo &) {
+            touched.insert(teamName);
+        });
+    }
+    if (!touched.isEmpty()) {
+        patchStadiumMap(touched.values());
+    }
+    return true;
+}
+
+QVector<AggregateRow> Database::aggregateStadiums(StadiumAggregator::GroupBy groupBy,
+                                                 StadiumAggregator::Measure measure) const
+{
+    // The columnar copy is rebuilt lazily after the map changes
+    if (aggregatorDirty) {
+        aggregator.rebuild(stadiumMap);
+        aggregatorDirty = false;
+    }
+    return aggregator.aggregate(groupBy, measure);
+}
+
+QVector<StadiumInfo> Database::stadiumsForTeams(const QStringList &teamNames) const
+{
+    QVector<StadiumInfo> stadiums;
+    stadiums.reserve(teamNames.size());
+    for (const QString &teamName : teamNames) {
+        StadiumInfo info;
+        if (stadiumMap.get(teamName, info)) {
+            stadiums.append(info);
+        }
+    }
+    return stadiums;
+}
+
 QVector<StadiumInfo> Database::getAllStadiums() const
 {
     QVector<StadiumInfo> stadiums;
@@ -637,23 +1455,158 @@ QVector<StadiumInfo> Database::getAllStadiums() const
     return stadiums;
 }
 
+QVector<QString> Database::stadiumNames() const
+{
+    QVector<QString> names;
+    stadiumMap.forEach([&names](const QString &, const StadiumInfo &info) {
+        names.append(info.stadiumName);
+    });
+    return names;
+}
+
 bool Database::updateSouvenirInMap(const QString &teamName, const QString &itemName, double newPrice)
 {
-    StadiumInfo info;
-    if (!stadiumMap.get(teamName, info)) {
+    StadiumInfo *info = stadiumMap.find(teamName);
+    if (!info) {
         return false;
     }
     
-    for (auto &souvenir : info.souvenirs) {
+    for (auto &souvenir : info->souvenirs) {
         if (souvenir.first == itemName) {
             souvenir.second = newPrice;
-            stadiumMap.insert(teamName, info);  // Update the map
+            aggregatorDirty = true;
             return true;
         }
     }
     return false;
 }
 
+BulkUpdateResult Database::bulkUpdateSouvenirPrices(const SouvenirPriceUpdate &update)
+{
+    return bulkUpdateSouvenirPrices(QVector<SouvenirPriceUpdate>{update}).first();
+}
+
+QVector<BulkUpdateResult> Database::bulkUpdateSouvenirPrices(const QVector<SouvenirPriceUpdate> &updates)
+{
+    QSqlDatabase db = syncedConnection();
+    QVector<BulkUpdateResult> results(updates.size());
+    if (updates.isEmpty()) {
+        return results;
+    }
+
+    // All operations share one transaction; the map is only patched once it commits
+    QWriteLocker transaction(&transactionLock);
+    db.transaction();
+    for (int i = 0; i < updates.size(); ++i) {
+        if (!applyBulkPriceUpdate(updates[i], results[i])) {
+            db.rollback();
+            for (auto &result : results) {
+                result.success = false;
+                result.mapEntriesPatched = 0;
+            }
+            return results;
+        }
+    }
+    if (!db.commit()) {
+        qDebug() << "Error committing bulk price update:" << db.lastError().text();
+        db.rollback();
+        for (auto &result : results) {
+            result.success = false;
+        }
+        return results;
+    }
+
+    if (journal) {
+        for (const SouvenirPriceUpdate &update : updates) {
+            journal->souvenirPricesUpdated(update);
+        }
+    }
+
+    // Apply the same deltas to the in-memory map in place, without reloading
+    for (int i = 0; i < updates.size(); ++i) {
+        const SouvenirPriceUpdate &update = updates[i];
+        const double factor = 1.0 + update.percentChange / 100.0;
+        QSet<QString> teams;
+        for (const QString &teamName : update.teams) {
+            teams.insert(teamName.trimmed());
+        }
+        const QString itemName = update.itemName.trimmed();
+        const League league = leagueFromString(update.league);
+        QElapsedTimer timer;
+        timer.start();
+        int patched = 0;
+        stadiumMap.forEach([&](const QString &teamName, StadiumInfo &info) {
+            if (!teams.isEmpty() && !teams.contains(teamName.trimmed())) {
+                return;
+            }
+            if (!update.league.isEmpty() && info.league != league) {
+                return;
+            }
+            for (auto &souvenir : info.souvenirs) {
+                if (itemName.isEmpty() || souvenir.first.trimmed() == itemName) {
+                    souvenir.second = std::round((souvenir.second * factor + update.amountChange) * 100.0) / 100.0;
+                    ++patched;
+                }
+            }
+        });
+        results[i].mapEntriesPatched = patched;
+        aggregatorDirty = aggregatorDirty || patched > 0;
+        results[i].mapMicros = timer.nsecsElapsed() / 1000;
+        results[i].success = true;
+    }
+    return results;
+}
+
+bool Database::applyBulkPriceUpdate(const SouvenirPriceUpdate &update, BulkUpdateResult &result)
+{
+    QSqlDatabase db = connection();
+    // Build the predicate from the filters that are set, with the same TRIM()
+    // matching as the other souvenir and league queries
+    QStringList conditions;
+    if (!update.itemName.isEmpty()) {
+        conditions << "TRIM(item_name) = TRIM(:item)";
+    }
+    if (!update.league.isEmpty()) {
+        conditions << "team_name IN (SELECT team_name FROM teams WHERE TRIM(UPPER(league)) = TRIM(UPPER(:league)))";
+    }
+    if (!update.teams.isEmpty()) {
+        QStringList placeholders;
+        for (int i = 0; i < update.teams.size(); ++i) {
+            placeholders << QString("TRIM(:team%1)").arg(i);
+        }
+        conditions << "TRIM(team_name) IN (" + placeholders.join(", ") + ")";
+    }
+
+    QString sql = "UPDATE souvenirs SET price = ROUND(price * :factor + :delta, 2)";
+    if (!conditions.isEmpty()) {
+        sql += " WHERE " + conditions.join(" AND ");
+    }
+
+    QSqlQuery query(db);
+    query.prepare(sql);
+    query.bindValue(":factor", 1.0 + update.percentChange / 100.0);
+    query.bindValue(":delta", update.amountChange);
+    if (!update.itemName.isEmpty()) {
+        query.bindValue(":item", update.itemName);
+    }
+    if (!update.league.isEmpty()) {
+        query.bindValue(":league", update.league);
+    }
+    for (int i = 0; i < update.teams.size(); ++i) {
+        query.bindValue(QString(":team%1").arg(i), update.teams[i]);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    if (!query.exec()) {
+        qDebug() << "Error in bulk price update:" << query.lastError().text();
+        return false;
+    }
+    result.rowsAffected = query.numRowsAffected();
+    result.sqlMicros = timer.nsecsElapsed() / 1000;
+    return true;
+}
+
 bool Database::validateAdmin(const QString &username, const QString &password)
 {
     // For now, use a simple hardcoded admin account
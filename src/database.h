@@ -6,8 +6,54 @@
 #include <QSqlQuery>
 #include <QVector>
 #include <QPair>
+#include <QStringList>
+#include <QDate>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <climits>
+#include <memory>
 #include "stadiuminfo.h"
 #include "hashmap.h"
+#include "stadiumrangeindex.h"
+#include "stadiumaggregator.h"
+#include "connectionpool.h"
+#include "csvimport.h"
+
+class ChangeJournal;
+class WriteBehindQueue;
+struct JournalRecord;
+
+// Bulk souvenir price change. Empty filters match everything; the new price
+// is round(price * (1 + percentChange / 100) + amountChange, 2).
+struct SouvenirPriceUpdate {
+    QString itemName;
+    QString league;
+    QStringList teams;
+    double percentChange = 0.0;
+    double amountChange = 0.0;
+};
+
+// One parsed row of a team information CSV
+struct TeamRow {
+    QString teamName;
+    QString stadiumName;
+    int capacity = 0;
+    QString location;
+    QString surface;
+    QString league;
+    QString dateOpened;
+    int centerField = 0;
+    QString typology;
+    QString roof;
+};
+
+struct BulkUpdateResult {
+    bool success = false;
+    int rowsAffected = 0;       // rows changed in SQLite
+    int mapEntriesPatched = 0;  // souvenirs patched in the in-memory map
+    qint64 sqlMicros = 0;
+    qint64 mapMicros = 0;
+};
 
 class Database : public QObject
 {
@@ -15,19 +61,34 @@ class Database : public QObject
 
 public:
     explicit Database(QObject *parent = nullptr);
+    // SQLite file opened in WAL mode, so worker threads can read while the
+    // owning thread writes
+    explicit Database(const QString &fileName, QObject *parent = nullptr);
     ~Database();
 
+    // Creates the tables and loads the map; the default teams are inserted
+    // only while the teams table is empty
     bool initialize();
     bool createTables();
     void loadStadiumMap();
     void insertInitialData();
     void initializeSouvenirs();
-    bool importFromCSV(const QStringList &filenames);
+    // Parses the files in parallel and merges them in list order under rule,
+    // then inserts the new teams in one transaction; teams already in the
+    // database are kept. stats receives each file's parse throughput.
+    bool importFromCSV(const QStringList &filenames,
+                       CsvMergeRule rule = CsvMergeRule::LastFileWins,
+                       QVector<CsvFileStats> *stats = nullptr);
     bool importSingleCSV(const QString &filename);
+    static bool parseTeamRow(const QString &line, TeamRow &row);
+    // Upserts and deletes teams in one transaction, then patches only those map entries
+    bool applyTeamDiff(const QVector<TeamRow> &upserts, const QStringList &deletedTeams);
     bool insertTeam(const QString &teamName, const QString &stadiumName,
                     int capacity, const QString &location, const QString &surface,
                     const QString &league, const QString &dateOpened,
                     int centerField, const QString &typology, const QString &roof);
+    // Upserts the rows as one group: one transaction, or one queued group
+    bool insertTeams(const QVector<TeamRow> &rows);
 
     QSqlQuery getTeamInfo(const QString &teamName);
     QSqlQuery getAllTeamsSortedByTeamName();
@@ -41,27 +102,119 @@ public:
     QSqlQuery getTeamsWithGreatestCenterField();
     QSqlQuery getTeamsWithSmallestCenterField();
 
+    // Safe on worker threads: waits for queued edits and any open write
+    // transaction. The QSqlQuery getters above are for the owning thread.
     QVector<QPair<QString, double>> getSouvenirs(const QString &teamName);
     bool addSouvenir(const QString &teamName, const QString &itemName, double price);
     bool updateSouvenirPrice(const QString &teamName, const QString &itemName, double newPrice);
     bool deleteSouvenir(const QString &teamName, const QString &itemName);
     bool updateSouvenirInMap(const QString &teamName, const QString &itemName, double newPrice);
+    BulkUpdateResult bulkUpdateSouvenirPrices(const SouvenirPriceUpdate &update);
+    QVector<BulkUpdateResult> bulkUpdateSouvenirPrices(const QVector<SouvenirPriceUpdate> &updates);
 
     StadiumInfo getStadiumInfo(const QString &teamName) const;
     QVector<StadiumInfo> getAllStadiums() const;
+    // Every team's stadium name, for StadiumGraph::validate
+    QVector<QString> stadiumNames() const;
+
+    // Range queries over the typed columns, answered from the in-memory
+    // sorted indexes; bounds are inclusive and results are in key order
+    QVector<StadiumInfo> getStadiumsOpenedBetween(const QDate &from, const QDate &to) const;
+    QVector<StadiumInfo> getStadiumsByCapacity(int minCapacity, int maxCapacity = INT_MAX) const;
+    QVector<StadiumInfo> getStadiumsByCenterField(int minFeet, int maxFeet = INT_MAX) const;
+    QVector<StadiumInfo> getStadiumsOpenedBetweenWithCapacity(const QDate &from, const QDate &to,
+                                                              int minCapacity, int maxCapacity = INT_MAX) const;
+
+    // Group-by summaries (count/sum/min/max/average) over the stadium map
+    QVector<AggregateRow> aggregateStadiums(StadiumAggregator::GroupBy groupBy,
+                                            StadiumAggregator::Measure measure) const;
 
     bool validateAdmin(const QString &username, const QString &password);
 
-    QSqlDatabase& database() { return db; }
+    // The calling thread's connection, after every queued edit is committed;
+    // SQL methods may be called from any thread, but the stadium map and
+    // indexes belong to the owning thread
+    QSqlDatabase database() { return syncedConnection(); }
     void reloadStadiumData() { loadStadiumMap(); }
 
     const HashMap<QString, StadiumInfo>& getStadiumMap() const { return stadiumMap; }
+    StadiumMemoryStats stadiumMemoryStats() const;
+
+    // Mutations are appended to the journal once SQLite has committed them,
+    // when one is set
+    void setChangeJournal(ChangeJournal *journal) { this->journal = journal; }
+    ChangeJournal* changeJournal() const { return journal; }
+    // Last sequence of journalId applied to this database, 0 if none
+    quint64 journalProgress(quint64 journalId);
+    // Applies the team/souvenir records of a journal group in one transaction
+    // that also stores the group's last sequence as the journal's progress;
+    // graph records are ignored. Records at or below the stored progress are
+    // skipped and an add whose souvenir row exists is a no-op, so replaying a
+    // group twice changes nothing.
+    bool applyJournalRecords(quint64 journalId, const QVector<JournalRecord> &records);
 
     void refreshStadiumLists();
 
+    // Write-behind: insertTeam(s) and the souvenir edits change the stadium
+    // map at once and a writer thread commits them in grouped transactions,
+    // at most maxDelayMs later. Souvenir reads on the owning thread come from
+    // the map; imports, diffs, bulk updates, journal replay and the team
+    // queries wait for queued edits first. A failed group emits writeFailed.
+    void enableWriteBehind(int maxDelayMs = 50, int maxBatch = 256);
+    // Durable barrier for shutdown: commits every queued edit and, for a
+    // file database, checkpoints the WAL. False if any queued edit failed.
+    bool flushWrites();
+
+signals:
+    // A queued group was rolled back; the map entries of these teams have
+    // been reloaded from SQLite, dropping the edit
+    void writeFailed(const QStringList &teamNames);
+
 private:
-    QSqlDatabase db;
-    HashMap<QString, StadiumInfo> stadiumMap;
+    // souvenirQuery is the caller's prepared per-team souvenir SELECT, reused for every row
+    void readStadiumInfo(const QSqlQuery &query, QSqlQuery &souvenirQuery, StadiumInfo &info);
+    void stadiumMapChanged();
+    void refreshIndexes() const;
+    bool insertTeamRow(const TeamRow &row);
+    bool insertTeamRows(const QVector<TeamRow> &rows);
+    bool insertDefaultSouvenirs(const QString &teamName);
+    bool teamExists(const QString &teamName);
+    bool souvenirExists(const QString &teamName, const QString &itemName);
+    bool setJournalProgress(quint64 journalId, quint64 sequence);
+    bool deleteTeamRows(const QString &teamName);
+    void patchStadiumMap(const QStringList &teamNames);
+    bool applyBulkPriceUpdate(const SouvenirPriceUpdate &update, BulkUpdateResult &result);
+    QVector<StadiumInfo> stadiumsForTeams(const QStringList &teamNames) const;
+    bool submit(const QVector<JournalRecord> &records);
+    bool applyToMap(const JournalRecord &record);
+    bool writeRecord(const JournalRecord &record);
+    bool writeRecords(const QVector<JournalRecord> &records);
+
+    QSqlDatabase connection() const;
+    QSqlDatabase syncedConnection();
+    void syncWrites();
+    void drainWrites();
+
+    struct WrittenGroup {
+        QVector<JournalRecord> records;
+        bool committed = false;
+    };
+
+    ConnectionPool pool;
+    // Held for writing by every write transaction and for reading by
+    // getSouvenirs() off the owning thread, which would otherwise see rows
+    // that are not committed yet
+    QReadWriteLock transactionLock;
+    QMutex writtenMutex;
+    QVector<WrittenGroup> writtenGroups;  // reported by the writer thread, not yet drained
+    std::unique_ptr<WriteBehindQueue> writeQueue;  // after pool: stopped first
+    // The perfect hash and range index are rebuilt lazily, see refreshIndexes()
+    mutable HashMap<QString, StadiumInfo> stadiumMap;
+    mutable StadiumRangeIndex rangeIndex;
+    mutable bool rangeIndexDirty = true;
+    mutable StadiumAggregator aggregator;
+    mutable bool aggregatorDirty = true;
+    ChangeJournal *journal = nullptr;
 };
 
 #endif // DATABASE_H 
\ No newline at end of file
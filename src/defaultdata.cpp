@@ -0,0 +1,159 @@
+// Generated by tools/embed_defaults.py from MLB Information.csv, Distance between stadiums.csv.
+// Do not edit; regenerate with `make defaultdata` after changing the CSVs.
+
+#include "defaultdata.h"
+
+namespace {
+
+constexpr DefaultTeamRecord Teams[] = {
+    {u"Arizona Diamondbacks", u"Chase Field", u"Phoenix, Arizona", u"Grass", u"National", u"1998", u"Retro Modern", u"Retractable", 48686, 10227, 407},
+    {u"Atlanta Braves", u"SunTrust Park", u"Cumberland, Georgia", u"Grass", u"National", u"2017", u"Retro Modern", u"Open", 41149, 17167, 400},
+    {u"Baltimore Orioles", u"Oriole Park at Camden Yards", u"Baltimore, Maryland", u"Grass", u"American", u"1992", u"Retro Classic", u"Open", 45971, 8035, 410},
+    {u"Boston Red Sox", u"Fenway Park", u"Boston, Massachusetts", u"Grass", u"American", u"1912", u"Jewel Box", u"Open", 37731, -21185, 420},
+    {u"Chicago Cubs", u"Wrigley Field", u"Chicago, Illinois", u"Grass", u"National", u"1914", u"Jewel Box", u"Open", 41268, -20454, 400},
+    {u"Chicago White Sox", u"Guaranteed Rate Field", u"Chicago, Illinois", u"Grass", u"American", u"1991", u"Retro Classic", u"Open", 40615, 7670, 400},
+    {u"Cincinnati Reds", u"Great American Ball Park", u"Cincinnati, Ohio", u"Grass", u"National", u"2003", u"Retro Modern", u"Open", 42319, 12053, 404},
+    {u"Cleveland Indians", u"Progressive Field", u"Cleveland, Ohio", u"Grass", u"American", u"1994", u"Retro Modern", u"Open", 35051, 8766, 410},
+    {u"Colorado Rockies", u"Coors Field", u"Denver, Colorado", u"Grass", u"National", u"1995", u"Retro Classic", u"Open", 50398, 9131, 415},
+    {u"Detroit Tigers", u"Comerica Park", u"Detroit, Michigan", u"Grass", u"American", u"2000", u"Retro Classic", u"Open", 41299, 10957, 420},
+    {u"Houston Astros", u"Minute Maid Park", u"Houston, Texas", u"Grass", u"American", u"2000", u"Retro Modern", u"Retractable", 41168, 10957, 409},
+    {u"Kansas City Royals", u"Kauffman Stadium", u"Kansas City, Missouri", u"Grass", u"American", u"1973", u"Retro Modern", u"Open", 37903, 1096, 410},
+    {u"Los Angeles Angels", u"Angel Stadium", u"Anaheim, California", u"Grass", u"American", u"1966", u"Retro Modern", u"Open", 45477, -1461, 396},
+    {u"Los Angeles Dodgers", u"Dodger Stadium", u"Los Angeles, California", u"Grass", u"National", u"1962", u"Modern", u"Open", 56000, -2922, 400},
+    {u"Miami Marlins", u"Marlins Park", u"Miami, Florida", u"Grass", u"National", u"2012", u"Contemporary", u"Retractable", 36742, 15340, 407},
+    {u"Milwaukee Brewers", u"Miller Park", u"Milwaukee, Wisconsin", u"Grass", u"National", u"2001", u"Retro Modern", u"Retractable", 41900, 11323, 400},
+    {u"Minnesota Twins", u"Target Field", u"Minneapolis, Minnesota", u"Grass", u"American", u"2010", u"Retro Modern", u"Open", 38885, 14610, 404},
+    {u"New York Mets", u"Citi Field", u"Queens, New York", u"Grass", u"National", u"2009", u"Retro Classic", u"Open", 41922, 14245, 408},
+    {u"New York Yankees", u"Yankee Stadium", u"Bronx, New York", u"Grass", u"American", u"2009", u"Retro Classic", u"Open", 47422, 14245, 408},
+    {u"Oakland Athletics", u"Oakland\u2013Alameda County Coliseum", u"Oakland, California", u"Grass", u"American", u"1966", u"Multipurpose", u"Open", 47170, -1461, 400},
+    {u"Philadelphia Phillies", u"Citizens Bank Park", u"Philadelphia, Pennsylvania", u"Grass", u"National", u"2004", u"Retro Classic", u"Open", 43651, 12418, 401},
+    {u"Pittsburgh Pirates", u"PNC Park", u"Pittsburgh, Pennsylvania", u"Grass", u"National", u"2001", u"Retro Classic", u"Open", 38362, 11323, 399},
+    {u"San Diego Padres", u"Petco Park", u"San Diego, California", u"Grass", u"National", u"2004", u"Retro Modern", u"Open", 40209, 12418, 396},
+    {u"San Francisco Giants", u"Oracle Park", u"San Francisco, California", u"Grass", u"National", u"2000", u"Retro Classic", u"Open", 41915, 10957, 399},
+    {u"Seattle Mariners", u"Safeco Field", u"Seattle, Washington", u"Grass", u"American", u"1999", u"Retro Modern", u"Retractable", 47943, 10592, 401},
+    {u"St. Louis Cardinals", u"Busch Stadium", u"St. Louis, Missouri", u"Grass", u"National", u"2006", u"Retro Classic", u"Open", 45529, 13149, 400},
+    {u"Tampa Bay Rays", u"Tropicana Field", u"St. Petersburg, Florida", u"AstroTurf GameDay Grass", u"American", u"1990", u"Multipurpose", u"Fixed", 31042, 7305, 404},
+    {u"Texas Rangers", u"Globe Life Park in Arlington", u"Arlington, Texas", u"Grass", u"American", u"1994", u"Retro Classic", u"Open", 48114, 8766, 400},
+    {u"Toronto Blue Jays", u"Rogers Centre", u"Toronto, Ontario", u"AstroTurf GameDay Grass 3D", u"American", u"1989", u"Multipurpose", u"Retractable", 49282, 6940, 400},
+    {u"Washington Nationals", u"Nationals Park", u"Washington, D.C.", u"Grass", u"National", u"2008", u"Retro Modern", u"Open", 41339, 13879, 402},
+};
+
+constexpr DefaultDistanceRecord Distances[] = {
+    {u"angelstadium", u"petcopark", 110.0},
+    {u"angelstadium", u"dodgerstadium", 50.0},
+    {u"buschstadium", u"minutemaidpark", 680.0},
+    {u"buschstadium", u"greatamericanballpark", 310.0},
+    {u"buschstadium", u"targetfield", 465.0},
+    {u"buschstadium", u"kauffmanstadium", 235.0},
+    {u"chasefield", u"coorsfield", 580.0},
+    {u"chasefield", u"globelifeparkinarlington", 870.0},
+    {u"chasefield", u"minutemaidpark", 1115.0},
+    {u"chasefield", u"oaklandalamedacountycoliseum", 650.0},
+    {u"chasefield", u"petcopark", 300.0},
+    {u"citifield", u"fenwaypark", 195.0},
+    {u"citifield", u"yankeestadium", 50.0},
+    {u"citizensbankpark", u"yankeestadium", 80.0},
+    {u"citizensbankpark", u"orioleparkatcamdenyards", 90.0},
+    {u"comericapark", u"guaranteedratefield", 240.0},
+    {u"comericapark", u"rogerscentre", 210.0},
+    {u"comericapark", u"progressivefield", 90.0},
+    {u"coorsfield", u"kauffmanstadium", 560.0},
+    {u"coorsfield", u"globelifeparkinarlington", 650.0},
+    {u"coorsfield", u"chasefield", 580.0},
+    {u"coorsfield", u"petcopark", 830.0},
+    {u"dodgerstadium", u"angelstadium", 50.0},
+    {u"dodgerstadium", u"targetfield", 1500.0},
+    {u"dodgerstadium", u"oaklandalamedacountycoliseum", 340.0},
+    {u"fenwaypark", u"citifield", 195.0},
+    {u"fenwaypark", u"marlinspark", 1255.0},
+    {u"fenwaypark", u"rogerscentre", 430.0},
+    {u"globelifeparkinarlington", u"chasefield", 870.0},
+    {u"globelifeparkinarlington", u"kauffmanstadium", 460.0},
+    {u"globelifeparkinarlington", u"suntrustpark", 740.0},
+    {u"globelifeparkinarlington", u"minutemaidpark", 230.0},
+    {u"globelifeparkinarlington", u"coorsfield", 650.0},
+    {u"greatamericanballpark", u"pncpark", 260.0},
+    {u"greatamericanballpark", u"progressivefield", 225.0},
+    {u"greatamericanballpark", u"guaranteedratefield", 250.0},
+    {u"greatamericanballpark", u"tropicanafield", 790.0},
+    {u"greatamericanballpark", u"suntrustpark", 375.0},
+    {u"greatamericanballpark", u"buschstadium", 310.0},
+    {u"guaranteedratefield", u"comericapark", 240.0},
+    {u"guaranteedratefield", u"greatamericanballpark", 250.0},
+    {u"guaranteedratefield", u"wrigleyfield", 50.0},
+    {u"kauffmanstadium", u"buschstadium", 235.0},
+    {u"kauffmanstadium", u"globelifeparkinarlington", 460.0},
+    {u"kauffmanstadium", u"wrigleyfield", 415.0},
+    {u"kauffmanstadium", u"coorsfield", 560.0},
+    {u"marlinspark", u"suntrustpark", 600.0},
+    {u"marlinspark", u"tropicanafield", 210.0},
+    {u"marlinspark", u"nationalspark", 930.0},
+    {u"marlinspark", u"fenwaypark", 1255.0},
+    {u"marlinspark", u"minutemaidpark", 965.0},
+    {u"millerpark", u"rogerscentre", 430.0},
+    {u"millerpark", u"wrigleyfield", 80.0},
+    {u"millerpark", u"targetfield", 300.0},
+    {u"minutemaidpark", u"globelifeparkinarlington", 230.0},
+    {u"minutemaidpark", u"tropicanafield", 790.0},
+    {u"minutemaidpark", u"marlinspark", 965.0},
+    {u"minutemaidpark", u"buschstadium", 680.0},
+    {u"minutemaidpark", u"chasefield", 1115.0},
+    {u"nationalspark", u"orioleparkatcamdenyards", 50.0},
+    {u"nationalspark", u"pncpark", 195.0},
+    {u"nationalspark", u"suntrustpark", 560.0},
+    {u"nationalspark", u"marlinspark", 930.0},
+    {u"oaklandalamedacountycoliseum", u"oraclepark", 50.0},
+    {u"oaklandalamedacountycoliseum", u"dodgerstadium", 340.0},
+    {u"oaklandalamedacountycoliseum", u"chasefield", 650.0},
+    {u"oraclepark", u"safecofield", 680.0},
+    {u"oraclepark", u"oaklandalamedacountycoliseum", 50.0},
+    {u"orioleparkatcamdenyards", u"nationalspark", 50.0},
+    {u"orioleparkatcamdenyards", u"citizensbankpark", 90.0},
+    {u"petcopark", u"coorsfield", 830.0},
+    {u"petcopark", u"chasefield", 300.0},
+    {u"petcopark", u"angelstadium", 110.0},
+    {u"pncpark", u"nationalspark", 195.0},
+    {u"pncpark", u"rogerscentre", 225.0},
+    {u"pncpark", u"progressivefield", 115.0},
+    {u"pncpark", u"greatamericanballpark", 260.0},
+    {u"pncpark", u"yankeestadium", 315.0},
+    {u"progressivefield", u"pncpark", 115.0},
+    {u"progressivefield", u"comericapark", 90.0},
+    {u"progressivefield", u"greatamericanballpark", 225.0},
+    {u"rogerscentre", u"pncpark", 225.0},
+    {u"rogerscentre", u"millerpark", 430.0},
+    {u"rogerscentre", u"comericapark", 210.0},
+    {u"rogerscentre", u"fenwaypark", 430.0},
+    {u"rogerscentre", u"safecofield", 2070.0},
+    {u"safecofield", u"rogerscentre", 2070.0},
+    {u"safecofield", u"targetfield", 1390.0},
+    {u"safecofield", u"oraclepark", 680.0},
+    {u"suntrustpark", u"greatamericanballpark", 375.0},
+    {u"suntrustpark", u"nationalspark", 560.0},
+    {u"suntrustpark", u"marlinspark", 600.0},
+    {u"suntrustpark", u"globelifeparkinarlington", 740.0},
+    {u"targetfield", u"dodgerstadium", 1500.0},
+    {u"targetfield", u"buschstadium", 465.0},
+    {u"targetfield", u"millerpark", 300.0},
+    {u"targetfield", u"safecofield", 1390.0},
+    {u"tropicanafield", u"greatamericanballpark", 790.0},
+    {u"tropicanafield", u"marlinspark", 210.0},
+    {u"tropicanafield", u"minutemaidpark", 790.0},
+    {u"wrigleyfield", u"guaranteedratefield", 50.0},
+    {u"wrigleyfield", u"millerpark", 80.0},
+    {u"wrigleyfield", u"kauffmanstadium", 415.0},
+    {u"yankeestadium", u"pncpark", 315.0},
+    {u"yankeestadium", u"citizensbankpark", 80.0},
+    {u"yankeestadium", u"citifield", 50.0},
+};
+
+} // namespace
+
+namespace DefaultData {
+
+const DefaultTeamRecord *teams() { return Teams; }
+int teamCount() { return int(sizeof(Teams) / sizeof(Teams[0])); }
+const DefaultDistanceRecord *distances() { return Distances; }
+int distanceCount() { return int(sizeof(Distances) / sizeof(Distances[0])); }
+
+} // namespace DefaultData
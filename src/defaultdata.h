@@ -0,0 +1,40 @@
+#ifndef DEFAULTDATA_H
+#define DEFAULTDATA_H
+
+#include <QStringView>
+#include <QtGlobal>
+
+// Default dataset compiled into the executable. The tables live in the
+// generated src/defaultdata.cpp (tools/embed_defaults.py, `make defaultdata`)
+// and are already cleaned, so loading them needs no file access or parsing.
+struct DefaultTeamRecord {
+    QStringView teamName;
+    QStringView stadiumName;
+    QStringView location;
+    QStringView surface;
+    QStringView league;
+    QStringView dateOpened;
+    QStringView typology;
+    QStringView roof;
+    qint32 capacity;
+    qint32 openedDay;    // StadiumInfo::UnknownDay when the date has no year
+    qint32 centerField;
+};
+
+// One undirected edge between normalized stadium names
+struct DefaultDistanceRecord {
+    QStringView from;
+    QStringView to;
+    double miles;
+};
+
+namespace DefaultData {
+
+const DefaultTeamRecord *teams();
+int teamCount();
+const DefaultDistanceRecord *distances();
+int distanceCount();
+
+} // namespace DefaultData
+
+#endif // DEFAULTDATA_H
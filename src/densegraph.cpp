@@ -0,0 +1,207 @@
+#include "densegraph.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define DENSE_GRAPH_AVX2 1
+#endif
+
+namespace {
+
+const float Infinity = std::numeric_limits<float>::infinity();
+
+bool useSimd()
+{
+    static const bool supported = DenseAdjacency::hasSimdSupport();
+    return supported;
+}
+
+using GraphKernels::isDone;
+
+void relaxScalar(const float* row, int begin, int end, int u, float base, float* dist, int* previous,
+                 const quint64* done)
+{
+    for (int v = begin; v < end; ++v) {
+        const float alt = base + row[v];
+        if (alt < dist[v] && !isDone(done, v)) {
+            dist[v] = alt;
+            previous[v] = u;
+        }
+    }
+}
+
+int argMinScalar(const float* values, const quint64* done, int count)
+{
+    int best = -1;
+    float bestValue = Infinity;
+    for (int i = 0; i < count; ++i) {
+        if (values[i] < bestValue && !isDone(done, i)) {
+            bestValue = values[i];
+            best = i;
+        }
+    }
+    return best;
+}
+
+#ifdef DENSE_GRAPH_AVX2
+// Lanes of all ones for the nodes i .. i + 8 not in done; i is a multiple
+// of 8, so their bits share one byte of one word
+__attribute__((target("avx2")))
+__m256 openLanes(const quint64* done, int i)
+{
+    const __m256i laneBits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    const __m256i bits = _mm256_set1_epi32(int(done[i >> 6] >> (i & 63)) & 0xff);
+    return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(bits, laneBits), _mm256_setzero_si256()));
+}
+
+__attribute__((target("avx2")))
+void relaxAvx2(const float* row, int n, int u, float base, float* dist, int* previous, const quint64* done)
+{
+    const __m256 baseLanes = _mm256_set1_ps(base);
+    const __m256i from = _mm256_set1_epi32(u);
+    int v = 0;
+    for (; v + 8 <= n; v += 8) {
+        const __m256 alt = _mm256_add_ps(baseLanes, _mm256_loadu_ps(row + v));
+        const __m256 current = _mm256_loadu_ps(dist + v);
+        const __m256 lower = _mm256_and_ps(_mm256_cmp_ps(alt, current, _CMP_LT_OQ), openLanes(done, v));
+        if (_mm256_movemask_ps(lower) == 0) {
+            continue;
+        }
+        _mm256_storeu_ps(dist + v, _mm256_blendv_ps(current, alt, lower));
+        _mm256_maskstore_epi32(previous + v, _mm256_castps_si256(lower), from);
+    }
+    relaxScalar(row, v, n, u, base, dist, previous, done);
+}
+
+// Two passes: the minimum over open lanes, then the first open lane
+// holding it, so ties go to the lowest index as in the scalar scan
+__attribute__((target("avx2")))
+int argMinAvx2(const float* values, const quint64* done, int count)
+{
+    const __m256 infinity = _mm256_set1_ps(Infinity);
+    __m256 minimum = infinity;
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        minimum = _mm256_min_ps(minimum, _mm256_blendv_ps(infinity, _mm256_loadu_ps(values + i), openLanes(done, i)));
+    }
+    __m128 folded = _mm_min_ps(_mm256_castps256_ps128(minimum), _mm256_extractf128_ps(minimum, 1));
+    folded = _mm_min_ps(folded, _mm_movehl_ps(folded, folded));
+    folded = _mm_min_ss(folded, _mm_shuffle_ps(folded, folded, 1));
+    float best = _mm_cvtss_f32(folded);
+    for (int j = i; j < count; ++j) {
+        if (values[j] < best && !isDone(done, j)) {
+            best = values[j];
+        }
+    }
+    if (best == Infinity) {
+        return -1;
+    }
+
+    const __m256 bestLanes = _mm256_set1_ps(best);
+    for (i = 0; i + 8 <= count; i += 8) {
+        const __m256 hit = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(values + i), bestLanes, _CMP_EQ_OQ),
+                                         openLanes(done, i));
+        const int mask = _mm256_movemask_ps(hit);
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    for (; i < count; ++i) {
+        if (values[i] == best && !isDone(done, i)) {
+            return i;
+        }
+    }
+    return -1;
+}
+#endif
+
+} // namespace
+
+void DenseAdjacency::build(const QVector<int>& rowStart, const QVector<int>& targets, const QVector<double>& weights)
+{
+    n = qMax(0, int(rowStart.size()) - 1);
+    values.fill(Infinity, n * n);
+    float* cells = values.data();
+    for (int u = 0; u < n; ++u) {
+        for (int e = rowStart[u]; e < rowStart[u + 1]; ++e) {
+            if (targets[e] != u && weights[e] > 0) {
+                cells[u * n + targets[e]] = float(weights[e]);
+            }
+        }
+    }
+}
+
+void DenseAdjacency::clear()
+{
+    n = 0;
+    values.clear();
+}
+
+void DenseAdjacency::relax(int u, float base, float* dist, int* previous, const quint64* done) const
+{
+#ifdef DENSE_GRAPH_AVX2
+    if (useSimd()) {
+        relaxAvx2(row(u), n, u, base, dist, previous, done);
+        return;
+    }
+#endif
+    relaxScalar(row(u), 0, n, u, base, dist, previous, done);
+}
+
+int DenseAdjacency::nearest(int u, const quint64* done) const
+{
+    // Missing edges are infinite, so the row itself is the candidate list
+    return GraphKernels::argMin(row(u), done, n);
+}
+
+bool DenseAdjacency::hasSimdSupport()
+{
+#ifdef DENSE_GRAPH_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+void CsrAdjacency::relax(int u, float base, float* dist, int* previous, const quint64* done) const
+{
+    for (int e = rowStart[u]; e < rowStart[u + 1]; ++e) {
+        const int v = targets[e];
+        if (GraphKernels::isDone(done, v) || v == u || !(weights[e] > 0)) {
+            continue;
+        }
+        const float alt = base + float(weights[e]);
+        if (alt < dist[v]) {
+            dist[v] = alt;
+            previous[v] = u;
+        }
+    }
+}
+
+int CsrAdjacency::nearest(int u, const quint64* done) const
+{
+    // Rows are sorted by target, so a strict compare keeps the lowest ID
+    int best = -1;
+    double bestWeight = std::numeric_limits<double>::infinity();
+    for (int e = rowStart[u]; e < rowStart[u + 1]; ++e) {
+        const int v = targets[e];
+        if (!GraphKernels::isDone(done, v) && v != u && weights[e] > 0 && weights[e] < bestWeight) {
+            bestWeight = weights[e];
+            best = v;
+        }
+    }
+    return best;
+}
+
+namespace GraphKernels {
+
+int argMin(const float* values, const quint64* done, int count)
+{
+#ifdef DENSE_GRAPH_AVX2
+    if (useSimd()) {
+        return argMinAvx2(values, done, count);
+    }
+#endif
+    return argMinScalar(values, done, count);
+}
+
+} // namespace GraphKernels
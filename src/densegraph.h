@@ -0,0 +1,310 @@
+#ifndef DENSEGRAPH_H
+#define DENSEGRAPH_H
+
+#include <QVector>
+#include <QPair>
+#include <QtGlobal>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <type_traits>
+#include <vector>
+
+// Adjacency backends for the frozen graph. Each exposes the row operations
+// the GraphKernels templates are written against:
+//   relax(u, base, dist, previous, done)  for every neighbour v of u not in
+//       done, lowers dist[v] to base + w(u, v) and sets previous[v] = u when
+//       that is strictly smaller
+//   nearest(u, done)  the neighbour v of u not in done with the smallest
+//       w(u, v), lowest ID on ties; -1 when there is none
+//   forEachEdge(u, fn)  calls fn(v, weight) for every edge of u in target
+//       order, for the heap-based kernels
+// done is a bit set, bit v of word v / 64 standing for node v. Self loops
+// and non-positive weights count as missing edges.
+
+// Flat row-major N x N float matrix, +infinity where there is no edge. Rows
+// are scanned eight lanes at a time with AVX2 when the CPU supports it.
+// Meant for graphs of at most MaxNodes nodes, where a whole row fits in a
+// few cache lines and scanning it beats chasing CSR offsets.
+class DenseAdjacency {
+public:
+    static const int MaxNodes = 128;
+
+    // rowStart/targets/weights are CSR rows as built by StadiumGraph
+    void build(const QVector<int>& rowStart, const QVector<int>& targets, const QVector<double>& weights);
+    void clear();
+
+    bool isEmpty() const { return n == 0; }
+    int size() const { return n; }
+    const float* row(int u) const { return values.constData() + u * n; }
+
+    void relax(int u, float base, float* dist, int* previous, const quint64* done) const;
+    int nearest(int u, const quint64* done) const;
+
+    template<typename Fn>
+    void forEachEdge(int u, Fn fn) const
+    {
+        const float* weights = row(u);
+        for (int v = 0; v < n; ++v) {
+            if (weights[v] != std::numeric_limits<float>::infinity()) {
+                fn(v, weights[v]);
+            }
+        }
+    }
+
+    static bool hasSimdSupport();
+
+private:
+    int n = 0;
+    QVector<float> values;
+};
+
+// Read-only view over CSR rows, for frozen graphs above the dense threshold
+class CsrAdjacency {
+public:
+    CsrAdjacency(const QVector<int>& rowStart, const QVector<int>& targets, const QVector<double>& weights)
+        : rowStart(rowStart), targets(targets), weights(weights) {}
+
+    int size() const { return qMax(0, int(rowStart.size()) - 1); }
+
+    void relax(int u, float base, float* dist, int* previous, const quint64* done) const;
+    int nearest(int u, const quint64* done) const;
+
+    template<typename Fn>
+    void forEachEdge(int u, Fn fn) const
+    {
+        for (int e = rowStart[u]; e < rowStart[u + 1]; ++e) {
+            if (targets[e] != u && weights[e] > 0) {
+                fn(targets[e], float(weights[e]));
+            }
+        }
+    }
+
+private:
+    const QVector<int>& rowStart;
+    const QVector<int>& targets;
+    const QVector<double>& weights;
+};
+
+// Graph algorithms over node IDs, instantiated per backend so the row
+// operations are bound at compile time rather than through virtual calls,
+// and per MaxNodes, the largest graph an instantiation accepts. Fixed sizes
+// keep their scratch in std::array on the stack, with the visited set in
+// one quint64 up to 64 nodes, so a query allocates nothing beyond growing
+// the caller's output vector; Dynamic sizes the scratch per query.
+// Distances are accumulated in float; callers that need exact mileage
+// re-sum the returned edges.
+namespace GraphKernels {
+
+const int Dynamic = 0;
+
+inline bool isDone(const quint64* done, int v)
+{
+    return (done[v >> 6] >> (v & 63)) & 1;
+}
+
+inline void markDone(quint64* done, int v)
+{
+    done[v >> 6] |= quint64(1) << (v & 63);
+}
+
+template<int MaxNodes>
+struct Scratch {
+    std::array<float, MaxNodes> values;
+    std::array<int, MaxNodes> previous;
+    std::array<quint64, (MaxNodes + 63) / 64> done;
+
+    void reset(int n, float value)
+    {
+        Q_ASSERT(n <= MaxNodes);
+        std::fill_n(values.begin(), n, value);
+        std::fill_n(previous.begin(), n, -1);
+        done.fill(0);
+    }
+};
+
+template<>
+struct Scratch<Dynamic> {
+    QVector<float> values;
+    QVector<int> previous;
+    QVector<quint64> done;
+
+    void reset(int n, float value)
+    {
+        values.fill(value, n);
+        previous.fill(-1, n);
+        done.fill(0, (n + 63) / 64);
+    }
+};
+
+// Calls fn(std::integral_constant<int, N>()) with the smallest N of 32, 64
+// and 128 that holds nodeCount, or with Dynamic above that. Done once per
+// query, so the kernels below run with their size fixed.
+template<typename Fn>
+auto dispatchSize(int nodeCount, Fn fn)
+{
+    if (nodeCount <= 32) {
+        return fn(std::integral_constant<int, 32>());
+    }
+    if (nodeCount <= 64) {
+        return fn(std::integral_constant<int, 64>());
+    }
+    if (nodeCount <= 128) {
+        return fn(std::integral_constant<int, 128>());
+    }
+    return fn(std::integral_constant<int, Dynamic>());
+}
+
+// First index i < count not in done holding the smallest finite value; -1
+// when every such value is infinite
+int argMin(const float* values, const quint64* done, int count);
+
+// Dijkstra with a linear minimum scan per step, O(V^2) overall, which is the
+// right shape for dense graphs. path runs source..target; false when target
+// is unreachable.
+template<int MaxNodes, typename Adjacency>
+bool shortestPath(const Adjacency& graph, int source, int target, QVector<int>& path)
+{
+    const int n = graph.size();
+    Scratch<MaxNodes> scratch;
+    scratch.reset(n, std::numeric_limits<float>::infinity());
+    float* dist = scratch.values.data();
+    int* previous = scratch.previous.data();
+    quint64* done = scratch.done.data();
+    dist[source] = 0.0f;
+    for (;;) {
+        const int u = argMin(dist, done, n);
+        if (u < 0 || u == target) {
+            break;
+        }
+        markDone(done, u);
+        graph.relax(u, dist[u], dist, previous, done);
+    }
+
+    path.clear();
+    if (dist[target] == std::numeric_limits<float>::infinity()) {
+        return false;
+    }
+    for (int v = target; v != source; v = previous[v]) {
+        path.append(v);
+    }
+    path.append(source);
+    std::reverse(path.begin(), path.end());
+    return true;
+}
+
+// Dijkstra with a binary heap, O(E log V), for large sparse graphs where a
+// linear scan per step would dominate. Same contract as shortestPath.
+template<typename Adjacency>
+bool shortestPathSparse(const Adjacency& graph, int source, int target, QVector<int>& path)
+{
+    typedef QPair<float, int> Entry;
+    QVector<float> dist(graph.size(), std::numeric_limits<float>::infinity());
+    QVector<int> previous(graph.size(), -1);
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    dist[source] = 0.0f;
+    queue.push(qMakePair(0.0f, source));
+    while (!queue.empty()) {
+        const Entry top = queue.top();
+        queue.pop();
+        const int u = top.second;
+        if (top.first > dist[u]) {
+            continue;
+        }
+        if (u == target) {
+            break;
+        }
+        graph.forEachEdge(u, [&](int v, float weight) {
+            const float alt = top.first + weight;
+            if (alt < dist[v]) {
+                dist[v] = alt;
+                previous[v] = u;
+                queue.push(qMakePair(alt, v));
+            }
+        });
+    }
+
+    path.clear();
+    if (dist[target] == std::numeric_limits<float>::infinity()) {
+        return false;
+    }
+    for (int v = target; v != source; v = previous[v]) {
+        path.append(v);
+    }
+    path.append(source);
+    std::reverse(path.begin(), path.end());
+    return true;
+}
+
+// Prim from node 0: relaxing with base 0 lowers each key to the edge weight.
+// edges holds (parent, child) in the order nodes join the tree; false when
+// the graph is disconnected.
+template<int MaxNodes, typename Adjacency>
+bool spanningTree(const Adjacency& graph, QVector<QPair<int, int>>& edges)
+{
+    const int n = graph.size();
+    edges.clear();
+    Scratch<MaxNodes> scratch;
+    scratch.reset(n, std::numeric_limits<float>::infinity());
+    float* key = scratch.values.data();
+    int* parent = scratch.previous.data();
+    quint64* done = scratch.done.data();
+    if (n > 0) {
+        key[0] = 0.0f;
+    }
+    for (int joined = 0; joined < n; ++joined) {
+        const int u = argMin(key, done, n);
+        if (u < 0) {
+            edges.clear();
+            return false;
+        }
+        markDone(done, u);
+        if (parent[u] >= 0) {
+            edges.append(qMakePair(parent[u], u));
+        }
+        graph.relax(u, 0.0f, key, parent, done);
+    }
+    return true;
+}
+
+// Nearest neighbour over direct edges: from start, repeatedly moves to the
+// closest stop not yet visited. order starts with start; false when some
+// stop cannot be reached directly from the current one.
+template<int MaxNodes, typename Adjacency>
+bool nearestNeighbourTour(const Adjacency& graph, int start, const QVector<int>& stops, QVector<int>& order)
+{
+    const int n = graph.size();
+    Scratch<MaxNodes> scratch;
+    scratch.reset(n, 0.0f);
+    quint64* done = scratch.done.data();
+    // Everything but the stops starts out done
+    for (int word = 0; word < (n + 63) / 64; ++word) {
+        done[word] = ~quint64(0);
+    }
+    int remaining = 0;
+    for (int stop : stops) {
+        if (isDone(done, stop)) {
+            done[stop >> 6] &= ~(quint64(1) << (stop & 63));
+            ++remaining;
+        }
+    }
+    order.clear();
+    order.append(start);
+    int current = start;
+    for (; remaining > 0; --remaining) {
+        const int next = graph.nearest(current, done);
+        if (next < 0) {
+            return false;
+        }
+        markDone(done, next);
+        order.append(next);
+        current = next;
+    }
+    return true;
+}
+
+} // namespace GraphKernels
+
+#endif // DENSEGRAPH_H
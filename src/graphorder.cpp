@@ -0,0 +1,137 @@
+#include "graphorder.h"
+#include <QPair>
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+// Visits every component in turn: starts are tried in the given sequence,
+// and each unvisited one seeds a BFS whose newly found neighbours are
+// sorted by sortKey before they join the queue
+template<typename SortKey>
+QVector<int> bfsOrder(const QVector<int>& rowStart, const QVector<int>& targets,
+                      const QVector<int>& starts, SortKey sortKey)
+{
+    const int n = qMax(0, int(rowStart.size()) - 1);
+    QVector<int> order;
+    order.reserve(n);
+    QVector<bool> visited(n, false);
+    for (int start : starts) {
+        if (visited[start]) {
+            continue;
+        }
+        visited[start] = true;
+        int head = order.size();
+        order.append(start);
+        while (head < order.size()) {
+            const int u = order[head++];
+            const int found = order.size();
+            for (int e = rowStart[u]; e < rowStart[u + 1]; ++e) {
+                const int v = targets[e];
+                if (!visited[v]) {
+                    visited[v] = true;
+                    order.append(v);
+                }
+            }
+            std::sort(order.begin() + found, order.end(), [&sortKey](int a, int b) {
+                return sortKey(a) < sortKey(b);
+            });
+        }
+    }
+    return order;
+}
+
+} // namespace
+
+namespace GraphOrder {
+
+QVector<int> compute(NodeOrder nodeOrder, const QVector<int>& rowStart, const QVector<int>& targets)
+{
+    switch (nodeOrder) {
+    case NodeOrder::BreadthFirst:
+        return breadthFirst(rowStart, targets);
+    case NodeOrder::ReverseCuthillMcKee:
+        return reverseCuthillMcKee(rowStart, targets);
+    case NodeOrder::KeyOrder:
+    default:
+        break;
+    }
+    const int n = qMax(0, int(rowStart.size()) - 1);
+    QVector<int> order(n);
+    for (int i = 0; i < n; ++i) {
+        order[i] = i;
+    }
+    return order;
+}
+
+QVector<int> breadthFirst(const QVector<int>& rowStart, const QVector<int>& targets)
+{
+    // Rows are sorted by target already, so keeping ID order keeps row order
+    return bfsOrder(rowStart, targets, compute(NodeOrder::KeyOrder, rowStart, targets),
+                    [](int node) { return node; });
+}
+
+QVector<int> reverseCuthillMcKee(const QVector<int>& rowStart, const QVector<int>& targets)
+{
+    // The first unvisited node in degree order has the lowest degree of its
+    // component, the usual cheap stand-in for a peripheral start
+    const int n = qMax(0, int(rowStart.size()) - 1);
+    auto degreeKey = [&rowStart](int node) { return qMakePair(rowStart[node + 1] - rowStart[node], node); };
+    QVector<int> starts = compute(NodeOrder::KeyOrder, rowStart, targets);
+    std::sort(starts.begin(), starts.end(), [&degreeKey](int a, int b) { return degreeKey(a) < degreeKey(b); });
+    QVector<int> order = bfsOrder(rowStart, targets, starts, degreeKey);
+    std::reverse(order.begin(), order.end());
+    Q_ASSERT(order.size() == n);
+    return order;
+}
+
+void permuteRows(const QVector<int>& order, QVector<int>& rowStart, QVector<int>& targets,
+                 QVector<double>& weights)
+{
+    const int n = order.size();
+    QVector<int> newId(n);
+    for (int i = 0; i < n; ++i) {
+        newId[order[i]] = i;
+    }
+
+    QVector<int> newStart;
+    newStart.reserve(n + 1);
+    QVector<int> newTargets;
+    newTargets.reserve(targets.size());
+    QVector<double> newWeights;
+    newWeights.reserve(weights.size());
+    QVector<QPair<int, double>> row;
+    for (int i = 0; i < n; ++i) {
+        const int old = order[i];
+        row.clear();
+        for (int e = rowStart[old]; e < rowStart[old + 1]; ++e) {
+            row.append(qMakePair(newId[targets[e]], weights[e]));
+        }
+        std::sort(row.begin(), row.end());
+        newStart.append(newTargets.size());
+        for (const auto& edge : row) {
+            newTargets.append(edge.first);
+            newWeights.append(edge.second);
+        }
+    }
+    newStart.append(newTargets.size());
+    rowStart.swap(newStart);
+    targets.swap(newTargets);
+    weights.swap(newWeights);
+}
+
+double meanEdgeSpan(const QVector<int>& rowStart, const QVector<int>& targets)
+{
+    if (targets.isEmpty()) {
+        return 0.0;
+    }
+    qint64 total = 0;
+    for (int u = 0; u + 1 < rowStart.size(); ++u) {
+        for (int e = rowStart[u]; e < rowStart[u + 1]; ++e) {
+            total += std::abs(targets[e] - u);
+        }
+    }
+    return double(total) / targets.size();
+}
+
+} // namespace GraphOrder
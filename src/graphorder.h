@@ -0,0 +1,37 @@
+#ifndef GRAPHORDER_H
+#define GRAPHORDER_H
+
+#include <QVector>
+
+// Node numbering for frozen adjacency rows. Key order (the normalized name
+// order of the map) scatters neighbouring stadiums across memory; the other
+// orders number each node close to its neighbours, so a traversal touches
+// fewer cache lines and delta-encoded targets get smaller.
+enum class NodeOrder {
+    KeyOrder,            // IDs as assigned, no reordering
+    BreadthFirst,        // BFS from the lowest ID of each component
+    ReverseCuthillMcKee  // RCM: BFS from a minimum-degree node, neighbours by
+                         // ascending degree, whole order reversed
+};
+
+// Orders computed from CSR rows (row u is targets[rowStart[u] ..
+// rowStart[u + 1]), symmetric as StadiumGraph builds them). Each returns
+// order with order[newId] == oldId, covering every node once.
+namespace GraphOrder {
+
+QVector<int> compute(NodeOrder nodeOrder, const QVector<int>& rowStart, const QVector<int>& targets);
+QVector<int> breadthFirst(const QVector<int>& rowStart, const QVector<int>& targets);
+QVector<int> reverseCuthillMcKee(const QVector<int>& rowStart, const QVector<int>& targets);
+
+// Renumbers rows in place: row newId becomes old row order[newId], with
+// targets renamed to new IDs and each row sorted by target again
+void permuteRows(const QVector<int>& order, QVector<int>& rowStart, QVector<int>& targets,
+                 QVector<double>& weights);
+
+// Mean |u - v| over all edges, a cheap proxy for how far apart in memory
+// neighbouring rows are
+double meanEdgeSpan(const QVector<int>& rowStart, const QVector<int>& targets);
+
+} // namespace GraphOrder
+
+#endif // GRAPHORDER_H
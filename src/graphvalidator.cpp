@@ -0,0 +1,190 @@
+#include "graphvalidator.h"
+#include <QElapsedTimer>
+#include <QStringList>
+
+const char* graphIssueKindName(GraphIssue::Kind kind)
+{
+    switch (kind) {
+    case GraphIssue::AsymmetricWeight: return "asymmetric weights";
+    case GraphIssue::MissingReverse: return "missing reverse edges";
+    case GraphIssue::ConflictingDuplicate: return "conflicting duplicate edges";
+    case GraphIssue::SelfLoop: return "self loops";
+    case GraphIssue::NonPositiveWeight: return "non-positive weights";
+    case GraphIssue::OrphanNode: return "orphan nodes";
+    case GraphIssue::UnknownName: return "unknown names";
+    case GraphIssue::Disconnected: return "disconnected nodes";
+    default: return "unknown";
+    }
+}
+
+bool GraphValidationReport::isValid() const
+{
+    for (int kind = 0; kind < GraphIssue::KindCount; ++kind) {
+        if (counts[kind] > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QString GraphValidationReport::summary() const
+{
+    QStringList parts;
+    parts << QString("%1 nodes, %2 edges, %3 component(s)").arg(nodes).arg(edges).arg(components);
+    for (int kind = 0; kind < GraphIssue::KindCount; ++kind) {
+        if (counts[kind] > 0) {
+            parts << QString("%1 %2").arg(counts[kind]).arg(graphIssueKindName(GraphIssue::Kind(kind)));
+        }
+    }
+    if (isValid()) {
+        parts << "no issues";
+    }
+    return parts.join(", ");
+}
+
+namespace GraphValidator {
+
+GraphValidationReport validate(const QVector<int>& rowStart, const QVector<int>& targets,
+                               const QVector<double>& weights, const NodeName& nodeName,
+                               const QVector<bool>& known, int maxIssues)
+{
+    QElapsedTimer timer;
+    timer.start();
+    GraphValidationReport report;
+    const int nodeCount = qMax(0, int(rowStart.size()) - 1);
+    const int edgeCount = targets.size();
+    report.nodes = nodeCount;
+    report.edges = edgeCount;
+
+    auto add = [&](GraphIssue::Kind kind, int from, int to, double weight, double otherWeight, int component) {
+        ++report.counts[kind];
+        if (report.issues.size() >= maxIssues) {
+            report.truncated = true;
+            return;
+        }
+        GraphIssue issue;
+        issue.kind = kind;
+        issue.from = nodeName(from);
+        if (to >= 0) {
+            issue.to = nodeName(to);
+        }
+        issue.weight = weight;
+        issue.otherWeight = otherWeight;
+        issue.component = component;
+        report.issues.append(issue);
+    };
+
+    // Transposed rows by counting sort; filling sources in ascending order
+    // leaves every transposed row sorted
+    QVector<int> inStart(nodeCount + 1, 0);
+    for (int e = 0; e < edgeCount; ++e) {
+        ++inStart[targets[e] + 1];
+    }
+    for (int v = 0; v < nodeCount; ++v) {
+        inStart[v + 1] += inStart[v];
+    }
+    QVector<int> inSources(edgeCount);
+    QVector<double> inWeights(edgeCount);
+    QVector<int> next = inStart;
+    for (int u = 0; u < nodeCount; ++u) {
+        for (int e = rowStart[u]; e < rowStart[u + 1]; ++e) {
+            const int slot = next[targets[e]]++;
+            inSources[slot] = u;
+            inWeights[slot] = weights[e];
+        }
+    }
+
+    for (int u = 0; u < nodeCount; ++u) {
+        const int outEnd = rowStart[u + 1];
+        const int inEnd = inStart[u + 1];
+        if (rowStart[u] == outEnd && inStart[u] == inEnd) {
+            add(GraphIssue::OrphanNode, u, -1, 0.0, 0.0, -1);
+        }
+        if (!known.isEmpty() && !known[u]) {
+            add(GraphIssue::UnknownName, u, -1, 0.0, 0.0, -1);
+        }
+
+        int in = inStart[u];
+        for (int e = rowStart[u]; e < outEnd; ++e) {
+            const int v = targets[e];
+            const double weight = weights[e];
+            if (e > rowStart[u] && targets[e - 1] == v) {
+                if (weights[e - 1] != weight) {
+                    add(GraphIssue::ConflictingDuplicate, u, v, weights[e - 1], weight, -1);
+                }
+                continue;
+            }
+            if (v == u) {
+                add(GraphIssue::SelfLoop, u, v, weight, weight, -1);
+            }
+
+            // The transposed row of u lists v exactly when v->u exists
+            while (in < inEnd && inSources[in] < v) {
+                ++in;
+            }
+            const bool hasReverse = in < inEnd && inSources[in] == v;
+            const double reverse = hasReverse ? inWeights[in] : -1.0;
+            if (!hasReverse) {
+                add(GraphIssue::MissingReverse, u, v, weight, -1.0, -1);
+            } else if (u < v && reverse != weight) {
+                add(GraphIssue::AsymmetricWeight, u, v, weight, reverse, -1);
+            }
+            // Report a symmetric bad pair once, from its lower node
+            if (!(weight > 0.0) && (u <= v || reverse != weight)) {
+                add(GraphIssue::NonPositiveWeight, u, v, weight, reverse, -1);
+            }
+        }
+    }
+
+    // Components of the undirected graph: BFS over out and in rows
+    QVector<int> component(nodeCount, -1);
+    QVector<int> sizes;
+    QVector<int> queue(nodeCount);
+    for (int start = 0; start < nodeCount; ++start) {
+        if (component[start] >= 0) {
+            continue;
+        }
+        const int id = sizes.size();
+        int head = 0;
+        int tail = 0;
+        queue[tail++] = start;
+        component[start] = id;
+        while (head < tail) {
+            const int u = queue[head++];
+            for (int e = rowStart[u]; e < rowStart[u + 1]; ++e) {
+                if (component[targets[e]] < 0) {
+                    component[targets[e]] = id;
+                    queue[tail++] = targets[e];
+                }
+            }
+            for (int e = inStart[u]; e < inStart[u + 1]; ++e) {
+                if (component[inSources[e]] < 0) {
+                    component[inSources[e]] = id;
+                    queue[tail++] = inSources[e];
+                }
+            }
+        }
+        sizes.append(tail);
+    }
+    report.components = sizes.size();
+    int largest = -1;
+    for (int id = 0; id < sizes.size(); ++id) {
+        if (largest < 0 || sizes[id] > sizes[largest]) {
+            largest = id;
+        }
+    }
+    report.largestComponent = largest >= 0 ? sizes[largest] : 0;
+
+    // Orphans are already reported
+    for (int u = 0; u < nodeCount; ++u) {
+        const bool orphan = rowStart[u] == rowStart[u + 1] && inStart[u] == inStart[u + 1];
+        if (component[u] != largest && !orphan) {
+            add(GraphIssue::Disconnected, u, -1, 0.0, 0.0, component[u]);
+        }
+    }
+
+    report.micros = timer.nsecsElapsed() / 1000;
+    return report;
+}
+
+} // namespace GraphValidator
@@ -0,0 +1,67 @@
+#ifndef GRAPHVALIDATOR_H
+#define GRAPHVALIDATOR_H
+
+#include <QString>
+#include <QVector>
+#include <functional>
+
+// One problem found by GraphValidator. Edge issues name both stadiums, node
+// issues only from.
+struct GraphIssue {
+    enum Kind : quint8 {
+        AsymmetricWeight,      // from->to is weight, to->from is otherWeight
+        MissingReverse,        // from->to has no to->from
+        ConflictingDuplicate,  // from->to listed twice, as weight and otherWeight
+        SelfLoop,
+        NonPositiveWeight,
+        OrphanNode,            // no edges in or out
+        UnknownName,           // not the stadium of any team
+        Disconnected,          // outside the largest component
+        KindCount
+    };
+
+    Kind kind = AsymmetricWeight;
+    QString from;
+    QString to;
+    double weight = 0.0;
+    double otherWeight = 0.0;
+    int component = -1;  // Disconnected: index of the node's component
+};
+
+const char* graphIssueKindName(GraphIssue::Kind kind);
+
+struct GraphValidationReport {
+    int nodes = 0;
+    int edges = 0;             // directed entries, twice the undirected count
+    int components = 0;
+    int largestComponent = 0;  // nodes in the largest component
+    int counts[GraphIssue::KindCount] = {};
+    // Capped at maxIssues; edge and node issues in node order, then the
+    // Disconnected ones. counts are never capped.
+    QVector<GraphIssue> issues;
+    bool truncated = false;
+    qint64 micros = 0;
+
+    int count(GraphIssue::Kind kind) const { return counts[kind]; }
+    bool isValid() const;
+    QString summary() const;
+};
+
+// Validates a weighted graph that should be undirected, stored as CSR rows:
+// row u is targets[rowStart[u] .. rowStart[u + 1]) with matching weights,
+// each row sorted by target. One pass in O(V + E): every edge's reverse is
+// found by merging its row with the same row of the transposed graph, and
+// components come from one BFS over both.
+namespace GraphValidator {
+
+typedef std::function<QString(int)> NodeName;
+
+// known[u] == false reports node u as an unknown name; an empty known skips
+// that check
+GraphValidationReport validate(const QVector<int>& rowStart, const QVector<int>& targets,
+                               const QVector<double>& weights, const NodeName& nodeName,
+                               const QVector<bool>& known = QVector<bool>(), int maxIssues = 1000);
+
+} // namespace GraphValidator
+
+#endif // GRAPHVALIDATOR_H
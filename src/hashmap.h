@@ -4,7 +4,9 @@
 #include <QString>
 #include <QVector>
 #include <functional>
+#include <type_traits>
 #include "stadiuminfo.h"
+#include "perfecthash.h"
 
 // Node structure for hash table
 template<typename K, typename V>
@@ -37,6 +39,39 @@ private:
         return key % TABLE_SIZE;
     }
 
+    // NameKey keys carry their hash already
+    int hash(const NameKey& key) const {
+        return int(key.hash() % TABLE_SIZE);
+    }
+
+    static constexpr bool hasNameKeys = std::is_same<K, QString>::value || std::is_same<K, NameKey>::value;
+
+    // Optional perfect-hash index over name keys, see freeze()
+    MinimalPerfectHash frozen;
+    QVector<HashNode<K, V>*> frozenNodes;
+
+    HashNode<K, V>* findNode(const K& key) const {
+        if constexpr (hasNameKeys) {
+            if (frozen.isBuilt()) {
+                int id = frozen.find(key);
+                return id < 0 ? nullptr : frozenNodes[id];
+            }
+        }
+        HashNode<K, V>* node = table[hash(key)];
+        while(node != nullptr) {
+            if(node->key == key) {
+                return node;
+            }
+            node = node->next;
+        }
+        return nullptr;
+    }
+
+    void thaw() {
+        frozen.clear();
+        frozenNodes.clear();
+    }
+
 public:
     HashMap() {
         for(int i = 0; i < TABLE_SIZE; i++) {
@@ -50,38 +85,78 @@ public:
     
     void insert(const K& key, const V& value) {
         int index = hash(key);
-        HashNode<K, V>* node = table[index];
-        
+
         // Check if key already exists
-        while(node != nullptr) {
-            if(node->key == key) {
-                node->value = value;  // Update value if key exists
-                return;
-            }
-            node = node->next;
+        if(HashNode<K, V>* node = findNode(key)) {
+            node->value = value;  // Update value if key exists
+            return;
         }
-        
+
         // Create new node
+        thaw();
         HashNode<K, V>* newNode = new HashNode<K, V>(key, value);
         newNode->next = table[index];
         table[index] = newNode;
     }
     
     bool get(const K& key, V& value) const {
-        int index = hash(key);
-        HashNode<K, V>* node = table[index];
-        
-        while(node != nullptr) {
-            if(node->key == key) {
-                value = node->value;
-                return true;
-            }
-            node = node->next;
+        HashNode<K, V>* node = findNode(key);
+        if(node == nullptr) {
+            return false;
         }
-        return false;
+        value = node->value;
+        return true;
     }
     
+    // Pointer to the stored value for in-place updates, or nullptr
+    V* find(const K& key) {
+        HashNode<K, V>* node = findNode(key);
+        return node ? &node->value : nullptr;
+    }
+
+    // For QString and NameKey keys, builds a minimal perfect hash over the
+    // current key set so lookups take one hash and one compare instead of a
+    // chain walk. Inserting a new key, remove() and clear() fall back to the
+    // chains.
+    void freeze() {
+        thaw();
+        if constexpr (hasNameKeys) {
+            QVector<K> keys;
+            for(int i = 0; i < TABLE_SIZE; i++) {
+                for(HashNode<K, V>* node = table[i]; node != nullptr; node = node->next) {
+                    keys.append(node->key);
+                    frozenNodes.append(node);
+                }
+            }
+            if(!frozen.build(keys)) {
+                thaw();
+            }
+        }
+    }
+
+    bool isFrozen() const { return frozen.isBuilt(); }
+
+    // Visit every entry in place without copying values out
+    template<typename F>
+    void forEach(F visit) {
+        for(int i = 0; i < TABLE_SIZE; i++) {
+            for(HashNode<K, V>* node = table[i]; node != nullptr; node = node->next) {
+                visit(node->key, node->value);
+            }
+        }
+    }
+
+    template<typename F>
+    void forEach(F visit) const {
+        for(int i = 0; i < TABLE_SIZE; i++) {
+            for(const HashNode<K, V>* node = table[i]; node != nullptr; node = node->next) {
+                visit(node->key, node->value);
+            }
+        }
+    }
+
     void remove(const K& key) {
+        thaw();
         int index = hash(key);
         HashNode<K, V>* node = table[index];
         HashNode<K, V>* prev = nullptr;
@@ -102,6 +177,7 @@ public:
     }
     
     void clear() {
+        thaw();
         for(int i = 0; i < TABLE_SIZE; i++) {
             HashNode<K, V>* node = table[i];
             while(node != nullptr) {
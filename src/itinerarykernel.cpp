@@ -0,0 +1,241 @@
+#include "itinerarykernel.h"
+#include <QDebug>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+#include <queue>
+#include <cmath>
+#include <limits>
+#include <functional>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ITINERARY_KERNEL_AVX2 1
+#endif
+
+namespace {
+
+const int ChunkSize = 4096;
+
+void sumItineraryScalar(const float* matrix, int n, const qint32* spend,
+                        const quint16* stops, int count, float& distance, qint64& cents)
+{
+    float dist = 0.0f;
+    qint64 total = 0;
+    for (int i = 0; i + 1 < count; ++i) {
+        dist += matrix[qint64(stops[i]) * n + stops[i + 1]];
+        total += spend[stops[i]];
+    }
+    if (count > 0) {
+        total += spend[stops[count - 1]];
+    }
+    distance = dist;
+    cents = total;
+}
+
+#ifdef ITINERARY_KERNEL_AVX2
+// Eight legs per step: widen the packed uint16 stop IDs, form row-major
+// indices from * n + to and gather the leg distances and per-stop spend.
+__attribute__((target("avx2")))
+void sumItineraryAvx2(const float* matrix, int n, const qint32* spend,
+                      const quint16* stops, int count, float& distance, qint64& cents)
+{
+    const int legs = count - 1;
+    const __m256i stride = _mm256_set1_epi32(n);
+    __m256 distAcc = _mm256_setzero_ps();
+    __m256i centsAcc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= legs; i += 8) {
+        __m256i from = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(stops + i)));
+        __m256i to = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(stops + i + 1)));
+        __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(from, stride), to);
+        distAcc = _mm256_add_ps(distAcc, _mm256_i32gather_ps(matrix, index, 4));
+        __m256i stopSpend = _mm256_i32gather_epi32(reinterpret_cast<const int*>(spend), from, 4);
+        centsAcc = _mm256_add_epi64(centsAcc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(stopSpend)));
+        centsAcc = _mm256_add_epi64(centsAcc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(stopSpend, 1)));
+    }
+
+    alignas(32) float distLanes[8];
+    alignas(32) qint64 centsLanes[4];
+    _mm256_store_ps(distLanes, distAcc);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(centsLanes), centsAcc);
+    float dist = ((distLanes[0] + distLanes[1]) + (distLanes[2] + distLanes[3]))
+               + ((distLanes[4] + distLanes[5]) + (distLanes[6] + distLanes[7]));
+    qint64 total = centsLanes[0] + centsLanes[1] + centsLanes[2] + centsLanes[3];
+
+    for (; i < legs; ++i) {
+        dist += matrix[qint64(stops[i]) * n + stops[i + 1]];
+        total += spend[stops[i]];
+    }
+    if (count > 0) {
+        total += spend[stops[count - 1]];
+    }
+    distance = dist;
+    cents = total;
+}
+#endif
+
+} // namespace
+
+DistanceMatrix::DistanceMatrix() : n(0) {}
+
+void DistanceMatrix::resize(int nodeCount) {
+    n = nodeCount;
+    values.fill(std::numeric_limits<float>::infinity(), qsizetype(n) * n);
+    for (int i = 0; i < n; ++i) {
+        values[qint64(i) * n + i] = 0.0f;
+    }
+}
+
+void DistanceMatrix::build(const StadiumGraph& graph, const StadiumRegistry& registry) {
+    resize(registry.nodeCount());
+
+    // Integer adjacency over node IDs, then one heap Dijkstra per source
+    QVector<NameKey> keys(n);
+    QHash<NameKey, int> ids;
+    for (int u = 0; u < n; ++u) {
+        keys[u] = NameKey(registry.nodeName(u));
+        ids.insert(keys[u], u);
+    }
+    QVector<QVector<QPair<int, float>>> adjacency(n);
+    for (int u = 0; u < n; ++u) {
+        graph.forEachNeighbor(keys[u], [&](const NameKey& neighbor, double distance) {
+            const int v = ids.value(neighbor, StadiumRegistry::InvalidId);
+            if (v != StadiumRegistry::InvalidId && distance > 0) {
+                adjacency[u].append(qMakePair(v, float(distance)));
+            }
+        });
+    }
+
+    QVector<int> sources(n);
+    for (int i = 0; i < n; ++i) sources[i] = i;
+    float* rows = values.data();
+    const int nodes = n;
+    QtConcurrent::blockingMap(sources, [&adjacency, rows, nodes](int source) {
+        typedef QPair<float, int> Entry;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+        float* row = rows + qint64(source) * nodes;
+        queue.push(qMakePair(0.0f, source));
+        while (!queue.empty()) {
+            Entry top = queue.top();
+            queue.pop();
+            if (top.first > row[top.second]) {
+                continue;
+            }
+            for (const auto& edge : adjacency[top.second]) {
+                float alt = top.first + edge.second;
+                if (alt < row[edge.first]) {
+                    row[edge.first] = alt;
+                    queue.push(qMakePair(alt, edge.first));
+                }
+            }
+        }
+    });
+}
+
+bool ItineraryBatch::isValid(int nodeCount) const {
+    if (count <= 0) {
+        return count == 0;
+    }
+    if (!stops || !offsets) {
+        return false;
+    }
+    for (int k = 0; k < count; ++k) {
+        if (offsets[k + 1] < offsets[k]) {
+            return false;
+        }
+    }
+    for (quint32 i = offsets[0]; i < offsets[count]; ++i) {
+        if (stops[i] >= nodeCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ItineraryResults::resize(int count) {
+    distance.resize(count);
+    souvenirCents.resize(count);
+    reachable.resize(count);
+}
+
+ItineraryKernel::ItineraryKernel(const DistanceMatrix& matrix, const QVector<qint32>& spendCentsPerNode)
+    : matrix(matrix)
+    , spend(spendCentsPerNode)
+    , useSimd(hasSimdSupport())
+{
+    spend.resize(matrix.size());
+    // 32-bit gather indices must not overflow for from * n + to
+    if (qint64(matrix.size()) * matrix.size() >= (qint64(1) << 31)) {
+        useSimd = false;
+    }
+}
+
+bool ItineraryKernel::hasSimdSupport() {
+#ifdef ITINERARY_KERNEL_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+bool ItineraryKernel::evaluate(const ItineraryBatch& batch, ItineraryResults& results, int threadCount) const {
+    // Stops index the matrix and spend table unchecked in the hot loops
+    if (!batch.isValid(matrix.size())) {
+        qDebug() << "Invalid itinerary batch for a" << matrix.size() << "node matrix";
+        return false;
+    }
+    results.resize(batch.count);
+    if (batch.count == 0) {
+        return true;
+    }
+    // Detach once up front so the workers only ever write through raw pointers
+    results.distance.data();
+    results.souvenirCents.data();
+    results.reachable.data();
+
+    QVector<QPair<int, int>> chunks;
+    for (int begin = 0; begin < batch.count; begin += ChunkSize) {
+        chunks.append(qMakePair(begin, qMin(begin + ChunkSize, batch.count)));
+    }
+    if (threadCount == 1 || chunks.size() == 1) {
+        for (const auto& chunk : chunks) {
+            evaluateRange(batch, results, chunk.first, chunk.second);
+        }
+        return true;
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount > 0 ? threadCount : QThread::idealThreadCount());
+    QtConcurrent::blockingMap(&pool, chunks, [this, &batch, &results](const QPair<int, int>& chunk) {
+        evaluateRange(batch, results, chunk.first, chunk.second);
+    });
+    return true;
+}
+
+void ItineraryKernel::evaluateRange(const ItineraryBatch& batch, ItineraryResults& results, int begin, int end) const {
+    const float* dist = matrix.data();
+    const int n = matrix.size();
+    const qint32* stopSpend = spend.constData();
+    float* outDistance = const_cast<float*>(results.distance.constData());
+    qint64* outCents = const_cast<qint64*>(results.souvenirCents.constData());
+    quint8* outReachable = const_cast<quint8*>(results.reachable.constData());
+
+    for (int k = begin; k < end; ++k) {
+        const quint16* stops = batch.stops + batch.offsets[k];
+        int count = int(batch.offsets[k + 1] - batch.offsets[k]);
+        float distance = 0.0f;
+        qint64 cents = 0;
+#ifdef ITINERARY_KERNEL_AVX2
+        if (useSimd) {
+            sumItineraryAvx2(dist, n, stopSpend, stops, count, distance, cents);
+        } else
+#endif
+        {
+            sumItineraryScalar(dist, n, stopSpend, stops, count, distance, cents);
+        }
+        outDistance[k] = distance;
+        outCents[k] = cents;
+        outReachable[k] = std::isfinite(distance) ? 1 : 0;
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef ITINERARYKERNEL_H
+#define ITINERARYKERNEL_H
+
+#include <QVector>
+#include <QtGlobal>
+#include "stadiumgraph.h"
+#include "stadiumregistry.h"
+
+// Row-major all-pairs distance matrix over registry node IDs.
+// Entry (i, j) is the shortest-path mileage from node i to node j, or
+// +infinity when j is unreachable from i.
+class DistanceMatrix {
+public:
+    DistanceMatrix();
+
+    void build(const StadiumGraph& graph, const StadiumRegistry& registry);
+    void resize(int nodeCount);
+    void set(int from, int to, float distance) { values[qint64(from) * n + to] = distance; }
+
+    int size() const { return n; }
+    float at(int from, int to) const { return values[qint64(from) * n + to]; }
+    const float* data() const { return values.constData(); }
+
+private:
+    int n;
+    QVector<float> values;
+};
+
+// Packed itinerary input: stops of itinerary k are
+// stops[offsets[k] .. offsets[k + 1]), each a node ID in the matrix.
+struct ItineraryBatch {
+    const quint16* stops = nullptr;
+    const quint32* offsets = nullptr;  // count + 1 entries
+    int count = 0;
+
+    // Offsets never decrease and every stop is below nodeCount
+    bool isValid(int nodeCount) const;
+};
+
+// Columnar results, one entry per itinerary in batch order
+struct ItineraryResults {
+    QVector<float> distance;
+    QVector<qint64> souvenirCents;
+    QVector<quint8> reachable;  // 0 when any leg has no path
+
+    void resize(int count);
+};
+
+// Evaluates mileage and souvenir spend for large batches of itineraries.
+// Legs are summed with AVX2 gathers from the distance matrix when the CPU
+// supports it (scalar otherwise), and batches are split across cores.
+class ItineraryKernel {
+public:
+    // spendCentsPerNode[i] is the souvenir spend at node i, in cents
+    ItineraryKernel(const DistanceMatrix& matrix, const QVector<qint32>& spendCentsPerNode);
+
+    // False, with nothing evaluated, when the batch fails isValid() for the
+    // matrix size
+    bool evaluate(const ItineraryBatch& batch, ItineraryResults& results, int threadCount = 0) const;
+
+    static bool hasSimdSupport();
+
+private:
+    void evaluateRange(const ItineraryBatch& batch, ItineraryResults& results, int begin, int end) const;
+
+    const DistanceMatrix& matrix;
+    QVector<qint32> spend;
+    bool useSimd;
+};
+
+#endif // ITINERARYKERNEL_H
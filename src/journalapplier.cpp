@@ -0,0 +1,133 @@
+#include "journalapplier.h"
+#include <QDebug>
+
+JournalApplier::JournalApplier(Database *db, StadiumGraph *graph)
+    : db(db)
+    , graph(graph)
+{
+}
+
+JournalReplayResult JournalApplier::applyFile(const QString &path)
+{
+    quint64 journalId = 0;
+    QVector<JournalRecord> records;
+    bool truncated = false;
+    if (!ChangeJournal::readFile(path, journalId, records, &truncated)) {
+        return JournalReplayResult();
+    }
+    JournalReplayResult result = apply(journalId, records);
+    result.truncated = truncated;
+    qDebug() << "Replayed journal" << path << ":" << result.applied << "applied,"
+             << result.skipped << "skipped in" << result.batches << "batches, up to sequence"
+             << result.lastSequence << (truncated ? "(torn tail ignored)" : "");
+    return result;
+}
+
+JournalReplayResult JournalApplier::apply(quint64 journalId, const QVector<JournalRecord> &records)
+{
+    JournalReplayResult result;
+    const quint64 dbLast = db->journalProgress(journalId);
+    quint64 &graphLast = graphApplied[journalId];
+    // Records up to here are in both the database and the graph
+    quint64 last = graph ? qMin(dbLast, graphLast) : dbLast;
+
+    QVector<JournalRecord> group;
+    group.reserve(groupSize);
+    auto commitGroup = [&]() {
+        if (group.isEmpty()) {
+            return true;
+        }
+        if (!applyGroup(journalId, group, graphLast)) {
+            return false;
+        }
+        for (const JournalRecord &record : group) {
+            const bool applied = record.isGraphChange() ? graph && record.sequence > graphLast
+                                                        : record.sequence > dbLast;
+            if (applied) {
+                ++result.applied;
+            } else {
+                ++result.skipped;
+            }
+        }
+        last = group.last().sequence;
+        if (graph) {
+            graphLast = last;
+        }
+        ++result.batches;
+        group.clear();
+        return true;
+    };
+
+    for (const JournalRecord &record : records) {
+        if (record.sequence <= last) {
+            ++result.skipped;
+            continue;
+        }
+        const quint64 expected = (group.isEmpty() ? last : group.last().sequence) + 1;
+        if (record.sequence != expected) {
+            qDebug() << "Journal sequence gap: expected" << expected << "got" << record.sequence;
+        }
+        group.append(record);
+        if (group.size() >= groupSize && !commitGroup()) {
+            result.lastSequence = last;
+            return result;
+        }
+    }
+    result.success = commitGroup();
+    result.lastSequence = last;
+    return result;
+}
+
+quint64 JournalApplier::lastAppliedSequence(quint64 journalId) const
+{
+    const quint64 dbLast = db->journalProgress(journalId);
+    return graph ? qMin(dbLast, graphApplied.value(journalId, 0)) : dbLast;
+}
+
+bool JournalApplier::applyGroup(quint64 journalId, const QVector<JournalRecord> &group, quint64 graphLast)
+{
+    // Replayed changes belong to the source kiosk's journal, not ours
+    ChangeJournal *dbJournal = db->changeJournal();
+    ChangeJournal *graphJournal = graph ? graph->changeJournal() : nullptr;
+    db->setChangeJournal(nullptr);
+    if (graph) {
+        graph->setChangeJournal(nullptr);
+    }
+
+    // The database skips the records it already has on its own
+    bool ok = db->applyJournalRecords(journalId, group);
+    if (ok && graph) {
+        bool graphChanged = false;
+        for (const JournalRecord &record : group) {
+            if (record.sequence <= graphLast) {
+                continue;
+            }
+            switch (record.type) {
+            case JournalRecord::EdgeSet:
+                graph->addEdge(record.from, record.to, record.value);
+                graphChanged = true;
+                break;
+            case JournalRecord::EdgeRemove:
+                graph->removeEdge(record.from, record.to);
+                graphChanged = true;
+                break;
+            case JournalRecord::GraphClear:
+                graph->clear();
+                graphChanged = true;
+                break;
+            default:
+                break;
+            }
+        }
+        // Readers see the group's edges together or not at all
+        if (graphChanged) {
+            graph->publish();
+        }
+    }
+
+    db->setChangeJournal(dbJournal);
+    if (graph) {
+        graph->setChangeJournal(graphJournal);
+    }
+    return ok;
+}
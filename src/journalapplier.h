@@ -0,0 +1,50 @@
+#ifndef JOURNALAPPLIER_H
+#define JOURNALAPPLIER_H
+
+#include <QHash>
+#include <QString>
+#include "changejournal.h"
+#include "database.h"
+#include "stadiumgraph.h"
+
+struct JournalReplayResult {
+    bool success = false;
+    int applied = 0;
+    int skipped = 0;       // already applied earlier, here or in an earlier run
+    int batches = 0;
+    bool truncated = false;  // stopped at a torn or corrupt record
+    quint64 lastSequence = 0;
+};
+
+// Replays change journals shipped from other kiosks into this instance.
+// Records are applied in groups: each group's database changes share one
+// SQLite transaction and one stadium map patch. Progress is tracked per
+// journal ID, so a journal file that keeps growing can be replayed again
+// and only its new records are applied. The database stores its progress
+// in SQLite, in the same transaction as each group, so it carries over
+// restarts; the graph is rebuilt from CSVs on every start, so its progress
+// lasts for the session. Replayed changes are not written to this
+// instance's own journal.
+class JournalApplier {
+public:
+    JournalApplier(Database *db, StadiumGraph *graph);
+
+    void setGraph(StadiumGraph *graph) { this->graph = graph; }
+    void setGroupSize(int records) { groupSize = qMax(1, records); }
+
+    JournalReplayResult applyFile(const QString &path);
+    JournalReplayResult apply(quint64 journalId, const QVector<JournalRecord> &records);
+
+    // Last sequence applied to both the database and the graph
+    quint64 lastAppliedSequence(quint64 journalId) const;
+
+private:
+    bool applyGroup(quint64 journalId, const QVector<JournalRecord> &group, quint64 graphLast);
+
+    Database *db;
+    StadiumGraph *graph;
+    int groupSize = 256;
+    QHash<quint64, quint64> graphApplied;
+};
+
+#endif // JOURNALAPPLIER_H
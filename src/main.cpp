@@ -1,16 +1,48 @@
 #include "mainwindow.h"
 #include "stadiumgraph.h"
+#include "benchmarks.h"
+#include "changejournal.h"
+#include "sharedgraph.h"
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
 
+    // Workers map the published graph instead of loading any CSVs
+    int workerArg = a.arguments().indexOf("--shared-worker");
+    if (workerArg > 0 && workerArg + 1 < a.arguments().size()) {
+        return runSharedGraphWorker(a.arguments()[workerArg + 1]);
+    }
+
     StadiumGraph* stadiumGraph = new StadiumGraph();
-    stadiumGraph->loadFromCSV("MLB Information.csv"); // Adjust path if needed
+    stadiumGraph->loadDefaults();
+
+    if (a.arguments().contains("--benchmark")) {
+        return runBenchmarks(*stadiumGraph);
+    }
+
+    // Declared before the window so it is flushed after the window is gone
+    ChangeJournal journal;
 
     MainWindow w;
     w.setStadiumGraph(stadiumGraph);
+
+    // --journal <file> records this kiosk's changes; --replay-journal <file>
+    // (repeatable) applies journals shipped from other kiosks
+    const QStringList args = a.arguments();
+    for (int i = 1; i + 1 < args.size(); ++i) {
+        if (args[i] == "--journal" && journal.open(args[i + 1])) {
+            w.setChangeJournal(&journal);
+        } else if (args[i] == "--replay-journal") {
+            w.replayJournal(args[i + 1]);
+        } else if (args[i] == "--publish-shared") {
+            w.enableSharedPublishing(args[i + 1]);
+        }
+    }
+    if (a.arguments().contains("--hot-reload")) {
+        w.enableHotReload();
+    }
     w.show();
     return a.exec();
-} 
\ No newline at end of file
+}
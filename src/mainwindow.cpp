@@ -9,10 +9,12 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QInputDialog>
+#include <QDebug>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
+    , teamModel(new TeamListModel(this))
 {
     ui->setupUi(this);
     db = new Database();
@@ -22,6 +24,12 @@ MainWindow::MainWindow(QWidget *parent)
         QMessageBox::critical(this, "Error", "Failed to initialize database!");
         return;
     }
+    // Admin edits are committed in the background; deleting db flushes them
+    db->enableWriteBehind();
+    connect(db, &Database::writeFailed, this, [this](const QStringList &teamNames) {
+        QMessageBox::warning(this, "Error", "Some changes could not be saved for: " + teamNames.join(", "));
+        refreshData();
+    });
     
     // Make combo box read-only
     ui->teamComboBox->setEditable(false);
@@ -29,11 +37,11 @@ MainWindow::MainWindow(QWidget *parent)
     // Setup all button connections first
     setupConnections();
     
-    // Populate the combo box with team names
-    QSqlQuery query = db->getAllTeamsSortedByTeamName();
-    while (query.next()) {
-        ui->teamComboBox->addItem(query.value(0).toString());
-    }
+    // Populate the combo box lazily from the shared team model
+    ui->teamComboBox->setModel(teamModel);
+    rebuildTeamIndexes();
+    TeamSearchCompleter *completer = new TeamSearchCompleter(searchIndex, registry, ui->teamSearchEdit);
+    connect(completer, &TeamSearchCompleter::teamActivated, this, &MainWindow::selectTeam);
     
     // Display initial team info
     if (ui->teamComboBox->count() > 0) {
@@ -43,6 +51,8 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    delete sharedPublisher;
+    delete journalApplier;
     delete ui;
     delete db;
 }
@@ -64,6 +74,7 @@ void MainWindow::setupConnections()
     connect(ui->capacityButton, &QPushButton::clicked, this, &MainWindow::displayTeamsByCapacity);
     connect(ui->maxCenterFieldButton, &QPushButton::clicked, this, &MainWindow::displayGreatestCenterField);
     connect(ui->minCenterFieldButton, &QPushButton::clicked, this, &MainWindow::displaySmallestCenterField);
+    connect(ui->groupSummaryButton, &QPushButton::clicked, this, &MainWindow::displayGroupSummaries);
     connect(ui->viewSouvenirsButton, &QPushButton::clicked, this, &MainWindow::viewTeamSouvenirs);
 }
 
@@ -188,6 +199,73 @@ void MainWindow::displaySmallestCenterField()
     displayQueryResults(query, headers);
 }
 
+void MainWindow::displayGroupSummaries()
+{
+    struct Summary {
+        QString title;
+        QString groupHeader;
+        StadiumAggregator::GroupBy groupBy;
+        StadiumAggregator::Measure measure;
+    };
+    const QVector<Summary> summaries = {
+        {"Capacity per typology", "Typology", StadiumAggregator::GroupByTypology, StadiumAggregator::MeasureCapacity},
+        {"Capacity per league", "League", StadiumAggregator::GroupByLeague, StadiumAggregator::MeasureCapacity},
+        {"Capacity per roof type", "Roof", StadiumAggregator::GroupByRoof, StadiumAggregator::MeasureCapacity},
+        {"Center field per league", "League", StadiumAggregator::GroupByLeague, StadiumAggregator::MeasureCenterField},
+        {"Center field per surface", "Surface", StadiumAggregator::GroupBySurface, StadiumAggregator::MeasureCenterField},
+        {"Souvenir prices per team", "Team", StadiumAggregator::GroupByTeam, StadiumAggregator::MeasureSouvenirPrice},
+        {"Souvenir prices per item", "Souvenir", StadiumAggregator::GroupBySouvenirItem, StadiumAggregator::MeasureSouvenirPrice},
+        {"Souvenir prices per league", "League", StadiumAggregator::GroupByLeague, StadiumAggregator::MeasureSouvenirPrice}
+    };
+
+    QStringList titles;
+    for (const Summary &summary : summaries) {
+        titles << summary.title;
+    }
+    bool ok = false;
+    QString choice = QInputDialog::getItem(this, "Group Summaries", "Summary:", titles, 0, false, &ok);
+    if (!ok) {
+        return;
+    }
+    const Summary &summary = summaries[titles.indexOf(choice)];
+    QVector<AggregateRow> rows = db->aggregateStadiums(summary.groupBy, summary.measure);
+    displayAggregateResults(rows, summary.groupHeader, summary.measure == StadiumAggregator::MeasureSouvenirPrice);
+}
+
+void MainWindow::displayAggregateResults(const QVector<AggregateRow> &rows, const QString &groupHeader, bool cents)
+{
+    clearResults();
+
+    QStringList headers = {groupHeader, "Count", "Sum", "Min", "Max", "Average"};
+    ui->resultsTable->setColumnCount(headers.size());
+    ui->resultsTable->setHorizontalHeaderLabels(headers);
+    ui->resultsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    // Souvenir prices are aggregated in cents and shown in dollars
+    auto format = [cents](double value) {
+        return cents ? QString::number(value / 100.0, 'f', 2) : QString::number(value, 'f', 1);
+    };
+    for (int row = 0; row < rows.size(); ++row) {
+        const AggregateRow &result = rows[row];
+        QStringList values = {
+            result.group,
+            QString::number(result.count),
+            cents ? format(result.sum) : QString::number(result.sum),
+            cents ? format(result.min) : QString::number(result.min),
+            cents ? format(result.max) : QString::number(result.max),
+            format(result.average)
+        };
+        ui->resultsTable->insertRow(row);
+        for (int col = 0; col < values.size(); ++col) {
+            QTableWidgetItem *item = new QTableWidgetItem(values[col]);
+            item->setFlags(item->flags() & ~Qt::ItemIsEditable);
+            ui->resultsTable->setItem(row, col, item);
+        }
+    }
+
+    ui->resultsTable->resizeColumnsToContents();
+}
+
 void MainWindow::viewTeamSouvenirs()
 {
     QString selectedTeam = ui->teamComboBox->currentText();
@@ -209,14 +287,71 @@ void MainWindow::viewTeamSouvenirs()
     }
 }
 
+void MainWindow::setStadiumGraph(StadiumGraph* graph)
+{
+    stadiumGraph = graph;
+    if (stadiumGraph) {
+        stadiumGraph->setChangeJournal(changeJournal);
+        stadiumGraph->publish();
+        qDebug() << "Distance graph:" << stadiumGraph->validate(db->stadiumNames()).summary();
+    }
+    if (hotReloader) {
+        hotReloader->setGraph(graph);
+    }
+    if (journalApplier) {
+        journalApplier->setGraph(graph);
+    }
+}
+
+void MainWindow::setChangeJournal(ChangeJournal* journal)
+{
+    changeJournal = journal;
+    db->setChangeJournal(journal);
+    if (stadiumGraph) {
+        stadiumGraph->setChangeJournal(journal);
+    }
+}
+
+bool MainWindow::replayJournal(const QString& path)
+{
+    if (!journalApplier) {
+        journalApplier = new JournalApplier(db, stadiumGraph);
+    }
+    JournalReplayResult result = journalApplier->applyFile(path);
+    if (result.applied > 0) {
+        refreshData();
+    }
+    return result.success;
+}
+
+void MainWindow::enableHotReload()
+{
+    if (hotReloader) {
+        return;
+    }
+    hotReloader = new CsvHotReloader(db, stadiumGraph, this);
+    connect(hotReloader, &CsvHotReloader::reloaded, this, &MainWindow::refreshData);
+}
+
+bool MainWindow::enableSharedPublishing(const QString& key)
+{
+    if (!stadiumGraph) {
+        return false;
+    }
+    if (!sharedPublisher) {
+        sharedPublisher = new SharedGraphPublisher(key);
+    }
+    return sharedPublisher->publish(*stadiumGraph, db->getStadiumMap());
+}
+
 void MainWindow::refreshData()
 {
-    // Clear and repopulate the combo box
-        ui->teamComboBox->clear();
-        QSqlQuery query = db->getAllTeamsSortedByTeamName();
-        while (query.next()) {
-            ui->teamComboBox->addItem(query.value(0).toString());
-        }
+    // Repopulate the shared team model and search index
+    rebuildTeamIndexes();
+
+    if (sharedPublisher && stadiumGraph) {
+        sharedPublisher->publish(*stadiumGraph, db->getStadiumMap());
+    }
 
     // Refresh the current display
     if (ui->teamComboBox->count() > 0) {
@@ -228,8 +363,45 @@ void MainWindow::on_adminLoginButton_clicked()
 {
     AdminPanel* adminPanel = new AdminPanel(db, stadiumGraph, this);
     connect(adminPanel, &AdminPanel::dataChanged, this, &MainWindow::refreshData);
+    adminPanel->setHotReloader(hotReloader);
+
+    // The panel edits the same data; apply file changes once it closes
+    if (hotReloader) {
+        hotReloader->setPaused(true);
+    }
     adminPanel->exec();
     delete adminPanel;
+    if (changeJournal) {
+        changeJournal->flush();
+    }
+    if (hotReloader) {
+        hotReloader->setPaused(false);
+    }
+}
+
+void MainWindow::rebuildTeamIndexes()
+{
+    // Team IDs can change on rebuild, so restore the selection by name
+    QString current = ui->teamComboBox->currentText();
+    if (stadiumGraph) {
+        // Admin edits thaw the graph; publish it again with the indexes
+        stadiumGraph->publish();
+    }
+    registry.rebuild(db->getStadiumMap(), stadiumGraph);
+    searchIndex.rebuild(registry, db->getStadiumMap());
+    ui->teamComboBox->blockSignals(true);
+    teamModel->reset(&registry);
+    int row = teamModel->rowForTeam(registry.teamId(current));
+    ui->teamComboBox->setCurrentIndex(row >= 0 ? row : 0);
+    ui->teamComboBox->blockSignals(false);
+}
+
+void MainWindow::selectTeam(int teamId)
+{
+    int row = teamModel->rowForTeam(teamId);
+    if (row >= 0) {
+        ui->teamComboBox->setCurrentIndex(row);
+    }
 }
 
 void MainWindow::on_tripPlannerButton_clicked()
@@ -238,7 +410,16 @@ void MainWindow::on_tripPlannerButton_clicked()
         QMessageBox::warning(this, "Error", "Stadium graph not loaded.");
         return;
     }
-    TripPlanner* planner = new TripPlanner(db->getStadiumMap(), stadiumGraph, this);
+    rebuildTeamIndexes();
+    TripPlanner* planner = new TripPlanner(db->getStadiumMap(), stadiumGraph, registry,
+                                           teamModel, searchIndex, this);
+    // The planner holds registry IDs and graph references while open
+    if (hotReloader) {
+        hotReloader->setPaused(true);
+    }
     planner->exec();
     delete planner;
+    if (hotReloader) {
+        hotReloader->setPaused(false);
+    }
 }
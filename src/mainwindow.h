@@ -11,6 +11,13 @@
 #include "souvenirdialog.h"
 #include "stadiumgraph.h"
 #include "tripplanner.h"
+#include "stadiumregistry.h"
+#include "teamlistmodel.h"
+#include "teamsearchindex.h"
+#include "csvhotreloader.h"
+#include "changejournal.h"
+#include "journalapplier.h"
+#include "sharedgraph.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -23,7 +30,15 @@ class MainWindow : public QMainWindow
 public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
-    void setStadiumGraph(StadiumGraph* graph) { stadiumGraph = graph; }
+    void setStadiumGraph(StadiumGraph* graph);
+    // Watch imported CSVs and apply their edits while the app runs
+    void enableHotReload();
+    // Record local changes to a journal and replay journals from other kiosks
+    void setChangeJournal(ChangeJournal* journal);
+    bool replayJournal(const QString& path);
+    // Publish the graph and stadium catalog to shared memory for worker
+    // processes; republished whenever the data is refreshed
+    bool enableSharedPublishing(const QString& key);
 
 public slots:
     void refreshData();  // New slot to refresh window data
@@ -40,18 +55,29 @@ private slots:
     void displayTeamsByCapacity();
     void displayGreatestCenterField();
     void displaySmallestCenterField();
+    void displayGroupSummaries();
     void viewTeamSouvenirs();
     void on_adminLoginButton_clicked();
     void on_tripPlannerButton_clicked();
+    void selectTeam(int teamId);
 
 private:
     Ui::MainWindow *ui;
     Database *db;
     StadiumGraph* stadiumGraph = nullptr;
+    StadiumRegistry registry;
+    TeamListModel *teamModel;
+    TeamSearchIndex searchIndex;
+    CsvHotReloader *hotReloader = nullptr;
+    ChangeJournal *changeJournal = nullptr;
+    JournalApplier *journalApplier = nullptr;
+    SharedGraphPublisher *sharedPublisher = nullptr;
     void setupConnections();
     void clearResults();
     void displayQueryResults(QSqlQuery &query, const QStringList &headers);
+    void displayAggregateResults(const QVector<AggregateRow> &rows, const QString &groupHeader, bool cents);
     void loadTeams();
+    void rebuildTeamIndexes();
 };
 
 #endif // MAINWINDOW_H 
\ No newline at end of file
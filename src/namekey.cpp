@@ -0,0 +1,188 @@
+#include "namekey.h"
+
+namespace {
+
+const quint64 FnvOffset = 0xcbf29ce484222325ULL;
+const quint64 FnvPrime = 0x100000001b3ULL;
+
+// Feeds the UTF-8 encoding of name to sink one byte at a time; unpaired
+// surrogates become U+FFFD. sink returns false to stop early.
+template<typename Sink>
+bool encodeUtf8(QStringView name, Sink sink)
+{
+    const char16_t* p = name.utf16();
+    const char16_t* end = p + name.size();
+    while (p < end) {
+        char32_t c = *p++;
+        if (c < 0x80) {
+            if (!sink(char(c))) {
+                return false;
+            }
+            continue;
+        }
+        if (c >= 0xD800 && c < 0xDC00 && p < end && *p >= 0xDC00 && *p < 0xE000) {
+            c = 0x10000 + ((c - 0xD800) << 10) + (*p++ - 0xDC00);
+        } else if (c >= 0xD800 && c < 0xE000) {
+            c = 0xFFFD;
+        }
+        char bytes[4];
+        int count;
+        if (c < 0x800) {
+            bytes[0] = char(0xC0 | (c >> 6));
+            count = 1;
+        } else if (c < 0x10000) {
+            bytes[0] = char(0xE0 | (c >> 12));
+            bytes[1] = char(0x80 | ((c >> 6) & 0x3F));
+            count = 2;
+        } else {
+            bytes[0] = char(0xF0 | (c >> 18));
+            bytes[1] = char(0x80 | ((c >> 12) & 0x3F));
+            bytes[2] = char(0x80 | ((c >> 6) & 0x3F));
+            count = 3;
+        }
+        bytes[count++] = char(0x80 | (c & 0x3F));
+        for (int i = 0; i < count; ++i) {
+            if (!sink(bytes[i])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+quint64 fnv(quint64 hash, char byte)
+{
+    return (hash ^ quint8(byte)) * FnvPrime;
+}
+
+} // namespace
+
+NameKey::NameKey(QStringView name)
+{
+    quint32 size = 0;
+    quint64 hash = FnvOffset;
+    encodeUtf8(name, [&](char byte) {
+        ++size;
+        hash = fnv(hash, byte);
+        return true;
+    });
+    length = size;
+    hashValue = hash;
+    char* out = inlineData;
+    if (!isInline()) {
+        heapData = new char[size];
+        out = heapData;
+    }
+    encodeUtf8(name, [&out](char byte) {
+        *out++ = byte;
+        return true;
+    });
+}
+
+NameKey NameKey::fromUtf8(const char* data, int size)
+{
+    if (size < 0) {
+        size = int(std::strlen(data));
+    }
+    quint64 hash = FnvOffset;
+    for (int i = 0; i < size; ++i) {
+        hash = fnv(hash, data[i]);
+    }
+    NameKey key;
+    key.assign(data, quint32(size), hash);
+    return key;
+}
+
+NameKey::NameKey(const NameKey& other)
+{
+    assign(other.data(), other.length, other.hashValue);
+}
+
+NameKey::NameKey(NameKey&& other) noexcept
+    : hashValue(other.hashValue), length(other.length)
+{
+    if (isInline()) {
+        std::memcpy(inlineData, other.inlineData, length);
+    } else {
+        heapData = other.heapData;
+        other.length = 0;
+        other.hashValue = FnvOffset;
+    }
+}
+
+NameKey& NameKey::operator=(const NameKey& other)
+{
+    if (this != &other) {
+        release();
+        assign(other.data(), other.length, other.hashValue);
+    }
+    return *this;
+}
+
+NameKey& NameKey::operator=(NameKey&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        hashValue = other.hashValue;
+        length = other.length;
+        if (isInline()) {
+            std::memcpy(inlineData, other.inlineData, length);
+        } else {
+            heapData = other.heapData;
+            other.length = 0;
+            other.hashValue = FnvOffset;
+        }
+    }
+    return *this;
+}
+
+void NameKey::assign(const char* bytes, quint32 size, quint64 hash)
+{
+    length = size;
+    hashValue = hash;
+    char* out = inlineData;
+    if (!isInline()) {
+        heapData = new char[size];
+        out = heapData;
+    }
+    std::memcpy(out, bytes, size);
+}
+
+void NameKey::release()
+{
+    if (!isInline()) {
+        delete[] heapData;
+    }
+    length = 0;
+    hashValue = FnvOffset;
+}
+
+bool NameKey::equals(QStringView name) const
+{
+    const char* p = data();
+    quint32 remaining = length;
+    const bool prefix = encodeUtf8(name, [&](char byte) {
+        if (remaining == 0 || *p != byte) {
+            return false;
+        }
+        ++p;
+        --remaining;
+        return true;
+    });
+    return prefix && remaining == 0;
+}
+
+quint64 NameKey::hashOf(QStringView name)
+{
+    quint64 hash = FnvOffset;
+    encodeUtf8(name, [&hash](char byte) {
+        hash = fnv(hash, byte);
+        return true;
+    });
+    return hash;
+}
+
+QDebug operator<<(QDebug debug, const NameKey& key)
+{
+    return debug << key.toString();
+}
@@ -0,0 +1,76 @@
+#ifndef NAMEKEY_H
+#define NAMEKEY_H
+
+#include <QString>
+#include <QStringView>
+#include <QByteArray>
+#include <QDebug>
+#include <cstring>
+
+// Immutable UTF-8 name used as a key on the graph and lookup hot paths.
+// Names up to InlineCapacity bytes (nearly every normalized stadium name)
+// live inside the object, so copies are a memcpy with no allocation and no
+// atomic reference counting. The 64-bit FNV-1a hash is computed once at
+// construction; equality checks the hash before touching the bytes.
+//
+// Ordering is bytewise, which for UTF-8 is code point order and matches
+// QString ordering for the [a-z0-9] normalized names.
+class NameKey {
+public:
+    static const int InlineCapacity = 24;
+
+    NameKey() { inlineData[0] = '\0'; }
+    explicit NameKey(QStringView name);
+    explicit NameKey(const QString& name) : NameKey(QStringView(name)) {}
+    static NameKey fromUtf8(const char* data, int size = -1);
+
+    NameKey(const NameKey& other);
+    NameKey(NameKey&& other) noexcept;
+    NameKey& operator=(const NameKey& other);
+    NameKey& operator=(NameKey&& other) noexcept;
+    ~NameKey() { release(); }
+
+    const char* data() const { return isInline() ? inlineData : heapData; }
+    int size() const { return int(length); }
+    bool isEmpty() const { return length == 0; }
+    quint64 hash() const { return hashValue; }
+
+    QString toString() const { return QString::fromUtf8(data(), size()); }
+    QByteArray toUtf8() const { return QByteArray(data(), size()); }
+
+    // Compare and hash UTF-16 text as if it were converted first, without
+    // allocating; hashOf(s) == NameKey(s).hash()
+    bool equals(QStringView name) const;
+    static quint64 hashOf(QStringView name);
+
+    friend bool operator==(const NameKey& a, const NameKey& b) {
+        return a.hashValue == b.hashValue && a.length == b.length
+            && std::memcmp(a.data(), b.data(), a.length) == 0;
+    }
+    friend bool operator!=(const NameKey& a, const NameKey& b) { return !(a == b); }
+    friend bool operator<(const NameKey& a, const NameKey& b) {
+        const int c = std::memcmp(a.data(), b.data(), qMin(a.length, b.length));
+        return c != 0 ? c < 0 : a.length < b.length;
+    }
+
+private:
+    bool isInline() const { return length <= quint32(InlineCapacity); }
+    void assign(const char* bytes, quint32 size, quint64 hash);
+    void release();
+
+    quint64 hashValue = 0xcbf29ce484222325ULL;  // FNV offset basis, the empty hash
+    quint32 length = 0;
+    union {
+        char inlineData[InlineCapacity];
+        char* heapData;
+    };
+};
+
+inline size_t qHash(const NameKey& key, size_t seed = 0)
+{
+    return size_t(key.hash()) ^ seed;
+}
+
+QDebug operator<<(QDebug debug, const NameKey& key);
+
+#endif // NAMEKEY_H
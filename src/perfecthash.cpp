@@ -0,0 +1,175 @@
+#include "perfecthash.h"
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+const quint32 DirectSlot = 0x80000000u;
+const int KeysPerBucket = 3;
+const quint32 MaxDisplacement = 1u << 20;
+const int MaxSeeds = 8;
+
+} // namespace
+
+quint64 MinimalPerfectHash::mix(quint64 hash, quint32 displacement)
+{
+    // splitmix64 finalizer over the key hash and the bucket's displacement
+    quint64 z = hash + quint64(displacement) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+
+void MinimalPerfectHash::clear()
+{
+    keys.clear();
+    displacements.clear();
+    slotIds.clear();
+    built = false;
+}
+
+bool MinimalPerfectHash::build(const QVector<QString>& newKeys)
+{
+    QVector<NameKey> converted;
+    converted.reserve(newKeys.size());
+    for (const QString& key : newKeys) {
+        converted.append(NameKey(key));
+    }
+    return build(converted);
+}
+
+bool MinimalPerfectHash::build(const QVector<NameKey>& newKeys)
+{
+    clear();
+    keys = newKeys;
+    if (keys.isEmpty()) {
+        built = true;
+        return true;
+    }
+
+    QVector<quint64> hashes(keys.size());
+    for (seed = 0; seed < quint32(MaxSeeds); ++seed) {
+        for (int i = 0; i < keys.size(); ++i) {
+            hashes[i] = seeded(keys[i].hash());
+        }
+        if (tryBuild(hashes)) {
+            built = true;
+            return true;
+        }
+    }
+    qDebug() << "Minimal perfect hash failed for" << keys.size() << "keys (duplicates?)";
+    clear();
+    return false;
+}
+
+bool MinimalPerfectHash::tryBuild(const QVector<quint64>& hashes)
+{
+    const quint32 n = quint32(hashes.size());
+    const quint32 bucketCount = qMax<quint32>(1, (n + KeysPerBucket - 1) / KeysPerBucket);
+
+    // Group keys by bucket (counting sort)
+    QVector<quint32> bucketStart(bucketCount + 1, 0);
+    for (quint64 h : hashes) {
+        ++bucketStart[reduce(h >> 32, bucketCount) + 1];
+    }
+    for (quint32 b = 0; b < bucketCount; ++b) {
+        bucketStart[b + 1] += bucketStart[b];
+    }
+    QVector<quint32> members(n);
+    QVector<quint32> fill = bucketStart;
+    for (quint32 i = 0; i < n; ++i) {
+        members[fill[reduce(hashes[i] >> 32, bucketCount)]++] = i;
+    }
+
+    QVector<quint32> order(bucketCount);
+    for (quint32 b = 0; b < bucketCount; ++b) {
+        order[b] = b;
+    }
+    std::stable_sort(order.begin(), order.end(), [&bucketStart](quint32 a, quint32 b) {
+        return bucketStart[a + 1] - bucketStart[a] > bucketStart[b + 1] - bucketStart[b];
+    });
+
+    displacements.fill(0, bucketCount);
+    slotIds.fill(-1, n);
+    QVector<quint32> taken;
+    quint32 nextFree = 0;
+    for (quint32 b : order) {
+        const quint32 begin = bucketStart[b];
+        const quint32 size = bucketStart[b + 1] - begin;
+        if (size == 0) {
+            break;
+        }
+        if (size == 1) {
+            // Singletons go straight into the remaining free slots
+            while (slotIds[nextFree] >= 0) {
+                ++nextFree;
+            }
+            displacements[b] = DirectSlot | nextFree;
+            slotIds[nextFree] = qint32(members[begin]);
+            continue;
+        }
+
+        bool placed = false;
+        for (quint32 d = 1; d < MaxDisplacement && !placed; ++d) {
+            taken.clear();
+            placed = true;
+            for (quint32 k = begin; k < begin + size; ++k) {
+                const quint32 slot = reduce(mix(hashes[members[k]], d), n);
+                if (slotIds[slot] >= 0 || taken.contains(slot)) {
+                    placed = false;
+                    break;
+                }
+                taken.append(slot);
+            }
+            if (placed) {
+                displacements[b] = d;
+                for (quint32 k = 0; k < size; ++k) {
+                    slotIds[taken[k]] = qint32(members[begin + k]);
+                }
+            }
+        }
+        if (!placed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int MinimalPerfectHash::slotFor(quint64 hash) const
+{
+    // The bucket uses the high half and the slot mix the whole value
+    const quint32 n = quint32(slotIds.size());
+    const quint32 d = displacements[reduce(hash >> 32, quint32(displacements.size()))];
+    return int((d & DirectSlot) ? (d & ~DirectSlot) : reduce(mix(hash, d), n));
+}
+
+int MinimalPerfectHash::find(const NameKey& key) const
+{
+    if (slotIds.isEmpty()) {
+        return -1;
+    }
+    const qint32 id = slotIds[slotFor(seeded(key.hash()))];
+    return (id >= 0 && keys[id] == key) ? id : -1;
+}
+
+int MinimalPerfectHash::find(const QString& key) const
+{
+    if (slotIds.isEmpty()) {
+        return -1;
+    }
+    const qint32 id = slotIds[slotFor(seeded(NameKey::hashOf(key)))];
+    return (id >= 0 && keys[id].equals(key)) ? id : -1;
+}
+
+qint64 MinimalPerfectHash::memoryBytes() const
+{
+    qint64 bytes = qint64(displacements.size()) * sizeof(quint32) + qint64(slotIds.size()) * sizeof(qint32)
+                 + qint64(keys.size()) * sizeof(NameKey);
+    for (const NameKey& key : keys) {
+        if (key.size() > NameKey::InlineCapacity) {
+            bytes += key.size();
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,51 @@
+#ifndef PERFECTHASH_H
+#define PERFECTHASH_H
+
+#include <QString>
+#include <QVector>
+#include "namekey.h"
+
+// Minimal perfect hash over a fixed set of string keys (CHD, "compress,
+// hash and displace"). build() maps the i-th key to ID i; find() costs one
+// string hash, one displacement read and one verification compare, and
+// returns -1 for keys outside the set. Keys are kept as NameKeys, so a
+// NameKey lookup reuses its precomputed hash and a QString lookup hashes
+// and compares the UTF-16 text in place without converting it.
+//
+// Keys are split into buckets by their hash. Large buckets are placed first,
+// each with the smallest displacement that sends all its keys to free
+// slots; single-key buckets store their slot directly. The result uses one
+// slot per key plus about 1.3 bytes of displacements per key.
+class MinimalPerfectHash {
+public:
+    bool build(const QVector<NameKey>& keys);
+    bool build(const QVector<QString>& keys);
+    void clear();
+
+    int find(const NameKey& key) const;
+    int find(const QString& key) const;
+
+    bool isBuilt() const { return built; }
+    int size() const { return keys.size(); }
+    // The key with ID id, for 0 <= id < size()
+    const NameKey& key(int id) const { return keys[id]; }
+    qint64 memoryBytes() const;
+
+private:
+    quint64 seeded(quint64 keyHash) const { return mix(keyHash, seed); }
+    int slotFor(quint64 hash) const;
+    bool tryBuild(const QVector<quint64>& hashes);
+
+    static quint32 reduce(quint64 hash, quint32 range) {
+        return quint32((quint64(quint32(hash)) * range) >> 32);
+    }
+    static quint64 mix(quint64 hash, quint32 displacement);
+
+    QVector<NameKey> keys;
+    QVector<quint32> displacements;  // per bucket; high bit marks a direct slot
+    QVector<qint32> slotIds;         // slot -> key ID
+    quint32 seed = 0;
+    bool built = false;
+};
+
+#endif // PERFECTHASH_H
@@ -0,0 +1,527 @@
+#include "sharedgraph.h"
+#include <QHash>
+#include <QTextStream>
+#include <QDebug>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <queue>
+#include <vector>
+
+struct SharedGraphImageHeader {
+    quint32 magic;
+    quint32 version;
+    quint64 generation;
+    quint64 totalBytes;
+    quint32 nodeCount;
+    quint32 edgeCount;
+    quint32 teamCount;
+    quint32 souvenirCount;
+    quint32 nodesOffset;
+    quint32 rowStartOffset;
+    quint32 targetsOffset;
+    quint32 weightsOffset;
+    quint32 teamsOffset;
+    quint32 souvenirsOffset;
+    quint32 stringsOffset;
+    quint32 stringUnits;
+};
+
+namespace {
+
+const quint32 ImageMagic = 0x53474931;    // "SGI1"
+const quint32 ControlMagic = 0x53474331;  // "SGC1"
+const quint32 ImageVersion = 1;
+const quint32 NoNode = 0xFFFFFFFFu;
+
+// UTF-16 slice of the string pool
+struct StringRef {
+    quint32 offset;
+    quint32 length;
+};
+
+struct TeamRecord {
+    StringRef teamName;
+    StringRef stadiumName;
+    StringRef dateOpened;
+    StringRef location;
+    StringRef typology;
+    qint32 seatingCapacity;
+    qint32 distanceToCenter;
+    qint32 openedDay;
+    quint32 stadiumNode;
+    quint32 firstSouvenir;
+    quint32 souvenirCount;
+    quint8 league;
+    quint8 roofType;
+    quint8 playingSurface;
+    quint8 reserved;
+};
+
+struct SouvenirRecord {
+    StringRef name;
+    double price;
+};
+
+struct ControlBlock {
+    quint32 magic;
+    quint32 reserved;
+    std::atomic<quint64> generation;
+};
+
+static_assert(std::atomic<quint64>::is_always_lock_free,
+              "the generation counter must be lock free to live in shared memory");
+
+QString segmentKey(const QString &key, quint64 generation)
+{
+    return key + "-" + QString::number(generation);
+}
+
+quint32 align8(quint32 offset)
+{
+    return (offset + 7u) & ~7u;
+}
+
+template <typename T>
+const T *section(const SharedGraphImageHeader *header, quint32 offset)
+{
+    return reinterpret_cast<const T *>(reinterpret_cast<const char *>(header) + offset);
+}
+
+class StringPool {
+public:
+    StringRef add(const QString &text)
+    {
+        StringRef ref{quint32(units.size()), quint32(text.size())};
+        units.append(text);
+        return ref;
+    }
+    const QString &data() const { return units; }
+
+private:
+    QString units;
+};
+
+} // namespace
+
+SharedGraphPublisher::SharedGraphPublisher(const QString &key)
+    : key(key)
+    , control(key)
+{
+}
+
+SharedGraphPublisher::~SharedGraphPublisher()
+{
+    current.reset();
+    control.detach();
+}
+
+bool SharedGraphPublisher::attachControl()
+{
+    if (control.isAttached()) {
+        return true;
+    }
+    if (control.create(sizeof(ControlBlock))) {
+        ControlBlock *block = new (control.data()) ControlBlock;
+        block->magic = ControlMagic;
+        block->reserved = 0;
+        block->generation.store(0, std::memory_order_release);
+        return true;
+    }
+    // Left over from an earlier publisher; carry on from its generation
+    if (control.error() == QSharedMemory::AlreadyExists && control.attach()) {
+        const ControlBlock *block = static_cast<const ControlBlock *>(control.constData());
+        if (block->magic == ControlMagic) {
+            currentGeneration = block->generation.load(std::memory_order_acquire);
+            return true;
+        }
+        control.detach();
+    }
+    qDebug() << "Cannot create shared graph control segment:" << control.errorString();
+    return false;
+}
+
+bool SharedGraphPublisher::publish(const StadiumGraph &graph, const HashMap<QString, StadiumInfo> &stadiumMap)
+{
+    if (!attachControl()) {
+        return false;
+    }
+
+    const quint64 generation = currentGeneration + 1;
+    const QByteArray image = freeze(graph, stadiumMap, generation);
+    auto next = std::make_unique<QSharedMemory>(segmentKey(key, generation));
+    if (!next->create(image.size())) {
+        qDebug() << "Cannot create shared graph segment:" << next->errorString();
+        return false;
+    }
+    std::memcpy(next->data(), image.constData(), image.size());
+
+    // Workers see the new generation only once its segment is complete
+    ControlBlock *block = static_cast<ControlBlock *>(control.data());
+    block->generation.store(generation, std::memory_order_release);
+
+    // Workers still mapping the old generation keep it until they move on
+    current = std::move(next);
+    currentGeneration = generation;
+    qDebug() << "Published shared graph generation" << generation << "(" << image.size() << "bytes)";
+    return true;
+}
+
+QByteArray SharedGraphPublisher::freeze(const StadiumGraph &graph, const HashMap<QString, StadiumInfo> &stadiumMap,
+                                        quint64 generation)
+{
+    StringPool pool;
+
+    // Nodes in name order so workers can binary search them; key order is
+    // QString order for normalized names
+    const QVector<NameKey> nodes = graph.stadiumKeys();
+    QHash<NameKey, quint32> nodeIndex;
+    nodeIndex.reserve(nodes.size());
+    for (int i = 0; i < nodes.size(); ++i) {
+        nodeIndex.insert(nodes[i], quint32(i));
+    }
+
+    QVector<StringRef> nodeNames;
+    QVector<quint32> rowStart;
+    QVector<quint32> targets;
+    QVector<double> weights;
+    rowStart.reserve(nodes.size() + 1);
+    for (const NameKey &node : nodes) {
+        nodeNames.append(pool.add(node.toString()));
+        rowStart.append(quint32(targets.size()));
+        graph.forEachNeighbor(node, [&](const NameKey &neighbor, double distance) {
+            auto it = nodeIndex.constFind(neighbor);
+            if (it != nodeIndex.constEnd()) {
+                targets.append(it.value());
+                weights.append(distance);
+            }
+        });
+    }
+    rowStart.append(quint32(targets.size()));
+
+    auto entries = stadiumMap.getAllEntries();
+    std::sort(entries.begin(), entries.end(), [](const auto &a, const auto &b) {
+        return a.first < b.first;
+    });
+    QVector<TeamRecord> teams;
+    QVector<SouvenirRecord> souvenirs;
+    teams.reserve(entries.size());
+    for (const auto &entry : entries) {
+        const StadiumInfo &info = entry.second;
+        TeamRecord team{};
+        team.teamName = pool.add(entry.first);
+        team.stadiumName = pool.add(info.stadiumName);
+        team.dateOpened = pool.add(info.dateOpened);
+        team.location = pool.add(info.location());
+        team.typology = pool.add(info.ballparkTypology());
+        team.seatingCapacity = info.seatingCapacity;
+        team.distanceToCenter = info.distanceToCenter;
+        team.openedDay = info.openedDay;
+        team.stadiumNode = nodeIndex.value(NameKey(StadiumGraph::normalizeStadiumName(info.stadiumName)), NoNode);
+        team.firstSouvenir = quint32(souvenirs.size());
+        team.souvenirCount = quint32(info.souvenirs.size());
+        team.league = quint8(info.league);
+        team.roofType = quint8(info.roofType);
+        team.playingSurface = quint8(info.playingSurface);
+        for (const auto &souvenir : info.souvenirs) {
+            souvenirs.append(SouvenirRecord{pool.add(souvenir.first), souvenir.second});
+        }
+        teams.append(team);
+    }
+
+    SharedGraphImageHeader header{};
+    header.magic = ImageMagic;
+    header.version = ImageVersion;
+    header.generation = generation;
+    header.nodeCount = quint32(nodes.size());
+    header.edgeCount = quint32(targets.size());
+    header.teamCount = quint32(teams.size());
+    header.souvenirCount = quint32(souvenirs.size());
+    header.stringUnits = quint32(pool.data().size());
+
+    quint32 offset = align8(sizeof(SharedGraphImageHeader));
+    header.nodesOffset = offset;
+    offset = align8(offset + nodeNames.size() * sizeof(StringRef));
+    header.rowStartOffset = offset;
+    offset = align8(offset + rowStart.size() * sizeof(quint32));
+    header.targetsOffset = offset;
+    offset = align8(offset + targets.size() * sizeof(quint32));
+    header.weightsOffset = offset;
+    offset = align8(offset + weights.size() * sizeof(double));
+    header.teamsOffset = offset;
+    offset = align8(offset + teams.size() * sizeof(TeamRecord));
+    header.souvenirsOffset = offset;
+    offset = align8(offset + souvenirs.size() * sizeof(SouvenirRecord));
+    header.stringsOffset = offset;
+    offset = align8(offset + header.stringUnits * sizeof(QChar));
+    header.totalBytes = offset;
+
+    QByteArray image(offset, '\0');
+    char *base = image.data();
+    auto copy = [base](quint32 at, const void *data, size_t bytes) {
+        if (bytes > 0) {
+            std::memcpy(base + at, data, bytes);
+        }
+    };
+    copy(0, &header, sizeof(header));
+    copy(header.nodesOffset, nodeNames.constData(), nodeNames.size() * sizeof(StringRef));
+    copy(header.rowStartOffset, rowStart.constData(), rowStart.size() * sizeof(quint32));
+    copy(header.targetsOffset, targets.constData(), targets.size() * sizeof(quint32));
+    copy(header.weightsOffset, weights.constData(), weights.size() * sizeof(double));
+    copy(header.teamsOffset, teams.constData(), teams.size() * sizeof(TeamRecord));
+    copy(header.souvenirsOffset, souvenirs.constData(), souvenirs.size() * sizeof(SouvenirRecord));
+    copy(header.stringsOffset, pool.data().constData(), header.stringUnits * sizeof(QChar));
+    return image;
+}
+
+SharedGraphView::SharedGraphView(const QString &key)
+    : key(key)
+    , control(key)
+{
+}
+
+SharedGraphView::~SharedGraphView()
+{
+    segment.reset();
+    control.detach();
+}
+
+bool SharedGraphView::refresh()
+{
+    if (!control.isAttached() && !control.attach(QSharedMemory::ReadOnly)) {
+        return isAttached();
+    }
+    const ControlBlock *block = static_cast<const ControlBlock *>(control.constData());
+    if (block->magic != ControlMagic) {
+        return isAttached();
+    }
+    // The publisher may swap again while we attach; retry a few times
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        const quint64 latest = block->generation.load(std::memory_order_acquire);
+        if (latest == 0 || (header && header->generation == latest)) {
+            break;
+        }
+        if (attachGeneration(latest)) {
+            break;
+        }
+    }
+    return isAttached();
+}
+
+bool SharedGraphView::attachGeneration(quint64 generation)
+{
+    auto next = std::make_unique<QSharedMemory>(segmentKey(key, generation));
+    if (!next->attach(QSharedMemory::ReadOnly)) {
+        return false;
+    }
+    const auto *image = static_cast<const SharedGraphImageHeader *>(next->constData());
+    if (next->size() < qsizetype(sizeof(SharedGraphImageHeader)) || image->magic != ImageMagic
+        || image->version != ImageVersion || image->generation != generation
+        || image->totalBytes > quint64(next->size())) {
+        qDebug() << "Ignoring incompatible shared graph segment" << generation;
+        return false;
+    }
+    // The old mapping is released only after the new one is in place
+    segment = std::move(next);
+    header = image;
+    return true;
+}
+
+quint64 SharedGraphView::generation() const
+{
+    return header ? header->generation : 0;
+}
+
+int SharedGraphView::nodeCount() const
+{
+    return header ? int(header->nodeCount) : 0;
+}
+
+QString SharedGraphView::nodeName(int node) const
+{
+    if (node < 0 || node >= nodeCount()) {
+        return QString();
+    }
+    const StringRef ref = section<StringRef>(header, header->nodesOffset)[node];
+    return QString(section<QChar>(header, header->stringsOffset) + ref.offset, ref.length);
+}
+
+int SharedGraphView::findNode(const QString &stadiumName) const
+{
+    if (!header) {
+        return -1;
+    }
+    const QString normalized = StadiumGraph::normalizeStadiumName(stadiumName);
+    const StringRef *names = section<StringRef>(header, header->nodesOffset);
+    const QChar *strings = section<QChar>(header, header->stringsOffset);
+    const StringRef *end = names + header->nodeCount;
+    const StringRef *it = std::lower_bound(names, end, normalized, [strings](const StringRef &ref, const QString &value) {
+        return QStringView(strings + ref.offset, qsizetype(ref.length)) < QStringView(value);
+    });
+    if (it != end && QStringView(strings + it->offset, qsizetype(it->length)) == QStringView(normalized)) {
+        return int(it - names);
+    }
+    return -1;
+}
+
+QVector<QPair<int, double>> SharedGraphView::neighbors(int node) const
+{
+    QVector<QPair<int, double>> result;
+    if (node < 0 || node >= nodeCount()) {
+        return result;
+    }
+    const quint32 *rowStart = section<quint32>(header, header->rowStartOffset);
+    const quint32 *targets = section<quint32>(header, header->targetsOffset);
+    const double *weights = section<double>(header, header->weightsOffset);
+    for (quint32 e = rowStart[node]; e < rowStart[node + 1]; ++e) {
+        result.append(qMakePair(int(targets[e]), weights[e]));
+    }
+    return result;
+}
+
+double SharedGraphView::distance(const QString &from, const QString &to) const
+{
+    const int a = findNode(from);
+    const int b = findNode(to);
+    if (a < 0 || b < 0) {
+        return -1.0;
+    }
+    const quint32 *rowStart = section<quint32>(header, header->rowStartOffset);
+    const quint32 *targets = section<quint32>(header, header->targetsOffset);
+    const double *weights = section<double>(header, header->weightsOffset);
+    // Rows follow the sorted node order, so targets within a row are sorted too
+    const quint32 *first = targets + rowStart[a];
+    const quint32 *last = targets + rowStart[a + 1];
+    const quint32 *it = std::lower_bound(first, last, quint32(b));
+    return (it != last && *it == quint32(b)) ? weights[it - targets] : -1.0;
+}
+
+double SharedGraphView::dijkstra(const QString &start, const QString &end, QVector<QString> &path) const
+{
+    path.clear();
+    const int source = findNode(start);
+    const int target = findNode(end);
+    if (source < 0 || target < 0) {
+        return -1.0;
+    }
+
+    const int n = nodeCount();
+    const quint32 *rowStart = section<quint32>(header, header->rowStartOffset);
+    const quint32 *targets = section<quint32>(header, header->targetsOffset);
+    const double *weights = section<double>(header, header->weightsOffset);
+
+    std::vector<double> dist(n, std::numeric_limits<double>::infinity());
+    std::vector<int> previous(n, -1);
+    typedef std::pair<double, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    dist[source] = 0.0;
+    queue.push(Entry(0.0, source));
+    while (!queue.empty()) {
+        const Entry top = queue.top();
+        queue.pop();
+        const int u = top.second;
+        if (top.first > dist[u]) {
+            continue;
+        }
+        if (u == target) {
+            break;
+        }
+        for (quint32 e = rowStart[u]; e < rowStart[u + 1]; ++e) {
+            const int v = int(targets[e]);
+            const double candidate = dist[u] + weights[e];
+            if (candidate < dist[v]) {
+                dist[v] = candidate;
+                previous[v] = u;
+                queue.push(Entry(candidate, v));
+            }
+        }
+    }
+
+    if (dist[target] == std::numeric_limits<double>::infinity()) {
+        return -1.0;
+    }
+    for (int node = target; node != -1; node = previous[node]) {
+        path.prepend(nodeName(node));
+    }
+    return dist[target];
+}
+
+int SharedGraphView::teamCount() const
+{
+    return header ? int(header->teamCount) : 0;
+}
+
+int SharedGraphView::findTeam(const QString &teamName) const
+{
+    if (!header) {
+        return -1;
+    }
+    const TeamRecord *teams = section<TeamRecord>(header, header->teamsOffset);
+    const QChar *strings = section<QChar>(header, header->stringsOffset);
+    const TeamRecord *end = teams + header->teamCount;
+    const TeamRecord *it = std::lower_bound(teams, end, teamName, [strings](const TeamRecord &team, const QString &value) {
+        return QStringView(strings + team.teamName.offset, qsizetype(team.teamName.length)) < QStringView(value);
+    });
+    if (it != end && QStringView(strings + it->teamName.offset, qsizetype(it->teamName.length)) == QStringView(teamName)) {
+        return int(it - teams);
+    }
+    return -1;
+}
+
+StadiumInfo SharedGraphView::stadiumInfo(int team) const
+{
+    StadiumInfo info;
+    if (team < 0 || team >= teamCount()) {
+        return info;
+    }
+    const TeamRecord &record = section<TeamRecord>(header, header->teamsOffset)[team];
+    const QChar *strings = section<QChar>(header, header->stringsOffset);
+    auto text = [strings](const StringRef &ref) {
+        return QString(strings + ref.offset, ref.length);
+    };
+    info.teamName = text(record.teamName);
+    info.stadiumName = text(record.stadiumName);
+    info.dateOpened = text(record.dateOpened);
+    info.setLocation(text(record.location));
+    info.setBallparkTypology(text(record.typology));
+    info.seatingCapacity = record.seatingCapacity;
+    info.distanceToCenter = record.distanceToCenter;
+    info.openedDay = record.openedDay;
+    info.league = static_cast<League>(record.league);
+    info.roofType = static_cast<RoofType>(record.roofType);
+    info.playingSurface = static_cast<PlayingSurface>(record.playingSurface);
+
+    const SouvenirRecord *souvenirs = section<SouvenirRecord>(header, header->souvenirsOffset);
+    for (quint32 i = 0; i < record.souvenirCount; ++i) {
+        const SouvenirRecord &souvenir = souvenirs[record.firstSouvenir + i];
+        info.souvenirs.append(qMakePair(text(souvenir.name), souvenir.price));
+    }
+    return info;
+}
+
+int runSharedGraphWorker(const QString &key)
+{
+    SharedGraphView view(key);
+    if (!view.refresh()) {
+        qDebug() << "No shared graph published under" << key;
+        return 1;
+    }
+
+    QTextStream in(stdin);
+    QTextStream out(stdout);
+    QString line;
+    while (in.readLineInto(&line)) {
+        const QStringList stops = line.split(',');
+        if (stops.size() != 2) {
+            continue;
+        }
+        // Pick up a newer generation between queries
+        view.refresh();
+        QVector<QString> path;
+        const double miles = view.dijkstra(stops[0], stops[1], path);
+        out << miles << '\t' << QStringList(path.begin(), path.end()).join(',') << Qt::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+#ifndef SHAREDGRAPH_H
+#define SHAREDGRAPH_H
+
+#include <QString>
+#include <QVector>
+#include <QPair>
+#include <QByteArray>
+#include <QSharedMemory>
+#include <memory>
+#include "hashmap.h"
+#include "stadiuminfo.h"
+#include "stadiumgraph.h"
+
+struct SharedGraphImageHeader;
+
+// Frozen, pointer-free snapshot of the distance graph and stadium catalog
+// shared between processes on one machine.
+//
+// The publisher writes each generation into its own segment ("<key>-<n>")
+// and then bumps an atomic generation counter in the control segment
+// ("<key>"). Workers attach read-only and switch to the newest generation
+// in refresh(); a generation a worker still maps stays valid until it
+// detaches, so a swap never invalidates a query in flight.
+//
+// Image layout (native byte order, same build on both sides): header,
+// node names, CSR row starts / targets / weights, teams, souvenirs and a
+// UTF-16 string pool. Nodes and teams are sorted by name so lookups are
+// binary searches straight over the shared bytes.
+class SharedGraphPublisher {
+public:
+    explicit SharedGraphPublisher(const QString &key);
+    ~SharedGraphPublisher();
+
+    bool publish(const StadiumGraph &graph, const HashMap<QString, StadiumInfo> &stadiumMap);
+    quint64 generation() const { return currentGeneration; }
+
+    static QByteArray freeze(const StadiumGraph &graph, const HashMap<QString, StadiumInfo> &stadiumMap,
+                             quint64 generation);
+
+private:
+    bool attachControl();
+
+    QString key;
+    QSharedMemory control;
+    std::unique_ptr<QSharedMemory> current;
+    quint64 currentGeneration = 0;
+};
+
+class SharedGraphView {
+public:
+    explicit SharedGraphView(const QString &key);
+    ~SharedGraphView();
+
+    // Attaches to the newest published generation if it changed; returns
+    // whether a generation is mapped afterwards
+    bool refresh();
+    bool isAttached() const { return header != nullptr; }
+    quint64 generation() const;
+
+    int nodeCount() const;
+    QString nodeName(int node) const;
+    int findNode(const QString &stadiumName) const;  // -1 when unknown
+    QVector<QPair<int, double>> neighbors(int node) const;
+    double distance(const QString &from, const QString &to) const;
+    // Same contract as StadiumGraph::dijkstra: -1 when there is no path
+    double dijkstra(const QString &start, const QString &end, QVector<QString> &path) const;
+
+    int teamCount() const;
+    int findTeam(const QString &teamName) const;  // -1 when unknown
+    StadiumInfo stadiumInfo(int team) const;
+
+private:
+    bool attachGeneration(quint64 generation);
+
+    QString key;
+    QSharedMemory control;
+    std::unique_ptr<QSharedMemory> segment;
+    const SharedGraphImageHeader *header = nullptr;
+};
+
+// Headless planner worker: attaches to the shared graph and answers
+// "from,to" lines on stdin with "distance<TAB>stop,stop,..." on stdout.
+// Started with the --shared-worker <key> command line switch.
+int runSharedGraphWorker(const QString &key);
+
+#endif // SHAREDGRAPH_H
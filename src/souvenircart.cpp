@@ -0,0 +1,155 @@
+#include "souvenircart.h"
+#include <cmath>
+
+SouvenirCart::SouvenirCart()
+    : cartTotal(0), quantityTotal(0) {}
+
+qint64 SouvenirCart::toCents(double price) {
+    return qRound64(price * 100.0);
+}
+
+QString SouvenirCart::formatCents(qint64 cents) {
+    QString sign = cents < 0 ? "-" : "";
+    qint64 magnitude = cents < 0 ? -cents : cents;
+    return QString("%1%2.%3").arg(sign).arg(magnitude / 100)
+        .arg(magnitude % 100, 2, 10, QChar('0'));
+}
+
+void SouvenirCart::rebuildPriceIndex(const HashMap<QString, StadiumInfo>& stadiumMap, const StadiumRegistry& registry) {
+    // Item IDs are kept across rebuilds so existing cart lines stay meaningful
+    priceIndex.clear();
+    teamItems.clear();
+    teamItems.resize(registry.teamCount());
+    teamTotals.resize(registry.teamCount());
+
+    const QVector<QPair<QString, StadiumInfo>> entries = stadiumMap.getAllEntries();
+    for (const auto& entry : entries) {
+        int teamId = registry.teamId(entry.first);
+        if (teamId == StadiumRegistry::InvalidId) {
+            continue;
+        }
+        for (const auto& souvenir : entry.second.souvenirs) {
+            int id = itemIndex.value(souvenir.first, InvalidId);
+            if (id == InvalidId) {
+                id = itemNames.size();
+                itemNames.append(souvenir.first);
+                itemIndex.insert(souvenir.first, id);
+            }
+            if (!priceIndex.contains(key(teamId, id))) {
+                teamItems[teamId].append(id);
+            }
+            priceIndex.insert(key(teamId, id), toCents(souvenir.second));
+        }
+    }
+
+    // Re-price lines against the new index; drop items that are no longer sold
+    for (int line = lineTeams.size() - 1; line >= 0; --line) {
+        qint64 price = priceCents(lineTeams[line], lineItems[line]);
+        if (price < 0) {
+            removeLine(line);
+            continue;
+        }
+        qint64 delta = (price - lineUnitPrices[line]) * lineQuantities[line];
+        lineUnitPrices[line] = price;
+        teamTotals[lineTeams[line]] += delta;
+        cartTotal += delta;
+    }
+}
+
+int SouvenirCart::itemId(const QString& name) const {
+    return itemIndex.value(name, InvalidId);
+}
+
+QString SouvenirCart::itemName(int id) const {
+    return (id >= 0 && id < itemNames.size()) ? itemNames[id] : QString();
+}
+
+qint64 SouvenirCart::priceCents(int teamId, int id) const {
+    return priceIndex.value(key(teamId, id), -1);
+}
+
+const QVector<int>& SouvenirCart::itemsForTeam(int teamId) const {
+    static const QVector<int> empty;
+    return (teamId >= 0 && teamId < teamItems.size()) ? teamItems[teamId] : empty;
+}
+
+bool SouvenirCart::addQuantity(int teamId, int id, int quantity) {
+    return setQuantity(teamId, id, quantityFor(teamId, id) + quantity);
+}
+
+bool SouvenirCart::setQuantity(int teamId, int id, int quantity) {
+    if (quantity < 0) {
+        return false;
+    }
+    qint64 price = priceCents(teamId, id);
+    if (price < 0) {
+        return false;
+    }
+    quint64 lineKey = key(teamId, id);
+    int line = lineIndex.value(lineKey, InvalidId);
+    if (line == InvalidId) {
+        if (quantity == 0) {
+            return true;
+        }
+        line = lineTeams.size();
+        lineTeams.append(teamId);
+        lineItems.append(id);
+        lineQuantities.append(0);
+        lineUnitPrices.append(price);
+        lineIndex.insert(lineKey, line);
+    }
+
+    int delta = quantity - lineQuantities[line];
+    qint64 deltaCents = lineUnitPrices[line] * delta;
+    lineQuantities[line] = quantity;
+    teamTotals[teamId] += deltaCents;
+    cartTotal += deltaCents;
+    quantityTotal += delta;
+
+    if (quantity == 0) {
+        removeLine(line);
+    }
+    return true;
+}
+
+void SouvenirCart::removeLine(int line) {
+    // Swap with the last line so removal is O(1)
+    qint64 lineCents = lineTotalCents(line);
+    teamTotals[lineTeams[line]] -= lineCents;
+    cartTotal -= lineCents;
+    quantityTotal -= lineQuantities[line];
+    lineIndex.remove(key(lineTeams[line], lineItems[line]));
+
+    int last = lineTeams.size() - 1;
+    if (line != last) {
+        lineTeams[line] = lineTeams[last];
+        lineItems[line] = lineItems[last];
+        lineQuantities[line] = lineQuantities[last];
+        lineUnitPrices[line] = lineUnitPrices[last];
+        lineIndex.insert(key(lineTeams[line], lineItems[line]), line);
+    }
+    lineTeams.removeLast();
+    lineItems.removeLast();
+    lineQuantities.removeLast();
+    lineUnitPrices.removeLast();
+}
+
+void SouvenirCart::clear() {
+    lineTeams.clear();
+    lineItems.clear();
+    lineQuantities.clear();
+    lineUnitPrices.clear();
+    lineIndex.clear();
+    teamTotals.fill(0);
+    cartTotal = 0;
+    quantityTotal = 0;
+}
+
+int SouvenirCart::quantityFor(int teamId, int id) const {
+    int line = lineIndex.value(key(teamId, id), InvalidId);
+    return line == InvalidId ? 0 : lineQuantities[line];
+}
+
+qint64 SouvenirCart::teamTotalCents(int teamId) const {
+    return (teamId >= 0 && teamId < teamTotals.size()) ? teamTotals[teamId] : 0;
+}
@@ -0,0 +1,72 @@
+#ifndef SOUVENIRCART_H
+#define SOUVENIRCART_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include "hashmap.h"
+#include "stadiuminfo.h"
+#include "stadiumregistry.h"
+
+// Souvenir cart with exact integer-cent pricing.
+// Prices are indexed by (team ID, item ID) once per rebuildPriceIndex(); cart
+// lines live in flat parallel arrays and the totals are adjusted as quantities
+// change, so pricing a cart never rescans StadiumInfo::souvenirs.
+class SouvenirCart {
+public:
+    static const int InvalidId = -1;
+
+    SouvenirCart();
+
+    void rebuildPriceIndex(const HashMap<QString, StadiumInfo>& stadiumMap, const StadiumRegistry& registry);
+
+    static qint64 toCents(double price);
+    static QString formatCents(qint64 cents);
+
+    int itemId(const QString& itemName) const;
+    QString itemName(int itemId) const;
+    qint64 priceCents(int teamId, int itemId) const;  // -1 when the team does not sell the item
+    const QVector<int>& itemsForTeam(int teamId) const;
+
+    // Quantity changes; a resulting quantity of 0 drops the line
+    bool addQuantity(int teamId, int itemId, int quantity);
+    bool setQuantity(int teamId, int itemId, int quantity);
+    void clear();
+
+    int lineCount() const { return lineTeams.size(); }
+    int lineTeam(int line) const { return lineTeams[line]; }
+    int lineItem(int line) const { return lineItems[line]; }
+    int lineQuantity(int line) const { return lineQuantities[line]; }
+    qint64 lineUnitCents(int line) const { return lineUnitPrices[line]; }
+    qint64 lineTotalCents(int line) const { return lineUnitPrices[line] * lineQuantities[line]; }
+    int quantityFor(int teamId, int itemId) const;
+
+    qint64 totalCents() const { return cartTotal; }
+    qint64 teamTotalCents(int teamId) const;
+    int totalQuantity() const { return quantityTotal; }
+
+private:
+    static quint64 key(int teamId, int itemId) {
+        return (quint64(quint32(teamId)) << 32) | quint32(itemId);
+    }
+    void removeLine(int line);
+
+    // Item dictionary and price index
+    QHash<QString, int> itemIndex;
+    QVector<QString> itemNames;
+    QHash<quint64, qint64> priceIndex;
+    QVector<QVector<int>> teamItems;
+
+    // Cart lines, one entry per (team, item)
+    QVector<int> lineTeams;
+    QVector<int> lineItems;
+    QVector<int> lineQuantities;
+    QVector<qint64> lineUnitPrices;
+    QHash<quint64, int> lineIndex;
+
+    QVector<qint64> teamTotals;
+    qint64 cartTotal;
+    int quantityTotal;
+};
+
+#endif // SOUVENIRCART_H
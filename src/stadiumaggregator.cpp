@@ -0,0 +1,210 @@
+#include "stadiumaggregator.h"
+#include <algorithm>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define STADIUM_AGGREGATOR_AVX2 1
+#endif
+
+namespace {
+
+void reduceScalar(const qint32* values, int count, qint64& sum, qint32& min, qint32& max)
+{
+    qint64 total = 0;
+    qint32 lo = std::numeric_limits<qint32>::max();
+    qint32 hi = std::numeric_limits<qint32>::min();
+    for (int i = 0; i < count; ++i) {
+        total += values[i];
+        lo = qMin(lo, values[i]);
+        hi = qMax(hi, values[i]);
+    }
+    sum = total;
+    min = lo;
+    max = hi;
+}
+
+#ifdef STADIUM_AGGREGATOR_AVX2
+// Eight values per step; sums are widened to 64-bit lanes so large runs of
+// cents cannot overflow
+__attribute__((target("avx2")))
+void reduceAvx2(const qint32* values, int count, qint64& sum, qint32& min, qint32& max)
+{
+    __m256i sumAcc = _mm256_setzero_si256();
+    __m256i minAcc = _mm256_set1_epi32(std::numeric_limits<qint32>::max());
+    __m256i maxAcc = _mm256_set1_epi32(std::numeric_limits<qint32>::min());
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        sumAcc = _mm256_add_epi64(sumAcc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+        sumAcc = _mm256_add_epi64(sumAcc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+        minAcc = _mm256_min_epi32(minAcc, v);
+        maxAcc = _mm256_max_epi32(maxAcc, v);
+    }
+
+    alignas(32) qint64 sumLanes[4];
+    alignas(32) qint32 minLanes[8];
+    alignas(32) qint32 maxLanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(sumLanes), sumAcc);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(minLanes), minAcc);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(maxLanes), maxAcc);
+    qint64 total = sumLanes[0] + sumLanes[1] + sumLanes[2] + sumLanes[3];
+    qint32 lo = minLanes[0];
+    qint32 hi = maxLanes[0];
+    for (int lane = 1; lane < 8; ++lane) {
+        lo = qMin(lo, minLanes[lane]);
+        hi = qMax(hi, maxLanes[lane]);
+    }
+    for (; i < count; ++i) {
+        total += values[i];
+        lo = qMin(lo, values[i]);
+        hi = qMax(hi, values[i]);
+    }
+    sum = total;
+    min = lo;
+    max = hi;
+}
+#endif
+
+} // namespace
+
+quint32 StadiumAggregator::encode(QHash<QString, quint32>& index, QVector<QString>& names, const QString& value)
+{
+    auto it = index.constFind(value);
+    if (it != index.constEnd()) {
+        return it.value();
+    }
+    quint32 code = quint32(names.size());
+    names.append(value);
+    index.insert(value, code);
+    return code;
+}
+
+void StadiumAggregator::rebuild(const HashMap<QString, StadiumInfo>& stadiumMap)
+{
+    capacity.clear();
+    centerField.clear();
+    priceCents.clear();
+    souvenirTeam.clear();
+    itemCode.clear();
+    for (int key = 0; key <= GroupBySouvenirItem; ++key) {
+        teamCode[key].clear();
+        groupLabels[key].clear();
+    }
+
+    // Enum-backed keys use the enum value as the code directly
+    groupLabels[GroupByNone] << "All";
+    groupLabels[GroupByLeague] << leagueName(League::Unknown) << leagueName(League::American)
+                               << leagueName(League::National);
+    groupLabels[GroupByRoof] << roofTypeName(RoofType::Unknown) << roofTypeName(RoofType::Open)
+                             << roofTypeName(RoofType::Retractable) << roofTypeName(RoofType::Fixed);
+    groupLabels[GroupBySurface] << playingSurfaceName(PlayingSurface::Unknown)
+                                << playingSurfaceName(PlayingSurface::Grass)
+                                << playingSurfaceName(PlayingSurface::ArtificialTurf);
+
+    QHash<QString, quint32> typologyIndex;
+    QHash<QString, quint32> itemIndex;
+    stadiumMap.forEach([&](const QString& teamName, const StadiumInfo& info) {
+        int row = capacity.size();
+        capacity.append(info.seatingCapacity);
+        centerField.append(info.distanceToCenter);
+        teamCode[GroupByNone].append(0);
+        teamCode[GroupByLeague].append(quint32(info.league));
+        teamCode[GroupByTypology].append(encode(typologyIndex, groupLabels[GroupByTypology],
+                                                info.ballparkTypology()));
+        teamCode[GroupByRoof].append(quint32(info.roofType));
+        teamCode[GroupBySurface].append(quint32(info.playingSurface));
+        teamCode[GroupByTeam].append(quint32(row));
+        groupLabels[GroupByTeam].append(teamName);
+
+        for (const auto& souvenir : info.souvenirs) {
+            priceCents.append(qint32(qRound64(souvenir.second * 100.0)));
+            souvenirTeam.append(row);
+            itemCode.append(encode(itemIndex, groupLabels[GroupBySouvenirItem], souvenir.first));
+        }
+    });
+}
+
+const QVector<quint32>& StadiumAggregator::teamCodes(GroupBy groupBy) const
+{
+    return teamCode[groupBy];
+}
+
+const QVector<QString>& StadiumAggregator::labels(GroupBy groupBy) const
+{
+    return groupLabels[groupBy];
+}
+
+bool StadiumAggregator::hasSimdSupport()
+{
+#ifdef STADIUM_AGGREGATOR_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+QVector<AggregateRow> StadiumAggregator::aggregate(GroupBy groupBy, Measure measure) const
+{
+    QVector<AggregateRow> rows;
+    const bool souvenirRows = measure == MeasureSouvenirPrice;
+    if (groupBy == GroupBySouvenirItem && !souvenirRows) {
+        return rows;
+    }
+
+    // Resolve the measure column and the group code of every row
+    const QVector<qint32>& values = souvenirRows ? priceCents
+                                  : (measure == MeasureCapacity ? capacity : centerField);
+    const QVector<quint32>& codes = teamCodes(groupBy);
+    const int groupCount = labels(groupBy).size();
+    auto codeAt = [&](int row) -> int {
+        if (!souvenirRows) return codes[row];
+        return groupBy == GroupBySouvenirItem ? itemCode[row] : codes[souvenirTeam[row]];
+    };
+    auto included = [&](int row) {
+        return souvenirRows || values[row] > 0;
+    };
+
+    // Counting sort the values into one contiguous run per group
+    QVector<int> offsets(groupCount + 1, 0);
+    for (int row = 0; row < values.size(); ++row) {
+        if (included(row)) {
+            ++offsets[codeAt(row) + 1];
+        }
+    }
+    for (int g = 0; g < groupCount; ++g) {
+        offsets[g + 1] += offsets[g];
+    }
+    QVector<qint32> grouped(offsets[groupCount]);
+    QVector<int> cursor = offsets;
+    for (int row = 0; row < values.size(); ++row) {
+        if (included(row)) {
+            grouped[cursor[codeAt(row)]++] = values[row];
+        }
+    }
+
+    void (*reduce)(const qint32*, int, qint64&, qint32&, qint32&) = reduceScalar;
+#ifdef STADIUM_AGGREGATOR_AVX2
+    if (hasSimdSupport()) {
+        reduce = reduceAvx2;
+    }
+#endif
+    for (int g = 0; g < groupCount; ++g) {
+        int count = offsets[g + 1] - offsets[g];
+        if (count == 0) {
+            continue;
+        }
+        AggregateRow row;
+        row.group = labels(groupBy)[g];
+        row.count = count;
+        const qint32* run = grouped.constData() + offsets[g];
+        reduce(run, count, row.sum, row.min, row.max);
+        row.average = double(row.sum) / count;
+        rows.append(row);
+    }
+
+    std::sort(rows.begin(), rows.end(), [](const AggregateRow& a, const AggregateRow& b) {
+        return a.group < b.group;
+    });
+    return rows;
+}
@@ -0,0 +1,57 @@
+#ifndef STADIUMAGGREGATOR_H
+#define STADIUMAGGREGATOR_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include "hashmap.h"
+#include "stadiuminfo.h"
+
+struct AggregateRow {
+    QString group;
+    qint64 count = 0;
+    qint64 sum = 0;
+    qint32 min = 0;
+    qint32 max = 0;
+    double average = 0.0;
+};
+
+// Group-by aggregation over a columnar copy of the stadium map.
+// Group keys are small dictionary codes; a query counting-sorts the measure
+// into one contiguous run per group and reduces each run with AVX2 when the
+// CPU supports it. Capacity and center field values of 0 mean "unknown" and
+// are skipped; souvenir prices are aggregated in cents.
+class StadiumAggregator {
+public:
+    enum GroupBy { GroupByNone, GroupByLeague, GroupByTypology, GroupByRoof,
+                   GroupBySurface, GroupByTeam, GroupBySouvenirItem };
+    enum Measure { MeasureCapacity, MeasureCenterField, MeasureSouvenirPrice };
+
+    void rebuild(const HashMap<QString, StadiumInfo>& stadiumMap);
+
+    // One row per non-empty group, ordered by group label. Grouping by
+    // souvenir item is only meaningful for MeasureSouvenirPrice.
+    QVector<AggregateRow> aggregate(GroupBy groupBy, Measure measure) const;
+
+    static bool hasSimdSupport();
+
+private:
+    const QVector<quint32>& teamCodes(GroupBy groupBy) const;
+    const QVector<QString>& labels(GroupBy groupBy) const;
+    static quint32 encode(QHash<QString, quint32>& index, QVector<QString>& names, const QString& value);
+
+    // Team rows
+    QVector<qint32> capacity;
+    QVector<qint32> centerField;
+    QVector<quint32> teamCode[GroupBySouvenirItem + 1];
+
+    // Souvenir rows
+    QVector<qint32> priceCents;
+    QVector<int> souvenirTeam;
+    QVector<quint32> itemCode;
+
+    // Group labels per key, indexed by code
+    QVector<QString> groupLabels[GroupBySouvenirItem + 1];
+};
+
+#endif // STADIUMAGGREGATOR_H
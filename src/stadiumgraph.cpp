@@ -5,7 +5,12 @@
 #include <QDebug>
 #include <QRegularExpression>
 #include <QtGlobal>
+#include <QHash>
+#include <algorithm>
+#include <memory>
 #include "stadiumgraph.h"
+#include "changejournal.h"
+#include "defaultdata.h"
 
 StadiumGraph::StadiumGraph() {}
 
@@ -36,8 +41,10 @@ void StadiumGraph::addStadium(const QString& name) {
     if (norm.isEmpty()) {
         return;
     }
-    if (!adjMatrix.contains(norm)) {
-        adjMatrix[norm] = QMap<QString, double>();
+    NameKey key(norm);
+    if (!adjMatrix.contains(key)) {
+        thaw();
+        adjMatrix[key] = QMap<NameKey, double>();
     }
 }
 
@@ -52,37 +59,339 @@ void StadiumGraph::addEdge(const QString& from, const QString& to, double distan
     }
     addStadium(nFrom);
     addStadium(nTo);
-    if (!adjMatrix.contains(nFrom) || !adjMatrix.contains(nTo)) {
+    NameKey fromKey(nFrom);
+    NameKey toKey(nTo);
+    if (!adjMatrix.contains(fromKey) || !adjMatrix.contains(toKey)) {
         return;
     }
-    adjMatrix[nFrom][nTo] = distance;
-    adjMatrix[nTo][nFrom] = distance;
+    thaw();
+    adjMatrix[fromKey][toKey] = distance;
+    adjMatrix[toKey][fromKey] = distance;
+    if (journal) {
+        journal->edgeSet(nFrom, nTo, distance);
+    }
 }
 
-double StadiumGraph::getDistance(const QString& from, const QString& to) const {
+bool StadiumGraph::removeEdge(const QString& from, const QString& to) {
     QString nFrom = normalizeStadiumName(from);
     QString nTo = normalizeStadiumName(to);
-    if (adjMatrix.contains(nFrom) && adjMatrix[nFrom].contains(nTo)) {
-        return adjMatrix[nFrom][nTo];
+    NameKey fromKey(nFrom);
+    NameKey toKey(nTo);
+    auto fromIt = adjMatrix.find(fromKey);
+    auto toIt = adjMatrix.find(toKey);
+    if (fromIt == adjMatrix.end() || toIt == adjMatrix.end()) {
+        return false;
+    }
+    // Stadiums stay in the graph even when their last edge goes
+    thaw();
+    bool removed = fromIt.value().remove(toKey) > 0;
+    toIt.value().remove(fromKey);
+    if (removed && journal) {
+        journal->edgeRemoved(nFrom, nTo);
+    }
+    return removed;
+}
+
+double StadiumGraph::getDistance(const QString& from, const QString& to) const {
+    return getEdgeWeight(normalizeStadiumName(from), normalizeStadiumName(to));
+}
+
+// Same as getDistance but for names that are already normalized; skips the regex pass
+double StadiumGraph::getEdgeWeight(const QString& normalizedFrom, const QString& normalizedTo) const {
+    return getEdgeWeight(NameKey(normalizedFrom), NameKey(normalizedTo));
+}
+
+double StadiumGraph::getEdgeWeight(const NameKey& normalizedFrom, const NameKey& normalizedTo) const {
+    if (isFrozen()) {
+        const int from = frozenNodes.find(normalizedFrom);
+        const int to = frozenNodes.find(normalizedTo);
+        if (from < 0 || to < 0) {
+            return -1.0;
+        }
+        return frozenWeight(from, to);
+    }
+    auto fromIt = adjMatrix.constFind(normalizedFrom);
+    if (fromIt == adjMatrix.constEnd()) {
+        return -1.0;
+    }
+    auto toIt = fromIt.value().constFind(normalizedTo);
+    if (toIt == fromIt.value().constEnd()) {
+        return -1.0;
+    }
+    return toIt.value();
+}
+
+double StadiumGraph::frozenWeight(int from, int to) const {
+    auto first = frozenTargets.constBegin() + frozenRowStart[from];
+    auto last = frozenTargets.constBegin() + frozenRowStart[from + 1];
+    auto it = std::lower_bound(first, last, to);
+    return (it != last && *it == to) ? frozenWeights[it - frozenTargets.constBegin()] : -1.0;
+}
+
+void StadiumGraph::freeze() {
+    QVector<NameKey> keys = adjMatrix.keys().toVector();
+    buildRows(frozenRowStart, frozenTargets, frozenWeights);
+    if (order != NodeOrder::KeyOrder) {
+        // The perfect hash maps names to the new IDs, so renaming its keys
+        // is all the external mapping needs
+        const QVector<int> permutation = GraphOrder::compute(order, frozenRowStart, frozenTargets);
+        GraphOrder::permuteRows(permutation, frozenRowStart, frozenTargets, frozenWeights);
+        QVector<NameKey> renamed;
+        renamed.reserve(keys.size());
+        for (int old : permutation) {
+            renamed.append(keys[old]);
+        }
+        keys.swap(renamed);
+    }
+    if (!frozenNodes.build(keys)) {
+        thaw();
+        return;
+    }
+    if (keys.size() <= DenseAdjacency::MaxNodes) {
+        frozenDense.build(frozenRowStart, frozenTargets, frozenWeights);
+    } else {
+        frozenDense.clear();
+    }
+}
+
+void StadiumGraph::buildRows(QVector<int>& rowStart, QVector<int>& targets, QVector<double>& weights) const {
+    // Node IDs follow the map's key order, so each row's targets come out sorted
+    const QVector<NameKey> keys = adjMatrix.keys().toVector();
+    QHash<NameKey, int> ids;
+    ids.reserve(keys.size());
+    for (int i = 0; i < keys.size(); ++i) {
+        ids.insert(keys[i], i);
+    }
+    rowStart.clear();
+    targets.clear();
+    weights.clear();
+    rowStart.reserve(keys.size() + 1);
+    for (auto row = adjMatrix.constBegin(); row != adjMatrix.constEnd(); ++row) {
+        rowStart.append(targets.size());
+        for (auto edge = row.value().constBegin(); edge != row.value().constEnd(); ++edge) {
+            auto id = ids.constFind(edge.key());
+            if (id != ids.constEnd()) {
+                targets.append(id.value());
+                weights.append(edge.value());
+            }
+        }
+    }
+    rowStart.append(targets.size());
+}
+
+GraphValidationReport StadiumGraph::validate(const QVector<QString>& teamStadiums, int maxIssues) const {
+    // A frozen graph already has its rows; a thawed one builds them once
+    QVector<int> rowStart;
+    QVector<int> targets;
+    QVector<double> weights;
+    if (!isFrozen()) {
+        buildRows(rowStart, targets, weights);
+    }
+    // Frozen rows may be renumbered; name them in their own order
+    QVector<NameKey> keys;
+    if (isFrozen()) {
+        keys.reserve(frozenNodes.size());
+        for (int id = 0; id < frozenNodes.size(); ++id) {
+            keys.append(frozenNodes.key(id));
+        }
+    } else {
+        keys = stadiumKeys();
+    }
+    QVector<bool> known;
+    if (!teamStadiums.isEmpty()) {
+        QSet<NameKey> stadiums;
+        for (const QString& name : teamStadiums) {
+            const QString norm = normalizeStadiumName(name);
+            if (!norm.isEmpty()) {
+                stadiums.insert(NameKey(norm));
+            }
+        }
+        known.resize(keys.size());
+        for (int i = 0; i < keys.size(); ++i) {
+            known[i] = stadiums.contains(keys[i]);
+        }
+    }
+    auto nodeName = [&keys](int node) { return keys[node].toString(); };
+    GraphValidationReport report = isFrozen()
+        ? GraphValidator::validate(frozenRowStart, frozenTargets, frozenWeights, nodeName, known, maxIssues)
+        : GraphValidator::validate(rowStart, targets, weights, nodeName, known, maxIssues);
+    // The map holds one weight per pair, so duplicates only survive as the
+    // conflicts the last CSV merge resolved
+    for (const GraphIssue& issue : mergeConflicts) {
+        ++report.counts[GraphIssue::ConflictingDuplicate];
+        if (report.issues.size() < maxIssues) {
+            report.issues.append(issue);
+        } else {
+            report.truncated = true;
+        }
+    }
+    return report;
+}
+
+void StadiumGraph::setNodeOrder(NodeOrder nodeOrder) {
+    if (order == nodeOrder) {
+        return;
+    }
+    thaw();
+    order = nodeOrder;
+}
+
+void StadiumGraph::thaw() {
+    if (!frozenNodes.isBuilt()) {
+        return;
+    }
+    frozenNodes.clear();
+    frozenRowStart.clear();
+    frozenTargets.clear();
+    frozenWeights.clear();
+    frozenDense.clear();
+}
+
+template<typename Fn>
+auto StadiumGraph::withFrozenAdjacency(Fn fn) const {
+    if (!frozenDense.isEmpty()) {
+        return GraphKernels::dispatchSize(frozenDense.size(), [&](auto maxNodes) {
+            return fn(frozenDense, maxNodes);
+        });
+    }
+    const CsrAdjacency rows(frozenRowStart, frozenTargets, frozenWeights);
+    return GraphKernels::dispatchSize(rows.size(), [&](auto maxNodes) {
+        return fn(rows, maxNodes);
+    });
+}
+
+// The kernels pick routes with float sums; mileage is re-summed from the
+// double weights so frozen and thawed graphs report the same totals
+double StadiumGraph::frozenDijkstra(const QString& start, const QString& end, QVector<QString>& path) const {
+    path.clear();
+    const QString nStart = normalizeStadiumName(start);
+    const QString nEnd = normalizeStadiumName(end);
+    const int source = nStart.isEmpty() ? -1 : frozenNodes.find(nStart);
+    const int target = nEnd.isEmpty() ? -1 : frozenNodes.find(nEnd);
+    if (source < 0 || target < 0) {
+        return -1.0;
+    }
+    // Above the dense threshold a heap beats scanning every node per step
+    QVector<int> nodes;
+    const bool found = frozenDense.isEmpty()
+        ? GraphKernels::shortestPathSparse(CsrAdjacency(frozenRowStart, frozenTargets, frozenWeights),
+                                           source, target, nodes)
+        : withFrozenAdjacency([&](const auto& graph, auto maxNodes) {
+              return GraphKernels::shortestPath<decltype(maxNodes)::value>(graph, source, target, nodes);
+          });
+    if (!found) {
+        return -1.0;
     }
-    return -1.0;
+    double total = 0.0;
+    for (int i = 0; i < nodes.size(); ++i) {
+        path.append(frozenNodes.key(nodes[i]).toString());
+        if (i > 0) {
+            total += frozenWeight(nodes[i - 1], nodes[i]);
+        }
+    }
+    return total;
+}
+
+double StadiumGraph::frozenSpanningTree(QVector<QPair<QString, QString>>& mstEdges) const {
+    QVector<QPair<int, int>> edges;
+    const bool connected = withFrozenAdjacency([&](const auto& graph, auto maxNodes) {
+        return GraphKernels::spanningTree<decltype(maxNodes)::value>(graph, edges);
+    });
+    mstEdges.clear();
+    if (!connected) {
+        return 0.0;
+    }
+    double totalWeight = 0.0;
+    for (const auto& edge : edges) {
+        mstEdges.append(qMakePair(frozenNodes.key(edge.first).toString(), frozenNodes.key(edge.second).toString()));
+        totalWeight += frozenWeight(edge.first, edge.second);
+    }
+    return totalWeight;
+}
+
+double StadiumGraph::frozenGreedyTrip(const QString& start, const QVector<QString>& stops, QVector<QString>& order) const {
+    const QString nStart = normalizeStadiumName(start);
+    const int startId = nStart.isEmpty() ? -1 : frozenNodes.find(nStart);
+    if (startId < 0) {
+        qDebug() << "Start stadium not found:" << start << "(normalized:" << nStart << ")";
+        return -1.0;
+    }
+    if (stops.isEmpty()) {
+        qDebug() << "No stops provided for trip";
+        return -1.0;
+    }
+    QVector<int> stopIds;
+    stopIds.reserve(stops.size());
+    for (const QString& stop : stops) {
+        const QString nStop = normalizeStadiumName(stop);
+        const int id = nStop.isEmpty() ? -1 : frozenNodes.find(nStop);
+        if (id < 0) {
+            qDebug() << "Stop stadium not found:" << stop << "(normalized:" << nStop << ")";
+            return -1.0;
+        }
+        stopIds.append(id);
+    }
+
+    QVector<int> nodes;
+    const bool complete = withFrozenAdjacency([&](const auto& graph, auto maxNodes) {
+        return GraphKernels::nearestNeighbourTour<decltype(maxNodes)::value>(graph, startId, stopIds, nodes);
+    });
+    order.clear();
+    double totalDistance = 0.0;
+    for (int i = 0; i < nodes.size(); ++i) {
+        order.append(frozenNodes.key(nodes[i]).toString());
+        if (i > 0) {
+            totalDistance += frozenWeight(nodes[i - 1], nodes[i]);
+        }
+    }
+    if (!complete) {
+        qDebug() << "No path found to remaining stops from" << order.last();
+        return -1.0;
+    }
+    return totalDistance;
+}
+
+void StadiumGraph::publish() {
+    freeze();
+    std::shared_ptr<StadiumGraph> copy = std::make_shared<StadiumGraph>(*this);
+    copy->journal = nullptr;
+    copy->published.reset();
+    std::atomic_store(&published, Snapshot(std::move(copy)));
+}
+
+StadiumGraph::Snapshot StadiumGraph::snapshot() const {
+    Snapshot current = std::atomic_load(&published);
+    if (!current) {
+        static const Snapshot empty = std::make_shared<const StadiumGraph>();
+        return empty;
+    }
+    return current;
 }
 
 QVector<QString> StadiumGraph::getStadiums() const {
-    return adjMatrix.keys().toVector();
+    QVector<QString> stadiums;
+    stadiums.reserve(adjMatrix.size());
+    for (auto it = adjMatrix.constBegin(); it != adjMatrix.constEnd(); ++it) {
+        stadiums.append(it.key().toString());
+    }
+    return stadiums;
 }
 
 QVector<QPair<QString, double>> StadiumGraph::getNeighbors(const QString& stadium) const {
     QVector<QPair<QString, double>> neighbors;
-    if (adjMatrix.contains(stadium)) {
-        for (auto it = adjMatrix[stadium].begin(); it != adjMatrix[stadium].end(); ++it) {
-            neighbors.append(qMakePair(it.key(), it.value()));
+    auto row = adjMatrix.constFind(NameKey(stadium));
+    if (row != adjMatrix.constEnd()) {
+        for (auto it = row.value().constBegin(); it != row.value().constEnd(); ++it) {
+            neighbors.append(qMakePair(it.key().toString(), it.value()));
         }
     }
     return neighbors;
 }
 
 double StadiumGraph::dijkstra(const QString& start, const QString& end, QVector<QString>& path) const {
+    if (isFrozen()) {
+        return frozenDijkstra(start, end, path);
+    }
     try {
         QString nStart = normalizeStadiumName(start);
         QString nEnd = normalizeStadiumName(end);
@@ -92,24 +401,26 @@ double StadiumGraph::dijkstra(const QString& start, const QString& end, QVector<
         return -1.0;
     }
 
-        if (!adjMatrix.contains(nStart) || !adjMatrix.contains(nEnd)) {
+        NameKey startKey(nStart);
+        NameKey endKey(nEnd);
+        if (!adjMatrix.contains(startKey) || !adjMatrix.contains(endKey)) {
             path.clear();
             return -1.0;
         }
 
-    QMap<QString, double> distances;
-    QMap<QString, QString> previous;
-    QSet<QString> unvisited;
+    QMap<NameKey, double> distances;
+    QMap<NameKey, NameKey> previous;
+    QSet<NameKey> unvisited;
     
-    for (const QString& stadium : adjMatrix.keys()) {
-            if (stadium.trimmed().isEmpty()) {
+    for (const NameKey& stadium : adjMatrix.keys()) {
+            if (stadium.isEmpty()) {
                 continue;
             }
         distances[stadium] = std::numeric_limits<double>::infinity();
         unvisited.insert(stadium);
     }
         
-        distances[nStart] = 0;
+        distances[startKey] = 0;
 
         int iterationCount = 0;
         const int MAX_ITERATIONS = adjMatrix.size() * 2;
@@ -117,10 +428,10 @@ double StadiumGraph::dijkstra(const QString& start, const QString& end, QVector<
         while (!unvisited.isEmpty() && iterationCount < MAX_ITERATIONS) {
             iterationCount++;
             
-        QString current;
+        NameKey current;
         double minDist = std::numeric_limits<double>::infinity();
             
-        for (const QString& stadium : unvisited) {
+        for (const NameKey& stadium : unvisited) {
                 if (!distances.contains(stadium)) {
                     continue;
                 }
@@ -134,7 +445,7 @@ double StadiumGraph::dijkstra(const QString& start, const QString& end, QVector<
                 break;
             }
             
-            if (current == nEnd) {
+            if (current == endKey) {
                 break;
         }
 
@@ -147,9 +458,9 @@ double StadiumGraph::dijkstra(const QString& start, const QString& end, QVector<
             const auto& neighbors = adjMatrix[current];
             
             for (auto it = neighbors.begin(); it != neighbors.end(); ++it) {
-            const QString& neighbor = it.key();
+            const NameKey& neighbor = it.key();
                 
-                if (neighbor.trimmed().isEmpty()) {
+                if (neighbor.isEmpty()) {
                     continue;
                 }
                 
@@ -179,23 +490,23 @@ double StadiumGraph::dijkstra(const QString& start, const QString& end, QVector<
         }
 
         path.clear();
-        if (!distances.contains(nEnd) || distances[nEnd] == std::numeric_limits<double>::infinity()) {
+        if (!distances.contains(endKey) || distances[endKey] == std::numeric_limits<double>::infinity()) {
             return -1.0;
         }
         
-        QString current = nEnd;
-        QSet<QString> visitedForLoop;
+        NameKey current = endKey;
+        QSet<NameKey> visitedForLoop;
         int pathLength = 0;
         const int MAX_PATH_LENGTH = adjMatrix.size() + 1;
         
-        while (current != nStart && pathLength < MAX_PATH_LENGTH) {
+        while (current != startKey && pathLength < MAX_PATH_LENGTH) {
             if (visitedForLoop.contains(current)) {
     path.clear();
                 return -1.0;
     }
 
             visitedForLoop.insert(current);
-        path.prepend(current);
+        path.prepend(current.toString());
             pathLength++;
             
             if (!previous.contains(current)) {
@@ -218,7 +529,7 @@ double StadiumGraph::dijkstra(const QString& start, const QString& end, QVector<
             return -1.0;
         }
         
-        return distances[nEnd];
+        return distances[endKey];
         
     } catch (...) {
         path.clear();
@@ -227,51 +538,53 @@ double StadiumGraph::dijkstra(const QString& start, const QString& end, QVector<
 }
 
 double StadiumGraph::aStar(const QString& start, const QString& end, QVector<QString>& path) const {
-    if (!adjMatrix.contains(start) || !adjMatrix.contains(end)) {
+    const NameKey startKey(start);
+    const NameKey endKey(end);
+    if (!adjMatrix.contains(startKey) || !adjMatrix.contains(endKey)) {
         return -1.0;
     }
 
     // Priority queue for open set (f_score, stadium)
-    QMap<double, QSet<QString>> openSet;
-    QSet<QString> closedSet;
-    QMap<QString, double> g_score;  // Cost from start to current
-    QMap<QString, double> f_score;  // Estimated total cost
-    QMap<QString, QString> came_from;
+    QMap<double, QSet<NameKey>> openSet;
+    QSet<NameKey> closedSet;
+    QMap<NameKey, double> g_score;  // Cost from start to current
+    QMap<NameKey, double> f_score;  // Estimated total cost
+    QMap<NameKey, NameKey> came_from;
 
     // Initialize scores
-    for (const QString& stadium : adjMatrix.keys()) {
+    for (const NameKey& stadium : adjMatrix.keys()) {
         g_score[stadium] = std::numeric_limits<double>::infinity();
         f_score[stadium] = std::numeric_limits<double>::infinity();
     }
-    g_score[start] = 0;
-    f_score[start] = 0;  // For start node, f_score = g_score since h_score = 0
-    openSet[0].insert(start);
+    g_score[startKey] = 0;
+    f_score[startKey] = 0;  // For start node, f_score = g_score since h_score = 0
+    openSet[0].insert(startKey);
 
     while (!openSet.isEmpty()) {
         // Get stadium with lowest f_score
         double current_f = openSet.firstKey();
-        QString current = *openSet[current_f].begin();
+        NameKey current = *openSet[current_f].begin();
         openSet[current_f].remove(current);
         if (openSet[current_f].isEmpty()) {
             openSet.remove(current_f);
         }
 
-        if (current == end) {
+        if (current == endKey) {
             // Reconstruct path
             path.clear();
-            while (current != start) {
-                path.prepend(current);
+            while (current != startKey) {
+                path.prepend(current.toString());
                 current = came_from[current];
             }
             path.prepend(start);
-            return g_score[end];
+            return g_score[endKey];
         }
 
         closedSet.insert(current);
 
         // Check all neighbors
         for (auto it = adjMatrix[current].begin(); it != adjMatrix[current].end(); ++it) {
-            const QString& neighbor = it.key();
+            const NameKey& neighbor = it.key();
             if (closedSet.contains(neighbor)) {
                 continue;
             }
@@ -297,26 +610,29 @@ double StadiumGraph::minimumSpanningTree(QVector<QPair<QString, QString>>& mstEd
     if (adjMatrix.isEmpty()) {
         return 0.0;
     }
+    if (isFrozen()) {
+        return frozenSpanningTree(mstEdges);
+    }
 
-    QSet<QString> visited;
-    QMap<QString, double> key;
-    QMap<QString, QString> parent;
+    QSet<NameKey> visited;
+    QMap<NameKey, double> key;
+    QMap<NameKey, NameKey> parent;
     double totalWeight = 0.0;
 
     // Initialize keys to infinity
-    for (const QString& stadium : adjMatrix.keys()) {
+    for (const NameKey& stadium : adjMatrix.keys()) {
         key[stadium] = std::numeric_limits<double>::infinity();
     }
 
     // Start with first stadium
-    QString start = adjMatrix.firstKey();
+    NameKey start = adjMatrix.firstKey();
     key[start] = 0;
 
     while (visited.size() < adjMatrix.size()) {
         // Find unvisited vertex with minimum key
-        QString current;
+        NameKey current;
         double minKey = std::numeric_limits<double>::infinity();
-        for (const QString& stadium : adjMatrix.keys()) {
+        for (const NameKey& stadium : adjMatrix.keys()) {
             if (!visited.contains(stadium) && key[stadium] < minKey) {
                 minKey = key[stadium];
                 current = stadium;
@@ -336,20 +652,20 @@ double StadiumGraph::minimumSpanningTree(QVector<QPair<QString, QString>>& mstEd
             if (!parent.contains(current)) {
                 continue;
             }
-            const QString& parentStadium = parent[current];
+            const NameKey& parentStadium = parent[current];
             if (parentStadium.isEmpty() || current.isEmpty()) {
                 continue;
             }
             if (!adjMatrix.contains(parentStadium) || !adjMatrix.contains(current)) {
                 continue;
             }
-            mstEdges.append(qMakePair(parentStadium, current));
+            mstEdges.append(qMakePair(parentStadium.toString(), current.toString()));
             totalWeight += key[current];
         }
 
         // Update keys of adjacent vertices
         for (auto it = adjMatrix[current].begin(); it != adjMatrix[current].end(); ++it) {
-            const QString& neighbor = it.key();
+            const NameKey& neighbor = it.key();
             if (!visited.contains(neighbor) && it.value() < key[neighbor]) {
                 parent[neighbor] = current;
                 key[neighbor] = it.value();
@@ -366,29 +682,40 @@ double StadiumGraph::minimumSpanningTree(QVector<QPair<QString, QString>>& mstEd
     return totalWeight;
 }
 
+// Row entries ordered by distance, nearest first
+static QVector<QPair<NameKey, double>> sortedNeighbors(const QMap<NameKey, double>& row) {
+    QVector<QPair<NameKey, double>> neighbors;
+    neighbors.reserve(row.size());
+    for (auto it = row.constBegin(); it != row.constEnd(); ++it) {
+        neighbors.append(qMakePair(it.key(), it.value()));
+    }
+    std::stable_sort(neighbors.begin(), neighbors.end(),
+                     [](const QPair<NameKey, double>& a, const QPair<NameKey, double>& b) {
+                         return a.second < b.second;
+                     });
+    return neighbors;
+}
+
 double StadiumGraph::dfs(const QString& start, QVector<QString>& order) const {
     order.clear();
-    if (!adjMatrix.contains(start)) {
+    const NameKey startKey(start);
+    if (!adjMatrix.contains(startKey)) {
         return -1.0;
     }
-    QSet<QString> visited;
+    QSet<NameKey> visited;
     double totalDistance = 0.0;
     int recursionDepth = 0;
     const int MAX_DEPTH = adjMatrix.size() + 10;
-    std::function<void(const QString&)> dfsVisit = [&](const QString& stadium) {
+    std::function<void(const NameKey&)> dfsVisit = [&](const NameKey& stadium) {
         if (recursionDepth > MAX_DEPTH) {
             qDebug() << "DFS: Max recursion depth exceeded at" << stadium;
             return;
         }
         recursionDepth++;
         visited.insert(stadium);
-        order.append(stadium);
+        order.append(stadium.toString());
         qDebug() << "DFS visiting:" << stadium;
-        QVector<QPair<QString, double>> neighbors = getNeighbors(stadium);
-        std::sort(neighbors.begin(), neighbors.end(),
-                 [](const QPair<QString, double>& a, const QPair<QString, double>& b) {
-                     return a.second < b.second;
-                 });
+        QVector<QPair<NameKey, double>> neighbors = sortedNeighbors(adjMatrix.value(stadium));
         for (const auto& neighbor : neighbors) {
             qDebug() << "DFS at" << stadium << "checking neighbor:" << neighbor.first;
             if (neighbor.first == stadium) {
@@ -406,36 +733,33 @@ double StadiumGraph::dfs(const QString& start, QVector<QString>& order) const {
         }
         recursionDepth--;
     };
-    dfsVisit(start);
+    dfsVisit(startKey);
     return totalDistance;
 }
 
 double StadiumGraph::bfs(const QString& start, QVector<QString>& order) const {
     order.clear();
-    if (!adjMatrix.contains(start)) {
+    const NameKey startKey(start);
+    if (!adjMatrix.contains(startKey)) {
         return -1.0;
     }
 
-    QSet<QString> visited;
-    QQueue<QString> queue;
+    QSet<NameKey> visited;
+    QQueue<NameKey> queue;
     double totalDistance = 0.0;
 
-    visited.insert(start);
-    queue.enqueue(start);
+    visited.insert(startKey);
+    queue.enqueue(startKey);
     order.append(start);
 
     while (!queue.isEmpty()) {
-        QString current = queue.dequeue();
-        QVector<QPair<QString, double>> neighbors = getNeighbors(current);
-        std::sort(neighbors.begin(), neighbors.end(),
-                 [](const QPair<QString, double>& a, const QPair<QString, double>& b) {
-                     return a.second < b.second;
-                 });
+        NameKey current = queue.dequeue();
+        QVector<QPair<NameKey, double>> neighbors = sortedNeighbors(adjMatrix.value(current));
         for (const auto& neighbor : neighbors) {
             if (!visited.contains(neighbor.first)) {
                 visited.insert(neighbor.first);
                 queue.enqueue(neighbor.first);
-                order.append(neighbor.first);
+                order.append(neighbor.first.toString());
                 totalDistance += neighbor.second;
             }
         }
@@ -445,10 +769,14 @@ double StadiumGraph::bfs(const QString& start, QVector<QString>& order) const {
 }
 
 double StadiumGraph::greedyTrip(const QString& start, const QVector<QString>& stops, QVector<QString>& order) const {
+    if (isFrozen()) {
+        return frozenGreedyTrip(start, stops, order);
+    }
     try {
         // Validate inputs
         QString nStart = normalizeStadiumName(start);
-        if (!adjMatrix.contains(nStart)) {
+        NameKey startKey(nStart);
+        if (!adjMatrix.contains(startKey)) {
             qDebug() << "Start stadium not found:" << start << "(normalized:" << nStart << ")";
         return -1.0;
     }
@@ -459,30 +787,31 @@ double StadiumGraph::greedyTrip(const QString& start, const QVector<QString>& st
         }
 
         // Verify all stops exist in the graph
-        QVector<QString> normalizedStops;
+        QVector<NameKey> normalizedStops;
         for (const QString& stop : stops) {
             QString nStop = normalizeStadiumName(stop);
-            if (!adjMatrix.contains(nStop)) {
+            NameKey stopKey(nStop);
+            if (!adjMatrix.contains(stopKey)) {
                 qDebug() << "Stop stadium not found:" << stop << "(normalized:" << nStop << ")";
                 return -1.0;
             }
-            normalizedStops.append(nStop);
+            normalizedStops.append(stopKey);
         }
 
-        QSet<QString> unvisited(normalizedStops.begin(), normalizedStops.end());
+        QSet<NameKey> unvisited(normalizedStops.begin(), normalizedStops.end());
     order.clear();
         order.append(nStart);
     double totalDistance = 0.0;
-        QString current = nStart;
+        NameKey current = startKey;
 
     while (!unvisited.isEmpty()) {
         // Find nearest unvisited stadium
-        QString nearest;
+        NameKey nearest;
         double minDist = std::numeric_limits<double>::infinity();
 
-        for (const QString& stop : unvisited) {
+        for (const NameKey& stop : unvisited) {
                 try {
-            double dist = getDistance(current, stop);
+            double dist = getEdgeWeight(current, stop);
             if (dist >= 0 && dist < minDist) {
                 minDist = dist;
                 nearest = stop;
@@ -504,7 +833,7 @@ double StadiumGraph::greedyTrip(const QString& start, const QVector<QString>& st
         // Move to nearest stadium
         current = nearest;
         unvisited.remove(current);
-        order.append(current);
+        order.append(current.toString());
         totalDistance += minDist;
             
             qDebug() << "Added to trip:" << current << "Distance:" << minDist;
@@ -521,176 +850,6 @@ double StadiumGraph::greedyTrip(const QString& start, const QVector<QString>& st
     }
 }
 
-void StadiumGraph::debugPrintAllEdges() const {
-    qDebug() << "All edges in StadiumGraph:";
-    for (const auto& from : adjMatrix.keys()) {
-        for (const auto& to : adjMatrix[from].keys()) {
-            if (from < to) { // avoid duplicate undirected edges
-                qDebug() << from << "->" << to << ":" << adjMatrix[from][to];
-            }
-        }
-    }
-}
-
-void StadiumGraph::debugPrintAllNormalizedStadiums() const {
-    qDebug() << "All normalized stadium names in StadiumGraph:";
-    for (const QString& stadium : adjMatrix.keys()) {
-        qDebug() << stadium;
-    }
-}
-
-void StadiumGraph::debugPrintAllStadiumConnections() const {
-    try {
-        qDebug() << "\n=== Stadium Connections ===";
-        for (const QString& stadium : adjMatrix.keys()) {
-            try {
-                QStringList connections;
-                if (adjMatrix.contains(stadium)) {
-                    for (auto it = adjMatrix[stadium].begin(); it != adjMatrix[stadium].end(); ++it) {
-                        connections << QString("%1 (%2)").arg(it.key()).arg(it.value());
-                    }
-                    qDebug() << stadium << ":" << connections.join(", ");
-                }
-            } catch (const std::exception& e) {
-                qDebug() << "Error processing connections for stadium" << stadium << ":" << e.what();
-            } catch (...) {
-                qDebug() << "Unknown error processing connections for stadium" << stadium;
-            }
-        }
-    } catch (const std::exception& e) {
-        qDebug() << "Error in debugPrintAllStadiumConnections:" << e.what();
-    } catch (...) {
-        qDebug() << "Unknown error in debugPrintAllStadiumConnections";
-    }
-}
-
-void StadiumGraph::debugPrintMissingEdges() const {
-    qDebug() << "\n=== Missing Edges (distance -1) ===";
-    QVector<QString> stadiums = getStadiums();
-    int missingCount = 0;
-    for (int i = 0; i < stadiums.size(); ++i) {
-        for (int j = i + 1; j < stadiums.size(); ++j) {
-            double dist = getDistance(stadiums[i], stadiums[j]);
-            if (dist == -1.0) {
-                qDebug() << stadiums[i] << "<->" << stadiums[j] << ": -1 (missing)";
-                ++missingCount;
-            }
-        }
-    }
-    if (missingCount == 0) {
-        qDebug() << "No missing edges!";
-    } else {
-        qDebug() << "Total missing edges:" << missingCount;
-    }
-}
-
-void StadiumGraph::removeEmptyKeysAndNeighbors() {
-    // Remove any empty or whitespace-only keys from adjMatrix
-    QList<QString> badKeys;
-    for (const QString& key : adjMatrix.keys()) {
-        if (key.trimmed().isEmpty()) {
-            badKeys.append(key);
-        }
-    }
-    for (const QString& key : badKeys) {
-        adjMatrix.remove(key);
-        qDebug() << "Removed empty or whitespace-only key from adjMatrix!";
-    }
-    // Remove any empty or whitespace-only neighbors for all stadiums
-    for (auto it = adjMatrix.begin(); it != adjMatrix.end(); ++it) {
-        QList<QString> badNeighbors;
-        for (const QString& nKey : it.value().keys()) {
-            if (nKey.trimmed().isEmpty()) {
-                badNeighbors.append(nKey);
-            }
-        }
-        for (const QString& nKey : badNeighbors) {
-            it.value().remove(nKey);
-            qDebug() << "Removed empty or whitespace-only neighbor for" << it.key();
-        }
-    }
-}
-
-void StadiumGraph::debugPrintAllNeighbors() const {
-    qDebug() << "\n=== All Stadium Neighbors (with hex values) ===";
-    // Diagnostic: Print all keys for angelstadium at start
-    if (adjMatrix.contains("angelstadium")) {
-        qDebug() << "DEBUG: All keys for angelstadium at start of debugPrintAllNeighbors:";
-        const auto& angelNeighbors = adjMatrix["angelstadium"];
-        for (auto it = angelNeighbors.begin(); it != angelNeighbors.end(); ++it) {
-            QString key = it.key();
-            if (key.trimmed().isEmpty()) {
-                qDebug() << "WARNING: Found empty key in angelstadium neighbors!";
-                continue;
-            }
-            qDebug() << "[" << key << "]";
-        }
-    }
-    for (const QString& stadium : adjMatrix.keys()) {
-        if (stadium.trimmed().isEmpty()) {
-            qDebug() << "WARNING: Found empty or whitespace-only stadium name in adjMatrix keys, skipping.";
-            continue;
-        }
-        QByteArray stadiumHex = stadium.toUtf8().toHex();
-        qDebug() << "Neighbors for" << '"' + stadium + '"' << "(hex:" << stadiumHex << "):";
-        const auto& neighbors = adjMatrix[stadium];
-        for (auto nIt = neighbors.begin(); nIt != neighbors.end(); ++nIt) {
-            QString neighbor = nIt.key();
-            if (neighbor.trimmed().isEmpty()) {
-                qDebug() << "WARNING: Found empty or whitespace-only neighbor key for stadium" << stadium << ". Skipping.";
-                continue;
-            }
-        }
-    }
-}
-
-bool StadiumGraph::validateGraphIntegrity() const {
-    bool valid = true;
-    for (const QString& stadium : adjMatrix.keys()) {
-        QByteArray stadiumHex = stadium.toUtf8().toHex();
-        if (stadium.trimmed().isEmpty()) {
-            qCritical() << "FATAL: Found empty or whitespace-only stadium name in adjMatrix! Hex:" << stadiumHex;
-            valid = false;
-        }
-        for (const QString& neighbor : adjMatrix[stadium].keys()) {
-            QByteArray neighborHex = neighbor.toUtf8().toHex();
-            if (neighbor.trimmed().isEmpty()) {
-                qCritical() << "FATAL: Found empty or whitespace-only neighbor for" << stadium << "! Hex:" << neighborHex;
-                valid = false;
-            }
-        }
-    }
-    return valid;
-}
-
-void StadiumGraph::cleanAdjacencyMatrix() {
-    QList<QString> emptyStadiums;
-    // First pass: identify empty stadiums and collect empty neighbors
-    for (auto it = adjMatrix.begin(); it != adjMatrix.end(); ++it) {
-        QString stadium = it.key();
-        if (stadium.trimmed().isEmpty()) {
-            emptyStadiums.append(stadium);
-            continue;
-        }
-        QList<QString> toRemove;
-        for (auto nIt = it.value().begin(); nIt != it.value().end(); ++nIt) {
-            if (nIt.key().trimmed().isEmpty()) {
-                toRemove.append(nIt.key());
-            }
-        }
-        // Remove empty neighbors
-        for (const QString& badKey : toRemove) {
-            adjMatrix[stadium].remove(badKey);
-            qDebug() << "Removed empty neighbor for" << stadium;
-        }
-    }
-    // Second pass: remove empty stadiums
-    for (const QString& emptyStadium : emptyStadiums) {
-        adjMatrix.remove(emptyStadium);
-        qDebug() << "Removed empty stadium:" << emptyStadium;
-    }
-}
-
 bool StadiumGraph::loadFromCSV(const QString& filename, bool /*clearExisting*/) {
     if (filename.isEmpty()) {
         return false;
@@ -714,28 +873,10 @@ bool StadiumGraph::loadFromCSV(const QString& filename, bool /*clearExisting*/)
     while (!in.atEnd()) {
             try {
                 lineCount++;
-                QString line = in.readLine().trimmed();
-                if (line.isEmpty()) {
-                    continue;
-                }
-                QStringList parts = line.split(',');
-                if (parts.size() < 3) {
-                    continue;
-                }
-            QString from = parts[0].trimmed();
-            QString to = parts[1].trimmed();
-                QString distStr = parts[2].trimmed();
-                if (from.isEmpty() || to.isEmpty() || distStr.isEmpty()) {
-                    continue;
-                }
-            bool ok = false;
-                double distance = distStr.toDouble(&ok);
-                if (!ok || distance <= 0) {
-                    continue;
-                }
-                QString nFrom = normalizeStadiumName(from);
-                QString nTo = normalizeStadiumName(to);
-                if (nFrom.isEmpty() || nTo.isEmpty()) {
+                QString from;
+                QString to;
+                double distance = 0.0;
+                if (!parseDistanceRow(in.readLine(), from, to, distance)) {
                     continue;
                 }
                 addEdge(from, to, distance);
@@ -745,6 +886,7 @@ bool StadiumGraph::loadFromCSV(const QString& filename, bool /*clearExisting*/)
             }
         }
         file.close();
+        publish();
         return successCount > 0;
     } catch (...) {
         file.close();
@@ -752,79 +894,106 @@ bool StadiumGraph::loadFromCSV(const QString& filename, bool /*clearExisting*/)
     }
 }
 
-bool StadiumGraph::loadMultipleCSVs(const QStringList& filenames) {
+bool StadiumGraph::loadDefaults(bool clearExisting) {
+    if (clearExisting) {
+        clear();
+    }
+    // Names are stored normalized, so the edges go straight into the matrix
+    thaw();
+    const DefaultDistanceRecord* distances = DefaultData::distances();
+    const int count = DefaultData::distanceCount();
+    for (int i = 0; i < count; ++i) {
+        const NameKey from(distances[i].from);
+        const NameKey to(distances[i].to);
+        adjMatrix[from][to] = distances[i].miles;
+        adjMatrix[to][from] = distances[i].miles;
+    }
+    publish();
+    return count > 0;
+}
+
+bool StadiumGraph::parseDistanceRow(const QString& line, QString& from, QString& to, double& distance) {
+    QString trimmed = line.trimmed();
+    if (trimmed.isEmpty()) {
+        return false;
+    }
+    QStringList parts = trimmed.split(',');
+    if (parts.size() < 3) {
+        return false;
+    }
+    from = parts[0].trimmed();
+    to = parts[1].trimmed();
+    QString distStr = parts[2].trimmed();
+    if (from.isEmpty() || to.isEmpty() || distStr.isEmpty()) {
+        return false;
+    }
+    bool ok = false;
+    distance = distStr.toDouble(&ok);
+    if (!ok || distance <= 0) {
+        return false;
+    }
+    return !normalizeStadiumName(from).isEmpty() && !normalizeStadiumName(to).isEmpty();
+}
+
+bool StadiumGraph::loadMultipleCSVs(const QStringList& filenames, CsvMergeRule rule, QVector<CsvFileStats>* stats) {
     qDebug() << "\n=== Starting to load multiple CSVs ===";
     qDebug() << "Number of files to process:" << filenames.size();
     if (filenames.isEmpty()) {
         qDebug() << "Error: No files provided";
         return false;
     }
-    bool allSuccess = true;
+    // Parse every file in parallel, then merge in list order
+    const QVector<CsvStagedFile<DistanceRow>> files = CsvImport::parseDistanceFiles(filenames);
+    QVector<CsvFileStats> fileStats;
     int successfulFiles = 0;
-    for (const QString& filename : filenames) {
-        qDebug() << "\nProcessing file:" << filename;
-        try {
-            bool success = loadFromCSV(filename, false); // Always merge, never clear
-            if (success) {
-                successfulFiles++;
-            } else {
-                qDebug() << "Failed to load file:" << filename;
-                allSuccess = false;
-            }
-        } catch (...) {
-            qDebug() << "Exception while loading file:" << filename;
-            allSuccess = false;
+    for (const CsvStagedFile<DistanceRow>& file : files) {
+        fileStats.append(file.stats);
+        if (file.stats.rows > 0) {
+            successfulFiles++;
+        } else {
+            qDebug() << "Failed to load file:" << file.stats.fileName;
         }
     }
-    try {
-        qDebug() << "\n=== Loaded Data Summary ===";
-        qDebug() << "Total stadiums:" << getStadiums().size();
-        qDebug() << "Sample connections:";
-        for (const QString& stadium : getStadiums()) {
-            if (adjMatrix.contains(stadium)) {
-                qDebug() << stadium << "has" << adjMatrix[stadium].size() << "connections";
-                break;  // Just show one stadium as a sample
-            }
-        }
-        debugPrintAllNeighbors();
-    } catch (const std::exception& e) {
-        qDebug() << "Error printing summary:" << e.what();
-    } catch (...) {
-        qDebug() << "Unknown error printing summary";
+    CsvImport::logStats(fileStats);
+    if (stats) {
+        *stats = fileStats;
+    }
+    QVector<DistanceRow> merged;
+    QVector<CsvConflict<DistanceRow>> conflicts;
+    if (!CsvImport::mergeDistances(files, rule, merged, &conflicts)) {
+        return false;
     }
+    mergeConflicts.clear();
+    for (const CsvConflict<DistanceRow>& conflict : conflicts) {
+        GraphIssue issue;
+        issue.kind = GraphIssue::ConflictingDuplicate;
+        issue.from = conflict.earlier.from;
+        issue.to = conflict.earlier.to;
+        issue.weight = conflict.earlier.distance;
+        issue.otherWeight = conflict.later.distance;
+        mergeConflicts.append(issue);
+    }
+    thaw();
+    for (const DistanceRow& row : merged) {
+        const NameKey from(row.from);
+        const NameKey to(row.to);
+        adjMatrix[from][to] = row.distance;
+        adjMatrix[to][from] = row.distance;
+        if (journal) {
+            journal->edgeSet(row.from, row.to, row.distance);
+        }
+    }
+    publish();
+    qDebug() << "Loaded" << merged.size() << "distances," << stadiumCount() << "stadiums,"
+             << conflicts.size() << "conflicting duplicate(s)";
     return successfulFiles > 0;  // Return true if at least one file was loaded successfully
 }
 
 void StadiumGraph::clear() {
+    thaw();
     adjMatrix.clear();
-}
-
-bool StadiumGraph::isConnected() const {
-    QVector<QString> stadiums = getStadiums();
-    if (stadiums.isEmpty()) return true;
-    QSet<QString> visited;
-    QQueue<QString> queue;
-    queue.enqueue(stadiums[0]);
-    visited.insert(stadiums[0]);
-    while (!queue.isEmpty()) {
-        QString current = queue.dequeue();
-        for (const auto& neighbor : adjMatrix[current].keys()) {
-            if (!visited.contains(neighbor)) {
-                visited.insert(neighbor);
-                queue.enqueue(neighbor);
-            }
-        }
+    mergeConflicts.clear();
+    if (journal) {
+        journal->graphCleared();
     }
-    if (visited.size() == stadiums.size()) {
-        qDebug() << "Graph is fully connected!";
-    return true;
-    } else {
-        qDebug() << "Graph is NOT fully connected! Unreachable stadiums:";
-        for (const QString& stadium : stadiums) {
-            if (!visited.contains(stadium)) {
-                qDebug() << "-" << stadium;
-            }
-        }
-        return false;
-    }
-} 
\ No newline at end of file
+}
@@ -5,17 +5,48 @@
 #include <QVector>
 #include <QMap>
 #include <QPair>
+#include <memory>
+#include "namekey.h"
+#include "perfecthash.h"
+#include "csvimport.h"
+#include "graphvalidator.h"
+#include "densegraph.h"
+#include "graphorder.h"
 
+class ChangeJournal;
+
+// Mutable distance graph. Writers edit it in place and call publish()
+// after a batch of changes; readers on any thread take snapshot() and query
+// that instead. A snapshot is an immutable frozen copy that shares the
+// matrix with the builder until the builder's next write (implicit
+// sharing), so publishing costs a freeze() rather than a deep copy.
 class StadiumGraph {
 public:
+    typedef std::shared_ptr<const StadiumGraph> Snapshot;
+
     StadiumGraph();
     void addStadium(const QString& name);
     void addEdge(const QString& from, const QString& to, double distance);
+    bool removeEdge(const QString& from, const QString& to);
     double getDistance(const QString& from, const QString& to) const;
+    double getEdgeWeight(const QString& normalizedFrom, const QString& normalizedTo) const;
+    double getEdgeWeight(const NameKey& from, const NameKey& to) const;
+    // Both convert every key to a new QString; for display. Code that walks
+    // the graph uses stadiumKeys() and forEachNeighbor() instead.
     QVector<QString> getStadiums() const;
     QVector<QPair<QString, double>> getNeighbors(const QString& stadium) const;
+    // Normalized keys in key order, copied without allocating per name
+    QVector<NameKey> stadiumKeys() const { return adjMatrix.keys().toVector(); }
+    int stadiumCount() const { return int(adjMatrix.size()); }
+    // Calls fn(neighborKey, distance) for each neighbor in key order
+    template<typename Fn>
+    void forEachNeighbor(const NameKey& stadium, Fn fn) const;
     void clear();
 
+    // Edge changes are appended to the journal when one is set
+    void setChangeJournal(ChangeJournal* journal) { this->journal = journal; }
+    ChangeJournal* changeJournal() const { return journal; }
+
     // Algorithms
     double dijkstra(const QString& start, const QString& end, QVector<QString>& path) const;
     double aStar(const QString& start, const QString& end, QVector<QString>& path) const;
@@ -25,24 +56,85 @@ public:
     double greedyTrip(const QString& start, const QVector<QString>& stops, QVector<QString>& order) const;
 
     bool loadFromCSV(const QString& filename, bool clearExisting = false);
-    bool loadMultipleCSVs(const QStringList& filenames);
-    void debugPrintAllEdges() const;
-    void debugPrintAllNormalizedStadiums() const;
-    void debugPrintAllStadiumConnections() const;
-    void debugPrintMissingEdges() const;
-    void debugPrintAllNeighbors() const;
+    // Loads the distances compiled into the executable (defaultdata.h)
+    bool loadDefaults(bool clearExisting = false);
+    // Parses the files in parallel, merges them in list order under rule and
+    // applies the result with one publish. stats receives each file's parse
+    // throughput. Stadium pairs the files list with different distances are
+    // reported by validate() as conflicting duplicates until the next load
+    // or clear().
+    bool loadMultipleCSVs(const QStringList& filenames,
+                          CsvMergeRule rule = CsvMergeRule::LastFileWins,
+                          QVector<CsvFileStats>* stats = nullptr);
+    // Splits one "from,to,distance" line; false for headers, blanks and bad rows
+    static bool parseDistanceRow(const QString& line, QString& from, QString& to, double& distance);
 
-    bool isConnected() const;
+    // One O(V + E) pass over the frozen adjacency rows; see GraphValidator.
+    // teamStadiums are the stadiums of the teams in the Database (any
+    // spelling); nodes matching none are reported, and an empty list skips
+    // that check.
+    GraphValidationReport validate(const QVector<QString>& teamStadiums = QVector<QString>(),
+                                   int maxIssues = 1000) const;
 
-    bool validateGraphIntegrity() const;
+    // Builds a perfect-hash node index and flat adjacency rows for lookups
+    // while the graph is unchanged; any mutation drops them again. Graphs of
+    // up to DenseAdjacency::MaxNodes nodes also get a dense matrix. While
+    // frozen, dijkstra, minimumSpanningTree and greedyTrip run the
+    // GraphKernels over the dense matrix or the rows instead of the map.
+    void freeze();
+    bool isFrozen() const { return frozenNodes.isBuilt(); }
+    // Node numbering used by the next freeze(). Reordering keeps name lookups
+    // unchanged but can change which of several equal-weight routes or
+    // spanning trees the algorithms return.
+    void setNodeOrder(NodeOrder order);
+    NodeOrder nodeOrder() const { return order; }
 
-    static QString normalizeStadiumName(const QString& name);
+    // Freezes the graph and atomically replaces the published snapshot.
+    // Called by the writer; bulk loads and cleanups publish on their own.
+    void publish();
+    // Latest published snapshot (an empty graph before the first publish).
+    // Safe to call from any thread while the writer keeps editing.
+    Snapshot snapshot() const;
 
-    void cleanAdjacencyMatrix();
-    void removeEmptyKeysAndNeighbors();
+    static QString normalizeStadiumName(const QString& name);
 
 private:
-    QMap<QString, QMap<QString, double>> adjMatrix; // adjacency matrix
+    // Adjacency matrix keyed by normalized names; the public API converts
+    // QString names at the boundary
+    QMap<NameKey, QMap<NameKey, double>> adjMatrix;
+    ChangeJournal* journal = nullptr;
+    Snapshot published;  // accessed with std::atomic_load/atomic_store
+    NodeOrder order = NodeOrder::KeyOrder;
+    QVector<GraphIssue> mergeConflicts;  // from the last loadMultipleCSVs
+
+    void thaw();
+    // CSR rows in key order, each sorted by target ID
+    void buildRows(QVector<int>& rowStart, QVector<int>& targets, QVector<double>& weights) const;
+    MinimalPerfectHash frozenNodes;     // normalized name -> node ID (in order)
+    QVector<int> frozenRowStart;        // CSR rows, targets sorted by node ID
+    QVector<int> frozenTargets;
+    QVector<double> frozenWeights;
+    DenseAdjacency frozenDense;         // empty above DenseAdjacency::MaxNodes
+
+    // Runs fn(adjacency, maxNodes) on frozenDense when it is built, else on
+    // a view of the rows; maxNodes is the GraphKernels size for the graph
+    template<typename Fn>
+    auto withFrozenAdjacency(Fn fn) const;
+    double frozenWeight(int from, int to) const;
+    double frozenDijkstra(const QString& start, const QString& end, QVector<QString>& path) const;
+    double frozenSpanningTree(QVector<QPair<QString, QString>>& mstEdges) const;
+    double frozenGreedyTrip(const QString& start, const QVector<QString>& stops, QVector<QString>& order) const;
 };
 
+template<typename Fn>
+void StadiumGraph::forEachNeighbor(const NameKey& stadium, Fn fn) const {
+    auto row = adjMatrix.constFind(stadium);
+    if (row == adjMatrix.constEnd()) {
+        return;
+    }
+    for (auto it = row.value().constBegin(); it != row.value().constEnd(); ++it) {
+        fn(it.key(), it.value());
+    }
+}
+
 #endif // STADIUMGRAPH_H 
\ No newline at end of file
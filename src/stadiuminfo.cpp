@@ -0,0 +1,159 @@
+#include "stadiuminfo.h"
+#include "stringdictionary.h"
+
+namespace {
+
+// Field layout before dictionary encoding, kept for the memory report
+struct PlainStadiumInfo {
+    QString teamName;
+    QString stadiumName;
+    int seatingCapacity;
+    QString location;
+    QString playingSurface;
+    QString league;
+    QString dateOpened;
+    int distanceToCenter;
+    QString ballparkTypology;
+    QString roofType;
+    QVector<QPair<QString, double>> souvenirs;
+};
+
+qint64 souvenirListBytes(const StadiumInfo& info) {
+    if (info.souvenirs.isEmpty()) {
+        return 0;
+    }
+    return 16 + qint64(info.souvenirs.capacity()) * sizeof(QPair<QString, double>);
+}
+
+} // namespace
+
+League leagueFromString(const QString& text) {
+    QString value = text.trimmed();
+    if (value.compare("American", Qt::CaseInsensitive) == 0) return League::American;
+    if (value.compare("National", Qt::CaseInsensitive) == 0) return League::National;
+    return League::Unknown;
+}
+
+RoofType roofTypeFromString(const QString& text) {
+    QString value = text.trimmed();
+    if (value.compare("Open", Qt::CaseInsensitive) == 0) return RoofType::Open;
+    if (value.compare("Retractable", Qt::CaseInsensitive) == 0) return RoofType::Retractable;
+    if (value.compare("Fixed", Qt::CaseInsensitive) == 0) return RoofType::Fixed;
+    return RoofType::Unknown;
+}
+
+PlayingSurface playingSurfaceFromString(const QString& text) {
+    // Synthetic surfaces are sold under names like "AstroTurf GameDay Grass",
+    // so look for turf before grass
+    if (text.contains("turf", Qt::CaseInsensitive)) return PlayingSurface::ArtificialTurf;
+    if (text.contains("grass", Qt::CaseInsensitive)) return PlayingSurface::Grass;
+    return PlayingSurface::Unknown;
+}
+
+QString leagueName(League league) {
+    switch (league) {
+    case League::American: return "American";
+    case League::National: return "National";
+    default: return "Unknown";
+    }
+}
+
+QString roofTypeName(RoofType roof) {
+    switch (roof) {
+    case RoofType::Open: return "Open";
+    case RoofType::Retractable: return "Retractable";
+    case RoofType::Fixed: return "Fixed";
+    default: return "Unknown";
+    }
+}
+
+QString playingSurfaceName(PlayingSurface surface) {
+    switch (surface) {
+    case PlayingSurface::Grass: return "Grass";
+    case PlayingSurface::ArtificialTurf: return "Artificial Turf";
+    default: return "Unknown";
+    }
+}
+
+qint32 epochDayFromDate(const QDate& date) {
+    if (!date.isValid()) {
+        return StadiumInfo::UnknownDay;
+    }
+    return qint32(date.toJulianDay() - QDate(1970, 1, 1).toJulianDay());
+}
+
+qint32 epochDayFromString(const QString& text) {
+    QString value = text.trimmed();
+    QDate date = QDate::fromString(value, Qt::ISODate);
+    if (date.isValid()) {
+        return epochDayFromDate(date);
+    }
+    // Otherwise take the first four-digit run as the year
+    for (int i = 0; i + 4 <= value.size(); ++i) {
+        if (!value[i].isDigit() || (i > 0 && value[i - 1].isDigit())) {
+            continue;
+        }
+        int end = i;
+        while (end < value.size() && value[end].isDigit()) {
+            ++end;
+        }
+        if (end - i == 4) {
+            return epochDayFromDate(QDate(value.mid(i, 4).toInt(), 1, 1));
+        }
+        i = end;
+    }
+    return StadiumInfo::UnknownDay;
+}
+
+int feetFromString(const QString& text) {
+    int feet = 0;
+    int i = 0;
+    while (i < text.size() && !text[i].isDigit()) {
+        ++i;
+    }
+    for (; i < text.size() && text[i].isDigit() && feet < 100000; ++i) {
+        feet = feet * 10 + text[i].digitValue();
+    }
+    return feet;
+}
+
+QString StadiumInfo::location() const {
+    return StringDictionary::locations().value(locationCode);
+}
+
+QString StadiumInfo::ballparkTypology() const {
+    return StringDictionary::typologies().value(typologyCode);
+}
+
+void StadiumInfo::setLocation(const QString& location) {
+    locationCode = StringDictionary::locations().intern(location);
+}
+
+void StadiumInfo::setBallparkTypology(const QString& typology) {
+    typologyCode = quint16(StringDictionary::typologies().intern(typology));
+}
+
+qint64 plainStadiumInfoBytes(const StadiumInfo& info) {
+    qint64 bytes = sizeof(PlainStadiumInfo) + souvenirListBytes(info);
+    bytes += StringDictionary::stringHeapBytes(info.teamName);
+    bytes += StringDictionary::stringHeapBytes(info.stadiumName);
+    bytes += StringDictionary::stringHeapBytes(info.dateOpened);
+    bytes += StringDictionary::stringHeapBytes(info.location());
+    bytes += StringDictionary::stringHeapBytes(info.ballparkTypology());
+    bytes += StringDictionary::stringHeapBytes(leagueName(info.league));
+    bytes += StringDictionary::stringHeapBytes(roofTypeName(info.roofType));
+    bytes += StringDictionary::stringHeapBytes(playingSurfaceName(info.playingSurface));
+    for (const auto& souvenir : info.souvenirs) {
+        bytes += StringDictionary::stringHeapBytes(souvenir.first);
+    }
+    return bytes;
+}
+
+qint64 encodedStadiumInfoBytes(const StadiumInfo& info) {
+    // Dictionary-held text is accounted once, in StadiumMemoryStats::dictionaryBytes
+    qint64 bytes = sizeof(StadiumInfo) + souvenirListBytes(info);
+    bytes += StringDictionary::stringHeapBytes(info.teamName);
+    bytes += StringDictionary::stringHeapBytes(info.stadiumName);
+    bytes += StringDictionary::stringHeapBytes(info.dateOpened);
+    return bytes;
+}
@@ -4,19 +4,65 @@
 #include <QString>
 #include <QVector>
 #include <QPair>
+#include <QDate>
+#include <QtGlobal>
+#include <limits>
 
+enum class League : quint8 { Unknown, American, National };
+enum class RoofType : quint8 { Unknown, Open, Retractable, Fixed };
+enum class PlayingSurface : quint8 { Unknown, Grass, ArtificialTurf };
+
+League leagueFromString(const QString& text);
+RoofType roofTypeFromString(const QString& text);
+PlayingSurface playingSurfaceFromString(const QString& text);
+QString leagueName(League league);
+QString roofTypeName(RoofType roof);
+QString playingSurfaceName(PlayingSurface surface);
+
+// Typed column parsing. Opening dates are days since 1970-01-01; a bare year
+// counts as January 1st of that year. Feet is the first whole number.
+qint32 epochDayFromDate(const QDate& date);
+qint32 epochDayFromString(const QString& text);
+int feetFromString(const QString& text);
+
+// Low-cardinality text is dictionary encoded: location and typology are
+// codes into the shared StringDictionary tables, league/roof/surface are
+// one-byte enums, and souvenir names share the souvenir-name dictionary.
 struct StadiumInfo {
+    static const qint32 UnknownDay = std::numeric_limits<qint32>::min();
+
     QString teamName;
     QString stadiumName;
-    int seatingCapacity;
-    QString location;
-    QString playingSurface;
-    QString league;
     QString dateOpened;
-    int distanceToCenter;
-    QString ballparkTypology;
-    QString roofType;
     QVector<QPair<QString, double>> souvenirs;  // List of souvenirs and their prices
+    int seatingCapacity = 0;
+    int distanceToCenter = 0;
+    qint32 openedDay = UnknownDay;
+    quint32 locationCode = 0;
+    quint16 typologyCode = 0;
+    League league = League::Unknown;
+    RoofType roofType = RoofType::Unknown;
+    PlayingSurface playingSurface = PlayingSurface::Unknown;
+
+    QString location() const;
+    QString ballparkTypology() const;
+    void setLocation(const QString& location);
+    void setBallparkTypology(const QString& typology);
 };
 
-#endif // STADIUMINFO_H 
\ No newline at end of file
+// Estimated bytes per team for the stadium map, with every field stored as
+// its own QString (before) and with the dictionary encoding (after)
+struct StadiumMemoryStats {
+    int teams = 0;
+    qint64 plainBytes = 0;
+    qint64 encodedBytes = 0;
+    qint64 dictionaryBytes = 0;
+
+    double plainBytesPerTeam() const { return teams ? double(plainBytes) / teams : 0.0; }
+    double encodedBytesPerTeam() const { return teams ? double(encodedBytes + dictionaryBytes) / teams : 0.0; }
+};
+
+qint64 plainStadiumInfoBytes(const StadiumInfo& info);
+qint64 encodedStadiumInfoBytes(const StadiumInfo& info);
+
+#endif // STADIUMINFO_H
@@ -0,0 +1,93 @@
+#include "stadiumrangeindex.h"
+#include <algorithm>
+
+void StadiumRangeIndex::rebuild(const HashMap<QString, StadiumInfo>& stadiumMap) {
+    clear();
+    stadiumMap.forEach([this](const QString& teamName, const StadiumInfo& info) {
+        int row = teamNames.size();
+        teamNames.append(teamName);
+        columns[OpenedDay].append(info.openedDay);
+        columns[Capacity].append(info.seatingCapacity);
+        columns[CenterField].append(info.distanceToCenter);
+        // Rows with an unknown opening date stay out of the date index
+        if (info.openedDay != StadiumInfo::UnknownDay) {
+            sorted[OpenedDay].append(qMakePair(info.openedDay, row));
+        }
+        sorted[Capacity].append(qMakePair(qint32(info.seatingCapacity), row));
+        sorted[CenterField].append(qMakePair(qint32(info.distanceToCenter), row));
+    });
+    for (int column = 0; column < ColumnCount; ++column) {
+        std::sort(sorted[column].begin(), sorted[column].end());
+    }
+}
+
+void StadiumRangeIndex::clear() {
+    teamNames.clear();
+    for (int column = 0; column < ColumnCount; ++column) {
+        columns[column].clear();
+        sorted[column].clear();
+    }
+}
+
+QPair<int, int> StadiumRangeIndex::bounds(Column column, qint32 min, qint32 max) const {
+    const QVector<Entry>& index = sorted[column];
+    if (min > max) {
+        return qMakePair(0, 0);
+    }
+    auto begin = std::lower_bound(index.constBegin(), index.constEnd(), min,
+                                  [](const Entry& entry, qint32 key) { return entry.first < key; });
+    auto end = std::upper_bound(begin, index.constEnd(), max,
+                                [](qint32 key, const Entry& entry) { return key < entry.first; });
+    return qMakePair(int(begin - index.constBegin()), int(end - index.constBegin()));
+}
+
+int StadiumRangeIndex::countInRange(Column column, qint32 min, qint32 max) const {
+    QPair<int, int> range = bounds(column, min, max);
+    return range.second - range.first;
+}
+
+QStringList StadiumRangeIndex::teamsInRange(Column column, qint32 min, qint32 max) const {
+    QStringList teams;
+    QPair<int, int> range = bounds(column, min, max);
+    teams.reserve(range.second - range.first);
+    for (int i = range.first; i < range.second; ++i) {
+        teams.append(teamNames[sorted[column][i].second]);
+    }
+    return teams;
+}
+
+QStringList StadiumRangeIndex::teamsMatching(const QVector<Range>& ranges) const {
+    if (ranges.isEmpty()) {
+        return QStringList();
+    }
+
+    // Drive the scan from the narrowest range and filter on the others
+    int driver = 0;
+    QPair<int, int> driverBounds = bounds(ranges[0].column, ranges[0].min, ranges[0].max);
+    for (int i = 1; i < ranges.size(); ++i) {
+        QPair<int, int> candidate = bounds(ranges[i].column, ranges[i].min, ranges[i].max);
+        if (candidate.second - candidate.first < driverBounds.second - driverBounds.first) {
+            driver = i;
+            driverBounds = candidate;
+        }
+    }
+
+    QStringList teams;
+    const QVector<Entry>& index = sorted[ranges[driver].column];
+    for (int i = driverBounds.first; i < driverBounds.second; ++i) {
+        int row = index[i].second;
+        bool matches = true;
+        for (int r = 0; r < ranges.size() && matches; ++r) {
+            if (r == driver) {
+                continue;
+            }
+            qint32 value = valueAt(ranges[r].column, row);
+            matches = value >= ranges[r].min && value <= ranges[r].max
+                   && !(ranges[r].column == OpenedDay && value == StadiumInfo::UnknownDay);
+        }
+        if (matches) {
+            teams.append(teamNames[row]);
+        }
+    }
+    return teams;
+}
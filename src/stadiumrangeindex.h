@@ -0,0 +1,50 @@
+#ifndef STADIUMRANGEINDEX_H
+#define STADIUMRANGEINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QPair>
+#include "hashmap.h"
+#include "stadiuminfo.h"
+
+// Sorted in-memory indexes over the typed numeric stadium columns.
+// Each index is a (key, row) array sorted by key, so a range is two binary
+// searches plus the matching rows. Compound queries size every range in
+// O(log n) first and scan only the most selective one.
+class StadiumRangeIndex {
+public:
+    enum Column { OpenedDay, Capacity, CenterField, ColumnCount };
+
+    struct Range {
+        Column column;
+        qint32 min;  // inclusive
+        qint32 max;  // inclusive
+    };
+
+    void rebuild(const HashMap<QString, StadiumInfo>& stadiumMap);
+    void clear();
+
+    int size() const { return teamNames.size(); }
+
+    // Team names whose column value lies in [min, max], ordered by that value
+    QStringList teamsInRange(Column column, qint32 min, qint32 max) const;
+
+    // Team names matching every range, ordered by the most selective column
+    QStringList teamsMatching(const QVector<Range>& ranges) const;
+
+    // Number of rows in [min, max] without materializing them
+    int countInRange(Column column, qint32 min, qint32 max) const;
+
+private:
+    typedef QPair<qint32, int> Entry;  // (key, row)
+
+    QPair<int, int> bounds(Column column, qint32 min, qint32 max) const;
+    qint32 valueAt(Column column, int row) const { return columns[column][row]; }
+
+    QVector<QString> teamNames;
+    QVector<qint32> columns[ColumnCount];
+    QVector<Entry> sorted[ColumnCount];
+};
+
+#endif // STADIUMRANGEINDEX_H
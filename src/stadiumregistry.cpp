@@ -0,0 +1,166 @@
+#include "stadiumregistry.h"
+#include <algorithm>
+
+StadiumRegistry::StadiumRegistry() {}
+
+void StadiumRegistry::clear() {
+    teamNames.clear();
+    teamStadium.clear();
+    stadiumKeys.clear();
+    stadiumNames.clear();
+    stadiumNode.clear();
+    stadiumTeams.clear();
+    nodeKeys.clear();
+    nodeStadium.clear();
+    teamIndex.clear();
+    stadiumIndex.clear();
+    nodeIndex.clear();
+    teamHash.clear();
+    stadiumHash.clear();
+    nodeHash.clear();
+    sortedTeams.clear();
+}
+
+int StadiumRegistry::internStadium(const QString& key, const QString& displayName) {
+    auto it = stadiumIndex.constFind(key);
+    if (it != stadiumIndex.constEnd()) {
+        return it.value();
+    }
+    int id = stadiumKeys.size();
+    stadiumKeys.append(key);
+    stadiumNames.append(displayName);
+    stadiumNode.append(InvalidId);
+    stadiumTeams.append(QVector<int>());
+    stadiumIndex.insert(key, id);
+    return id;
+}
+
+void StadiumRegistry::rebuild(const HashMap<QString, StadiumInfo>& stadiumMap, const StadiumGraph* graph) {
+    clear();
+
+    // Graph nodes first so node IDs follow the graph's key order
+    if (graph) {
+        const QVector<NameKey> graphKeys = graph->stadiumKeys();
+        nodeKeys.reserve(graphKeys.size());
+        nodeStadium.reserve(graphKeys.size());
+        for (const NameKey& graphKey : graphKeys) {
+            const QString key = graphKey.toString();
+            if (key.isEmpty() || nodeIndex.contains(key)) {
+                continue;
+            }
+            int nodeId = nodeKeys.size();
+            nodeKeys.append(key);
+            nodeStadium.append(InvalidId);
+            nodeIndex.insert(key, nodeId);
+        }
+    }
+
+    const QVector<QPair<QString, StadiumInfo>> entries = stadiumMap.getAllEntries();
+    teamNames.reserve(entries.size());
+    teamStadium.reserve(entries.size());
+    for (const auto& entry : entries) {
+        const QString& team = entry.first;
+        if (team.isEmpty() || teamIndex.contains(team)) {
+            continue;
+        }
+        int teamId = teamNames.size();
+        teamNames.append(team);
+        teamIndex.insert(team, teamId);
+
+        QString display = entry.second.stadiumName.trimmed();
+        QString key = StadiumGraph::normalizeStadiumName(display);
+        int stadiumId = key.isEmpty() ? InvalidId : internStadium(key, display);
+        teamStadium.append(stadiumId);
+        if (stadiumId != InvalidId) {
+            stadiumTeams[stadiumId].append(teamId);
+        }
+    }
+
+    // Link graph nodes to stadiums; nodes without team data still get a stadium ID
+    for (int nodeId = 0; nodeId < nodeKeys.size(); ++nodeId) {
+        int stadiumId = internStadium(nodeKeys[nodeId], nodeKeys[nodeId]);
+        nodeStadium[nodeId] = stadiumId;
+        stadiumNode[stadiumId] = nodeId;
+    }
+
+    sortedTeams.resize(teamNames.size());
+    for (int i = 0; i < sortedTeams.size(); ++i) {
+        sortedTeams[i] = i;
+    }
+    std::sort(sortedTeams.begin(), sortedTeams.end(), [this](int a, int b) {
+        return teamNames[a] < teamNames[b];
+    });
+
+    freeze();
+}
+
+void StadiumRegistry::freeze() {
+    // The key sets are fixed until the next rebuild; each dynamic index is
+    // dropped once its perfect hash is in place
+    if (teamHash.build(teamNames)) {
+        teamIndex.clear();
+    }
+    if (stadiumHash.build(stadiumKeys)) {
+        stadiumIndex.clear();
+    }
+    if (nodeHash.build(nodeKeys)) {
+        nodeIndex.clear();
+    }
+}
+
+int StadiumRegistry::lookup(const MinimalPerfectHash& frozen, const QHash<QString, int>& index, const QString& key) {
+    return frozen.isBuilt() ? frozen.find(key) : index.value(key, InvalidId);
+}
+
+int StadiumRegistry::teamId(const QString& teamName) const {
+    return lookup(teamHash, teamIndex, teamName.trimmed());
+}
+
+int StadiumRegistry::stadiumId(const QString& stadiumName) const {
+    int id = lookup(stadiumHash, stadiumIndex, stadiumName);
+    if (id != InvalidId) {
+        return id;
+    }
+    return lookup(stadiumHash, stadiumIndex, StadiumGraph::normalizeStadiumName(stadiumName));
+}
+
+int StadiumRegistry::nodeId(const QString& normalizedName) const {
+    return lookup(nodeHash, nodeIndex, normalizedName);
+}
+
+QString StadiumRegistry::teamName(int teamId) const {
+    return isValidTeam(teamId) ? teamNames[teamId] : QString();
+}
+
+QString StadiumRegistry::stadiumName(int stadiumId) const {
+    return isValidStadium(stadiumId) ? stadiumNames[stadiumId] : QString();
+}
+
+QString StadiumRegistry::stadiumKey(int stadiumId) const {
+    return isValidStadium(stadiumId) ? stadiumKeys[stadiumId] : QString();
+}
+
+QString StadiumRegistry::nodeName(int nodeId) const {
+    return isValidNode(nodeId) ? nodeKeys[nodeId] : QString();
+}
+
+int StadiumRegistry::stadiumForTeam(int teamId) const {
+    return isValidTeam(teamId) ? teamStadium[teamId] : InvalidId;
+}
+
+const QVector<int>& StadiumRegistry::teamsForStadium(int stadiumId) const {
+    static const QVector<int> empty;
+    return isValidStadium(stadiumId) ? stadiumTeams[stadiumId] : empty;
+}
+
+int StadiumRegistry::nodeForStadium(int stadiumId) const {
+    return isValidStadium(stadiumId) ? stadiumNode[stadiumId] : InvalidId;
+}
+
+int StadiumRegistry::stadiumForNode(int nodeId) const {
+    return isValidNode(nodeId) ? nodeStadium[nodeId] : InvalidId;
+}
+
+int StadiumRegistry::nodeForTeam(int teamId) const {
+    return nodeForStadium(stadiumForTeam(teamId));
+}
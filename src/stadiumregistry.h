@@ -0,0 +1,86 @@
+#ifndef STADIUMREGISTRY_H
+#define STADIUMREGISTRY_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include "hashmap.h"
+#include "stadiuminfo.h"
+#include "stadiumgraph.h"
+#include "perfecthash.h"
+
+// Central identity registry for teams, stadiums and graph nodes.
+// Every entity gets a dense integer ID on rebuild(); IDs stay valid until
+// the next rebuild. All cross lookups are O(1) array or hash accesses.
+//
+// Name lookups go through minimal perfect hashes built at the end of
+// rebuild(); the QHash indexes are only used while the registry is filled.
+//
+// Stadium IDs cover the union of stadiums referenced by team data and the
+// nodes present in the graph, keyed by StadiumGraph::normalizeStadiumName.
+class StadiumRegistry {
+public:
+    static const int InvalidId = -1;
+
+    StadiumRegistry();
+
+    void rebuild(const HashMap<QString, StadiumInfo>& stadiumMap, const StadiumGraph* graph);
+    void clear();
+
+    int teamCount() const { return teamNames.size(); }
+    int stadiumCount() const { return stadiumKeys.size(); }
+    int nodeCount() const { return nodeKeys.size(); }
+
+    // Name -> ID (InvalidId when unknown)
+    int teamId(const QString& teamName) const;
+    int stadiumId(const QString& stadiumName) const;
+    int nodeId(const QString& normalizedName) const;
+
+    // ID -> name
+    QString teamName(int teamId) const;
+    QString stadiumName(int stadiumId) const;    // display name
+    QString stadiumKey(int stadiumId) const;     // normalized name
+    QString nodeName(int nodeId) const;          // normalized graph key
+
+    // Cross links
+    int stadiumForTeam(int teamId) const;
+    const QVector<int>& teamsForStadium(int stadiumId) const;
+    int nodeForStadium(int stadiumId) const;
+    int stadiumForNode(int nodeId) const;
+    int nodeForTeam(int teamId) const;
+
+    bool isValidTeam(int teamId) const { return teamId >= 0 && teamId < teamNames.size(); }
+    bool isValidStadium(int stadiumId) const { return stadiumId >= 0 && stadiumId < stadiumKeys.size(); }
+    bool isValidNode(int nodeId) const { return nodeId >= 0 && nodeId < nodeKeys.size(); }
+
+    // Team IDs ordered by team name, computed once per rebuild
+    const QVector<int>& teamsSortedByName() const { return sortedTeams; }
+
+private:
+    int internStadium(const QString& key, const QString& displayName);
+    void freeze();
+    static int lookup(const MinimalPerfectHash& frozen, const QHash<QString, int>& index, const QString& key);
+
+    QVector<QString> teamNames;
+    QVector<int> teamStadium;
+
+    QVector<QString> stadiumKeys;
+    QVector<QString> stadiumNames;
+    QVector<int> stadiumNode;
+    QVector<QVector<int>> stadiumTeams;
+
+    QVector<QString> nodeKeys;
+    QVector<int> nodeStadium;
+
+    QHash<QString, int> teamIndex;
+    QHash<QString, int> stadiumIndex;
+    QHash<QString, int> nodeIndex;
+
+    MinimalPerfectHash teamHash;
+    MinimalPerfectHash stadiumHash;
+    MinimalPerfectHash nodeHash;
+
+    QVector<int> sortedTeams;
+};
+
+#endif // STADIUMREGISTRY_H
@@ -0,0 +1,80 @@
+#include "stringdictionary.h"
+#include <QReadLocker>
+#include <QWriteLocker>
+
+StringDictionary::StringDictionary() {
+    values.append(QString());
+    index.insert(QString(), 0);
+}
+
+quint32 StringDictionary::intern(const QString& value) {
+    if (value.isEmpty()) {
+        return 0;
+    }
+    {
+        QReadLocker reader(&lock);
+        auto it = index.constFind(value);
+        if (it != index.constEnd()) {
+            return it.value();
+        }
+    }
+    QWriteLocker writer(&lock);
+    auto it = index.constFind(value);
+    if (it != index.constEnd()) {
+        return it.value();
+    }
+    quint32 code = quint32(values.size());
+    values.append(value);
+    index.insert(value, code);
+    return code;
+}
+
+QString StringDictionary::value(quint32 code) const {
+    QReadLocker reader(&lock);
+    return code < quint32(values.size()) ? values[code] : QString();
+}
+
+QString StringDictionary::shared(const QString& value) {
+    return this->value(intern(value));
+}
+
+int StringDictionary::size() const {
+    QReadLocker reader(&lock);
+    return values.size();
+}
+
+qint64 StringDictionary::memoryBytes() const {
+    QReadLocker reader(&lock);
+    // Each value is held once by the vector; the hash key shares its buffer
+    qint64 bytes = qint64(values.capacity()) * sizeof(QString);
+    bytes += qint64(index.capacity()) * (sizeof(QString) + sizeof(quint32) + sizeof(void*));
+    for (const QString& value : values) {
+        bytes += stringHeapBytes(value);
+    }
+    return bytes;
+}
+
+StringDictionary& StringDictionary::locations() {
+    static StringDictionary dictionary;
+    return dictionary;
+}
+
+StringDictionary& StringDictionary::typologies() {
+    static StringDictionary dictionary;
+    return dictionary;
+}
+
+StringDictionary& StringDictionary::souvenirNames() {
+    static StringDictionary dictionary;
+    return dictionary;
+}
+
+qint64 StringDictionary::stringHeapBytes(const QString& value) {
+    if (value.isEmpty()) {
+        return 0;
+    }
+    // Array header plus UTF-16 payload and terminator, rounded to the
+    // allocator's 16-byte granularity
+    qint64 bytes = 16 + (qint64(value.size()) + 1) * qint64(sizeof(QChar));
+    return (bytes + 15) & ~qint64(15);
+}
@@ -0,0 +1,40 @@
+#ifndef STRINGDICTIONARY_H
+#define STRINGDICTIONARY_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QReadWriteLock>
+
+// Append-only string dictionary for low-cardinality text columns.
+// Each distinct value is stored once and identified by a dense code; code 0
+// is always the empty string. Codes are stable for the life of the process.
+class StringDictionary {
+public:
+    StringDictionary();
+
+    quint32 intern(const QString& value);
+    QString value(quint32 code) const;
+
+    // Interns and returns the dictionary's copy, so callers that keep
+    // QStrings share one buffer per distinct value
+    QString shared(const QString& value);
+
+    int size() const;
+    qint64 memoryBytes() const;
+
+    // Process-wide dictionaries used by StadiumInfo
+    static StringDictionary& locations();
+    static StringDictionary& typologies();
+    static StringDictionary& souvenirNames();
+
+    // Approximate heap footprint of an unshared QString
+    static qint64 stringHeapBytes(const QString& value);
+
+private:
+    mutable QReadWriteLock lock;
+    QHash<QString, quint32> index;
+    QVector<QString> values;
+};
+
+#endif // STRINGDICTIONARY_H
@@ -0,0 +1,184 @@
+#include "teamlistmodel.h"
+#include <QAbstractItemView>
+
+namespace {
+
+const int FetchBatch = 256;
+const int MatchLimit = 12;
+
+} // namespace
+
+TeamListModel::TeamListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+void TeamListModel::reset(const StadiumRegistry *newRegistry)
+{
+    beginResetModel();
+    registry = newRegistry;
+    teamIds.clear();
+    teamRows.clear();
+    loaded = 0;
+    if (registry) {
+        teamIds = registry->teamsSortedByName();
+        teamRows.fill(-1, registry->teamCount());
+        for (int row = 0; row < teamIds.size(); ++row) {
+            teamRows[teamIds[row]] = row;
+        }
+        loaded = qMin(FetchBatch, teamIds.size());
+    }
+    endResetModel();
+}
+
+int TeamListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : loaded;
+}
+
+QVariant TeamListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= loaded || !registry) {
+        return QVariant();
+    }
+    const int teamId = teamIds[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        return registry->teamName(teamId);
+    case Qt::ToolTipRole:
+        return registry->stadiumName(registry->stadiumForTeam(teamId));
+    case TeamIdRole:
+        return teamId;
+    default:
+        return QVariant();
+    }
+}
+
+bool TeamListModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && loaded < teamIds.size();
+}
+
+void TeamListModel::fetchMore(const QModelIndex &parent)
+{
+    if (!parent.isValid()) {
+        fetchTo(qMin(loaded + FetchBatch, teamIds.size()) - 1);
+    }
+}
+
+void TeamListModel::fetchTo(int row)
+{
+    if (row < loaded) {
+        return;
+    }
+    beginInsertRows(QModelIndex(), loaded, row);
+    loaded = row + 1;
+    endInsertRows();
+}
+
+int TeamListModel::teamAt(int row) const
+{
+    return (row >= 0 && row < loaded) ? teamIds[row] : StadiumRegistry::InvalidId;
+}
+
+int TeamListModel::rowForTeam(int teamId)
+{
+    if (teamId < 0 || teamId >= teamRows.size() || teamRows[teamId] < 0) {
+        return -1;
+    }
+    fetchTo(teamRows[teamId]);
+    return teamRows[teamId];
+}
+
+// Ranked search results for TeamSearchCompleter
+class TeamMatchModel : public QAbstractListModel
+{
+public:
+    TeamMatchModel(const StadiumRegistry &registry, const TeamSearchIndex &index, QObject *parent)
+        : QAbstractListModel(parent), registry(registry), index(index) {}
+
+    void setHits(const QVector<TeamSearchHit> &newHits)
+    {
+        beginResetModel();
+        hits = newHits;
+        endResetModel();
+    }
+
+    int teamAt(int row) const
+    {
+        return (row >= 0 && row < hits.size()) ? hits[row].teamId : StadiumRegistry::InvalidId;
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : hits.size();
+    }
+
+    QVariant data(const QModelIndex &modelIndex, int role) const override
+    {
+        if (!modelIndex.isValid() || modelIndex.row() >= hits.size()) {
+            return QVariant();
+        }
+        const int teamId = hits[modelIndex.row()].teamId;
+        switch (role) {
+        case Qt::DisplayRole: {
+            QString detail = registry.stadiumName(registry.stadiumForTeam(teamId));
+            QString location = index.location(teamId);
+            if (!location.isEmpty()) {
+                detail += ", " + location;
+            }
+            return QString("%1 (%2)").arg(registry.teamName(teamId), detail);
+        }
+        case Qt::EditRole:
+            return registry.teamName(teamId);
+        case TeamListModel::TeamIdRole:
+            return teamId;
+        default:
+            return QVariant();
+        }
+    }
+
+private:
+    const StadiumRegistry &registry;
+    const TeamSearchIndex &index;
+    QVector<TeamSearchHit> hits;
+};
+
+TeamSearchCompleter::TeamSearchCompleter(const TeamSearchIndex &index, const StadiumRegistry &registry,
+                                         QLineEdit *lineEdit)
+    : QCompleter(lineEdit)
+    , index(index)
+    , registry(registry)
+    , matches(new TeamMatchModel(registry, index, this))
+{
+    // Matches are already ranked by the index, so the completer must not refilter them
+    setModel(matches);
+    setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    setCompletionRole(Qt::EditRole);
+    setMaxVisibleItems(MatchLimit);
+    lineEdit->setCompleter(this);
+
+    connect(lineEdit, &QLineEdit::textEdited, this, &TeamSearchCompleter::updateMatches);
+    connect(this, QOverload<const QModelIndex &>::of(&QCompleter::activated),
+            this, &TeamSearchCompleter::onActivated);
+}
+
+void TeamSearchCompleter::updateMatches(const QString &text)
+{
+    matches->setHits(index.search(text, MatchLimit));
+    if (matches->rowCount() > 0) {
+        complete();
+    } else if (popup()) {
+        popup()->hide();
+    }
+}
+
+void TeamSearchCompleter::onActivated(const QModelIndex &modelIndex)
+{
+    // The popup's index can belong to the completer's proxy, so go by the edit text
+    int teamId = registry.teamId(modelIndex.data(Qt::EditRole).toString());
+    if (teamId != StadiumRegistry::InvalidId) {
+        emit teamActivated(teamId);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef TEAMLISTMODEL_H
+#define TEAMLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QCompleter>
+#include <QLineEdit>
+#include <QVector>
+#include "stadiumregistry.h"
+#include "teamsearchindex.h"
+
+// Read-only list of teams sorted by name, shared by every team picker.
+// Rows are exposed in batches through canFetchMore()/fetchMore(), so views
+// only create rows as they scroll. Qt::UserRole holds the registry team ID.
+class TeamListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    static const int TeamIdRole = Qt::UserRole;
+
+    explicit TeamListModel(QObject *parent = nullptr);
+
+    void reset(const StadiumRegistry *registry);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    int teamAt(int row) const;
+    // Row of the team, fetching rows up to it if needed; -1 when unknown
+    int rowForTeam(int teamId);
+
+private:
+    void fetchTo(int row);
+
+    const StadiumRegistry *registry = nullptr;
+    QVector<int> teamIds;
+    QVector<int> teamRows;
+    int loaded = 0;
+};
+
+class TeamMatchModel;
+
+// Completer for a search field backed by TeamSearchIndex. The popup lists
+// ranked matches as "Team (Stadium, Location)" and teamActivated() reports
+// the chosen team ID.
+class TeamSearchCompleter : public QCompleter
+{
+    Q_OBJECT
+
+public:
+    TeamSearchCompleter(const TeamSearchIndex &index, const StadiumRegistry &registry, QLineEdit *lineEdit);
+
+signals:
+    void teamActivated(int teamId);
+
+private slots:
+    void updateMatches(const QString &text);
+    void onActivated(const QModelIndex &index);
+
+private:
+    const TeamSearchIndex &index;
+    const StadiumRegistry &registry;
+    TeamMatchModel *matches;
+};
+
+#endif // TEAMLISTMODEL_H
@@ -0,0 +1,176 @@
+#include "teamsearchindex.h"
+#include <algorithm>
+
+namespace {
+
+const float WordPrefixBonus = 0.5f;
+const float NamePrefixBonus = 1.0f;
+
+quint64 packTrigram(QChar a, QChar b, QChar c) {
+    return (quint64(a.unicode()) << 32) | (quint64(b.unicode()) << 16) | quint64(c.unicode());
+}
+
+} // namespace
+
+QString TeamSearchIndex::normalize(const QString& text) {
+    // Lowercase letters and digits, every other run of characters becomes one space
+    QString result;
+    result.reserve(text.size());
+    bool pendingSpace = false;
+    for (QChar c : text) {
+        if (c.isLetterOrNumber()) {
+            if (pendingSpace && !result.isEmpty()) {
+                result.append(QChar(' '));
+            }
+            pendingSpace = false;
+            result.append(c.toLower());
+        } else {
+            pendingSpace = true;
+        }
+    }
+    return result;
+}
+
+void TeamSearchIndex::collectTrigrams(const QString& normalized, bool padLastWord, QVector<quint64>& out) {
+    const QStringList parts = normalized.split(QChar(' '), Qt::SkipEmptyParts);
+    for (int w = 0; w < parts.size(); ++w) {
+        // A query's last word may still be incomplete, so it gets no end padding
+        QString padded = "  " + parts[w];
+        if (padLastWord || w + 1 < parts.size()) {
+            padded += QChar(' ');
+        }
+        for (int i = 0; i + 3 <= padded.size(); ++i) {
+            out.append(packTrigram(padded[i], padded[i + 1], padded[i + 2]));
+        }
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+void TeamSearchIndex::clear() {
+    teamKeys.clear();
+    locations.clear();
+    trigramCounts.clear();
+    postings.clear();
+    words.clear();
+    sharedCounts.clear();
+    bonus.clear();
+    touched.clear();
+    wordStamps.clear();
+}
+
+void TeamSearchIndex::rebuild(const StadiumRegistry& registry, const HashMap<QString, StadiumInfo>& stadiumMap) {
+    clear();
+    const int teams = registry.teamCount();
+    teamKeys.resize(teams);
+    locations.resize(teams);
+    trigramCounts.resize(teams);
+
+    QVector<quint64> trigrams;
+    for (int teamId = 0; teamId < teams; ++teamId) {
+        const QString teamName = registry.teamName(teamId);
+        StadiumInfo info;
+        stadiumMap.get(teamName, info);
+        locations[teamId] = info.location();
+
+        teamKeys[teamId] = normalize(teamName);
+        const QString document = teamKeys[teamId] + ' '
+                               + normalize(registry.stadiumName(registry.stadiumForTeam(teamId))) + ' '
+                               + normalize(locations[teamId]);
+
+        trigrams.clear();
+        collectTrigrams(document, true, trigrams);
+        trigramCounts[teamId] = trigrams.size();
+        for (quint64 trigram : trigrams) {
+            postings[trigram].append(teamId);
+        }
+
+        QStringList parts = document.split(QChar(' '), Qt::SkipEmptyParts);
+        parts.removeDuplicates();
+        for (const QString& part : parts) {
+            words.append(qMakePair(part, teamId));
+        }
+    }
+    std::sort(words.begin(), words.end());
+
+    sharedCounts.fill(0, teams);
+    bonus.fill(0.0f, teams);
+    wordStamps.fill(0, teams);
+    stamp = 0;
+}
+
+QString TeamSearchIndex::location(int teamId) const {
+    return (teamId >= 0 && teamId < locations.size()) ? locations[teamId] : QString();
+}
+
+QVector<TeamSearchHit> TeamSearchIndex::search(const QString& query, int limit) const {
+    QVector<TeamSearchHit> hits;
+    const QString normalized = normalize(query);
+    if (normalized.isEmpty() || limit <= 0 || teamKeys.isEmpty()) {
+        return hits;
+    }
+
+    QVector<quint64> trigrams;
+    collectTrigrams(normalized, false, trigrams);
+    for (quint64 trigram : trigrams) {
+        auto it = postings.constFind(trigram);
+        if (it == postings.constEnd()) {
+            continue;
+        }
+        for (int teamId : it.value()) {
+            if (sharedCounts[teamId] == 0 && bonus[teamId] == 0.0f) {
+                touched.append(teamId);
+            }
+            ++sharedCounts[teamId];
+        }
+    }
+
+    // Word prefixes: every team with a word starting with a query word
+    const QStringList queryWords = normalized.split(QChar(' '), Qt::SkipEmptyParts);
+    for (const QString& word : queryWords) {
+        auto it = std::lower_bound(words.constBegin(), words.constEnd(), qMakePair(word, -1));
+        ++stamp;
+        for (; it != words.constEnd() && it->first.startsWith(word); ++it) {
+            int teamId = it->second;
+            if (wordStamps[teamId] == stamp) {
+                continue;  // several of this team's words share the prefix
+            }
+            wordStamps[teamId] = stamp;
+            if (sharedCounts[teamId] == 0 && bonus[teamId] == 0.0f) {
+                touched.append(teamId);
+            }
+            bonus[teamId] += WordPrefixBonus / queryWords.size();
+        }
+    }
+
+    hits.reserve(touched.size());
+    const int queryCount = trigrams.size();
+    for (int teamId : touched) {
+        const int shared = sharedCounts[teamId];
+        float score = bonus[teamId];
+        if (shared > 0) {
+            score += float(shared) / float(queryCount + trigramCounts[teamId] - shared);
+        }
+        if (teamKeys[teamId].startsWith(normalized)) {
+            score += NamePrefixBonus;
+        }
+        hits.append(TeamSearchHit{teamId, score});
+        sharedCounts[teamId] = 0;
+        bonus[teamId] = 0.0f;
+    }
+    touched.clear();
+
+    auto better = [this](const TeamSearchHit& a, const TeamSearchHit& b) {
+        if (a.score != b.score) {
+            return a.score > b.score;
+        }
+        return teamKeys[a.teamId] < teamKeys[b.teamId];
+    };
+    if (hits.size() > limit) {
+        std::partial_sort(hits.begin(), hits.begin() + limit, hits.end(), better);
+        hits.resize(limit);
+    } else {
+        std::sort(hits.begin(), hits.end(), better);
+    }
+    return hits;
+}
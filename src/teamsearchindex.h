@@ -0,0 +1,54 @@
+#ifndef TEAMSEARCHINDEX_H
+#define TEAMSEARCHINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include "hashmap.h"
+#include "stadiuminfo.h"
+#include "stadiumregistry.h"
+
+struct TeamSearchHit {
+    int teamId;
+    float score;
+};
+
+// Fuzzy search over team, stadium and location names.
+// Every word is indexed by its padded trigrams ("  ne", " ne", "new", ...)
+// and by a sorted word list for prefix lookups. A query scores the teams it
+// shares trigrams with (Jaccard similarity), adds bonuses for word prefixes
+// and for team names starting with the query, and returns the best hits.
+// Search reuses scratch buffers, so one index must not be queried from
+// several threads at once.
+class TeamSearchIndex {
+public:
+    void rebuild(const StadiumRegistry& registry, const HashMap<QString, StadiumInfo>& stadiumMap);
+    void clear();
+
+    QVector<TeamSearchHit> search(const QString& query, int limit = 10) const;
+
+    int teamCount() const { return teamKeys.size(); }
+    QString location(int teamId) const;
+
+    static QString normalize(const QString& text);
+
+private:
+    static void collectTrigrams(const QString& normalized, bool padLastWord, QVector<quint64>& out);
+
+    QVector<QString> teamKeys;      // normalized team name per team ID
+    QVector<QString> locations;     // display location per team ID
+    QVector<int> trigramCounts;     // distinct trigrams per team ID
+    QHash<quint64, QVector<int>> postings;
+    QVector<QPair<QString, int>> words;  // (normalized word, team ID), sorted
+
+    // Query scratch, sized to the team count
+    mutable QVector<quint16> sharedCounts;
+    mutable QVector<float> bonus;
+    mutable QVector<int> touched;
+    mutable QVector<quint32> wordStamps;
+    mutable quint32 stamp = 0;
+};
+
+#endif // TEAMSEARCHINDEX_H
@@ -2,25 +2,96 @@
 #include <algorithm>
 #include <cmath>
 
-Trip::Trip() {}
+Trip::Trip()
+    : prefixValid(0), distanceTotal(0.0), costTotal(0.0), unreachableLegs(0) {}
+
+Trip::Trip(StadiumGraph::Snapshot graph)
+    : prefixValid(0), distanceTotal(0.0), costTotal(0.0), unreachableLegs(0), graph(std::move(graph)) {}
+
+void Trip::setGraph(StadiumGraph::Snapshot newGraph) {
+    graph = std::move(newGraph);
+    legCache.clear();
+    rebuildLegs();
+}
 
 void Trip::addStop(const QString& stadiumName) {
+    insertStop(stops.size(), stadiumName);
+}
+
+void Trip::insertStop(int index, const QString& stadiumName) {
+    if (index < 0 || index > stops.size()) {
+        return;
+    }
     TripStop stop;
     stop.stadiumName = stadiumName;
+    stop.stadiumKey = StadiumGraph::normalizeStadiumName(stadiumName);
     stop.totalCost = 0.0;
-    stops.append(stop);
+
+    int count = stops.size();
+    stops.insert(index, stop);
+    if (count == 0) {
+        invalidatePrefix(0);
+        return;
+    }
+    if (index == 0) {
+        insertLeg(0, computeLeg(stops[0], stops[1]));
+    } else if (index == count) {
+        insertLeg(count - 1, computeLeg(stops[count - 1], stops[count]));
+    } else {
+        // Split the leg prev -> next into prev -> new -> next
+        setLeg(index - 1, computeLeg(stops[index - 1], stops[index]));
+        insertLeg(index, computeLeg(stops[index], stops[index + 1]));
+    }
 }
 
 void Trip::removeStop(int index) {
-    if (index >= 0 && index < stops.size()) {
-        stops.remove(index);
+    if (index < 0 || index >= stops.size()) {
+        return;
+    }
+    int count = stops.size();
+    costTotal -= stops[index].totalCost;
+    if (count > 1) {
+        if (index == 0) {
+            removeLeg(0);
+        } else if (index == count - 1) {
+            removeLeg(count - 2);
+        } else {
+            // Join prev -> removed -> next into prev -> next
+            removeLeg(index);
+            setLeg(index - 1, computeLeg(stops[index - 1], stops[index + 1]));
+        }
+    }
+    stops.remove(index);
+    invalidatePrefix(index);
+}
+
+void Trip::moveStop(int from, int to) {
+    if (from < 0 || from >= stops.size() || to < 0 || to >= stops.size() || from == to) {
+        return;
     }
+    TripStop stop = stops[from];
+    removeStop(from);
+    insertStop(to, stop.stadiumName);
+    stops[to].purchasedSouvenirs = stop.purchasedSouvenirs;
+    stops[to].totalCost = stop.totalCost;
+    costTotal += stop.totalCost;
+}
+
+void Trip::clear() {
+    stops.clear();
+    legs.clear();
+    prefix.clear();
+    prefixValid = 0;
+    distanceTotal = 0.0;
+    costTotal = 0.0;
+    unreachableLegs = 0;
 }
 
 void Trip::addSouvenir(int stopIndex, const QString& souvenirName, int quantity, double price) {
     if (stopIndex >= 0 && stopIndex < stops.size()) {
         stops[stopIndex].purchasedSouvenirs.append(qMakePair(souvenirName, quantity));
         stops[stopIndex].totalCost += price * quantity;
+        costTotal += price * quantity;
     }
 }
 
@@ -29,6 +100,7 @@ void Trip::sortByStadiumName() {
               [](const TripStop& a, const TripStop& b) {
                   return a.stadiumName < b.stadiumName;
               });
+    rebuildLegs();
 }
 
 QVector<TripStop> Trip::getStops() const {
@@ -36,22 +108,134 @@ QVector<TripStop> Trip::getStops() const {
 }
 
 double Trip::calculateTotalCost() const {
-    double total = 0.0;
-    for (const auto& stop : stops) {
-        total += stop.totalCost;
-    }
-    return total;
+    return costTotal;
 }
 
-double Trip::calculateTotalDistance(const StadiumGraph& graph) const {
+double Trip::calculateTotalDistance(const StadiumGraph& other) const {
+    if (&other == graph.get()) {
+        return distanceTotal;
+    }
+    // Not the bound graph: walk the trip once against the given one
     double total = 0.0;
     for (int i = 0; i < stops.size() - 1; ++i) {
-        const QString& from = stops[i].stadiumName;
-        const QString& to = stops[i + 1].stadiumName;
-        double dist = graph.getDistance(from, to);
+        const QString& from = stops[i].stadiumKey;
+        const QString& to = stops[i + 1].stadiumKey;
+        double dist = other.getEdgeWeight(from, to);
+        if (dist < 0) {
+            QVector<QString> path;
+            dist = other.dijkstra(from, to, path);
+        }
         if (dist >= 0) {
             total += dist;
         }
     }
     return total;
-} 
\ No newline at end of file
+}
+
+double Trip::legDistance(int legIndex) const {
+    if (legIndex < 0 || legIndex >= legs.size()) {
+        return -1.0;
+    }
+    return legs[legIndex];
+}
+
+double Trip::distanceToStop(int stopIndex) const {
+    if (stopIndex < 0 || stopIndex >= stops.size()) {
+        return -1.0;
+    }
+    if (prefix.size() != stops.size()) {
+        prefix.resize(stops.size());
+    }
+    if (prefixValid == 0) {
+        prefix[0] = 0.0;
+        prefixValid = 1;
+    }
+    while (prefixValid <= stopIndex) {
+        double leg = legs[prefixValid - 1];
+        prefix[prefixValid] = prefix[prefixValid - 1] + (leg >= 0 ? leg : 0.0);
+        ++prefixValid;
+    }
+    return prefix[stopIndex];
+}
+
+double Trip::computeLeg(const TripStop& from, const TripStop& to) const {
+    if (!graph || from.stadiumKey.isEmpty() || to.stadiumKey.isEmpty()) {
+        return -1.0;
+    }
+    if (from.stadiumKey == to.stadiumKey) {
+        return 0.0;
+    }
+    // Distances are symmetric, so cache on the ordered pair
+    QPair<QString, QString> key = from.stadiumKey < to.stadiumKey
+        ? qMakePair(from.stadiumKey, to.stadiumKey)
+        : qMakePair(to.stadiumKey, from.stadiumKey);
+    auto it = legCache.constFind(key);
+    if (it != legCache.constEnd()) {
+        return it.value();
+    }
+    double dist = graph->getEdgeWeight(key.first, key.second);
+    if (dist < 0) {
+        // Not adjacent: route through the shortest path
+        QVector<QString> path;
+        dist = graph->dijkstra(key.first, key.second, path);
+    }
+    legCache.insert(key, dist);
+    return dist;
+}
+
+void Trip::insertLeg(int legIndex, double distance) {
+    legs.insert(legIndex, distance);
+    if (distance >= 0) {
+        distanceTotal += distance;
+    } else {
+        ++unreachableLegs;
+    }
+    invalidatePrefix(legIndex + 1);
+}
+
+void Trip::removeLeg(int legIndex) {
+    double old = legs[legIndex];
+    if (old >= 0) {
+        distanceTotal -= old;
+    } else {
+        --unreachableLegs;
+    }
+    legs.remove(legIndex);
+    invalidatePrefix(legIndex + 1);
+}
+
+void Trip::setLeg(int legIndex, double distance) {
+    double old = legs[legIndex];
+    if (old >= 0) {
+        distanceTotal -= old;
+    } else {
+        --unreachableLegs;
+    }
+    legs[legIndex] = distance;
+    if (distance >= 0) {
+        distanceTotal += distance;
+    } else {
+        ++unreachableLegs;
+    }
+    invalidatePrefix(legIndex + 1);
+}
+
+void Trip::invalidatePrefix(int fromStop) {
+    prefixValid = qMin(prefixValid, fromStop);
+}
+
+void Trip::rebuildLegs() {
+    legs.clear();
+    distanceTotal = 0.0;
+    unreachableLegs = 0;
+    for (int i = 0; i + 1 < stops.size(); ++i) {
+        double dist = computeLeg(stops[i], stops[i + 1]);
+        legs.append(dist);
+        if (dist >= 0) {
+            distanceTotal += dist;
+        } else {
+            ++unreachableLegs;
+        }
+    }
+    invalidatePrefix(0);
+}
@@ -4,29 +4,64 @@
 #include <QString>
 #include <QVector>
 #include <QPair>
+#include <QHash>
 #include "hashmap.h"
 #include "stadiumgraph.h"
 
 struct TripStop {
     QString stadiumName;
+    QString stadiumKey;  // normalized graph key, computed once when the stop is added
     QVector<QPair<QString, int>> purchasedSouvenirs;  // (souvenir name, quantity)
     double totalCost;
 };
 
+// Ordered list of stops with running totals.
+// Per-leg distances are cached (legs[i] is stop i -> stop i + 1) and the trip
+// distance and cost are adjusted in O(1) on insert, remove and move, so reading
+// the totals never re-walks the trip. Legs without a direct edge are routed
+// through the shortest path in the bound graph snapshot, which stays fixed
+// until setGraph() is called again.
 class Trip {
 public:
     Trip();
-    
+    explicit Trip(StadiumGraph::Snapshot graph);
+
+    void setGraph(StadiumGraph::Snapshot graph);
+
     void addStop(const QString& stadiumName);
+    void insertStop(int index, const QString& stadiumName);
     void removeStop(int index);
+    void moveStop(int from, int to);
+    void clear();
     void addSouvenir(int stopIndex, const QString& souvenirName, int quantity, double price);
     void sortByStadiumName();
     QVector<TripStop> getStops() const;
+    int stopCount() const { return stops.size(); }
     double calculateTotalCost() const;
     double calculateTotalDistance(const StadiumGraph& graph) const;
 
+    double totalDistance() const { return distanceTotal; }
+    double legDistance(int legIndex) const;
+    double distanceToStop(int stopIndex) const;  // cumulative distance from the first stop
+    int unreachableLegCount() const { return unreachableLegs; }
+
 private:
+    double computeLeg(const TripStop& from, const TripStop& to) const;
+    void insertLeg(int legIndex, double distance);
+    void removeLeg(int legIndex);
+    void setLeg(int legIndex, double distance);
+    void invalidatePrefix(int fromStop);
+    void rebuildLegs();
+
     QVector<TripStop> stops;
+    QVector<double> legs;              // -1 when the two stops are not connected
+    mutable QVector<double> prefix;    // prefix[i] = distance from stop 0 to stop i
+    mutable int prefixValid;           // prefix[0 .. prefixValid) is up to date
+    double distanceTotal;
+    double costTotal;
+    int unreachableLegs;
+    StadiumGraph::Snapshot graph;
+    mutable QHash<QPair<QString, QString>, double> legCache;
 };
 
-#endif // TRIP_H 
\ No newline at end of file
+#endif // TRIP_H
@@ -4,15 +4,23 @@
 #include <QInputDialog>
 #include <QDebug>
 
-TripPlanner::TripPlanner(const HashMap<QString, StadiumInfo>& stadiumMap, StadiumGraph* stadiumGraph, QWidget *parent)
+TripPlanner::TripPlanner(const HashMap<QString, StadiumInfo>& stadiumMap, StadiumGraph* stadiumGraph,
+                         const StadiumRegistry& registry, TeamListModel* teamModel,
+                         const TeamSearchIndex& searchIndex, QWidget *parent)
     : QDialog(parent)
     , ui(new Ui::TripPlanner)
     , stadiumMap(stadiumMap)
     , stadiumGraph(stadiumGraph)
+    , registry(registry)
+    , teamModel(teamModel)
 {
     ui->setupUi(this);
     setWindowTitle("Trip Planner");
+    currentTrip.setGraph(stadiumGraph ? stadiumGraph->snapshot() : StadiumGraph::Snapshot());
+    souvenirCart.rebuildPriceIndex(stadiumMap, registry);
     refreshStadiumLists();
+    TeamSearchCompleter* completer = new TeamSearchCompleter(searchIndex, registry, ui->stadiumSearchEdit);
+    connect(completer, &TeamSearchCompleter::teamActivated, this, &TripPlanner::selectAvailableTeam);
     ui->tripStadiumsList->setSelectionMode(QAbstractItemView::SingleSelection);
     connect(ui->tripStadiumsList, &QListWidget::itemSelectionChanged, this, &TripPlanner::updateSouvenirTableForSelectedStadium);
     connect(ui->removeStopButton, &QPushButton::clicked, this, &TripPlanner::on_removeStopButton_clicked);
@@ -23,6 +31,7 @@ TripPlanner::TripPlanner(const HashMap<QString, StadiumInfo>& stadiumMap, Stadiu
 }
 
 TripPlanner::~TripPlanner() {
+    routeToken.cancel();
     delete ui;
 }
 
@@ -33,54 +42,59 @@ void TripPlanner::on_dijkstraButton_clicked()
         QMessageBox::warning(this, "Error", "Please add at least one stadium to your trip.");
         return;
     }
-    QString startTeam = ui->tripStadiumsList->item(0)->text();
-    StadiumInfo startInfo;
-    if (!stadiumMap.get(startTeam, startInfo)) {
-        QMessageBox::warning(this, "Error", QString("Could not find stadium for team '%1'").arg(startTeam));
+    int startTeamId = ui->tripStadiumsList->item(0)->data(Qt::UserRole).toInt();
+    int startStadiumId = registry.stadiumForTeam(startTeamId);
+    if (startStadiumId == StadiumRegistry::InvalidId) {
+        QMessageBox::warning(this, "Error", QString("Could not find stadium for team '%1'")
+                             .arg(ui->tripStadiumsList->item(0)->text()));
         return;
     }
-    QString startStadium = startInfo.stadiumName.trimmed();
+    QString startStadium = registry.stadiumName(startStadiumId);
 
-    // Get all user-friendly stadium names for the dropdown
-    QVector<QString> stadiums;
-    QVector<QPair<QString, StadiumInfo>> entries = stadiumMap.getAllEntries();
-    for (const auto& entry : entries) {
-        stadiums.append(entry.second.stadiumName.trimmed());
+    // Offer every team stadium as a destination, keeping the IDs alongside the labels
+    QStringList stadiums;
+    QVector<int> stadiumIds;
+    QVector<bool> listed(registry.stadiumCount(), false);
+    for (int teamId : registry.teamsSortedByName()) {
+        int stadiumId = registry.stadiumForTeam(teamId);
+        if (!registry.isValidStadium(stadiumId) || listed[stadiumId]) {
+            continue;
+        }
+        listed[stadiumId] = true;
+        stadiums << registry.stadiumName(stadiumId);
+        stadiumIds << stadiumId;
     }
     bool ok = false;
     QString endStadium = QInputDialog::getItem(this, "Select Destination", "Choose destination stadium:", stadiums, 0, false, &ok);
-    if (!ok || startStadium.isEmpty() || endStadium.isEmpty()) {
+    int endIndex = stadiums.indexOf(endStadium);
+    if (!ok || startStadium.isEmpty() || endIndex < 0) {
         QMessageBox::warning(this, "Error", "Please select both start and end stadiums");
         return;
     }
-    // Normalize for lookup
-    QString nStart = StadiumGraph::normalizeStadiumName(startStadium);
-    QString nEnd = StadiumGraph::normalizeStadiumName(endStadium);
-    QVector<QString> normalizedStadiums;
-    for (const QString& s : stadiums) normalizedStadiums << StadiumGraph::normalizeStadiumName(s);
-    if (!normalizedStadiums.contains(nStart)) {
+    int endStadiumId = stadiumIds[endIndex];
+    int startNode = registry.nodeForStadium(startStadiumId);
+    int endNode = registry.nodeForStadium(endStadiumId);
+    if (startNode == StadiumRegistry::InvalidId) {
         QMessageBox::warning(this, "Error", QString("Start stadium '%1' not found in graph.").arg(startStadium));
         return;
     }
-    if (!normalizedStadiums.contains(nEnd)) {
+    if (endNode == StadiumRegistry::InvalidId) {
         QMessageBox::warning(this, "Error", QString("End stadium '%1' not found in graph.").arg(endStadium));
         return;
     }
-    // Defensive: Check that both stadiums exist in the graph adjacency matrix
-    if (!stadiumGraph->getStadiums().contains(StadiumGraph::normalizeStadiumName(startStadium))) {
-        QMessageBox::warning(this, "Error", QString("Start stadium '%1' not found in graph adjacency matrix.").arg(startStadium));
-        return;
-    }
-    if (!stadiumGraph->getStadiums().contains(StadiumGraph::normalizeStadiumName(endStadium))) {
-        QMessageBox::warning(this, "Error", QString("End stadium '%1' not found in graph adjacency matrix.").arg(endStadium));
-        return;
-    }
-    // Print all stadiums in the graph before running Dijkstra
-    qDebug() << "All stadiums in graph (adjMatrix keys):" << stadiumGraph->getStadiums();
-    qDebug() << "Dijkstra start team:" << startTeam << ", stadium:" << startStadium << ", normalized:" << nStart;
-    qDebug() << "Dijkstra end stadium:" << endStadium << ", normalized:" << nEnd;
-    QVector<QString> path;
-    double distance = stadiumGraph->dijkstra(startStadium, endStadium, path);
+    qDebug() << "Dijkstra start:" << startStadium << "node" << startNode
+             << ", end:" << endStadium << "node" << endNode;
+    // A newer request supersedes one still running
+    routeToken.cancel();
+    routeToken = CancellationToken();
+    ui->tripSummaryText->setText("Computing shortest path...");
+    AsyncTasks::shortestRoute(stadiumGraph->snapshot(), registry.nodeName(startNode), registry.nodeName(endNode), routeToken)
+        .then(this, [this](const RouteResult& route) { showShortestPath(route.path, route.distance); })
+        .onFailed(this, [](const OperationCancelled&) {});
+}
+
+void TripPlanner::showShortestPath(const QVector<QString>& path, double distance)
+{
     qDebug() << "Dijkstra result distance:" << distance << ", path:" << path;
     // Defensive: Check for empty/null/invalid path
     if (distance < 0 || path.isEmpty()) {
@@ -110,7 +124,7 @@ void TripPlanner::on_dijkstraButton_clicked()
 void TripPlanner::on_mstButton_clicked()
 {
     QVector<QPair<QString, QString>> mst;
-    double totalWeight = stadiumGraph->minimumSpanningTree(mst);
+    double totalWeight = stadiumGraph->snapshot()->minimumSpanningTree(mst);
     QString summary = "Minimum Spanning Tree:\n";
     int validEdgeCount = 0;
     for (const auto& edge : mst) {
@@ -133,36 +147,33 @@ void TripPlanner::on_mstButton_clicked()
 
 void TripPlanner::on_dfsButton_clicked()
 {
-    // Use selected team from dfsBfsStartCombo, map to stadium name
-    QString teamName;
-    if (ui->dfsBfsStartCombo && ui->dfsBfsStartCombo->currentText().trimmed().size() > 0) {
-        teamName = ui->dfsBfsStartCombo->currentText().trimmed();
+    // Use selected team from dfsBfsStartCombo, resolved through the registry
+    int teamId = StadiumRegistry::InvalidId;
+    if (ui->dfsBfsStartCombo && ui->dfsBfsStartCombo->currentIndex() >= 0) {
+        teamId = ui->dfsBfsStartCombo->currentData().toInt();
     } else {
-        teamName = "San Francisco Giants";
-    }
-    StadiumInfo info;
-    QString startStadium;
-    if (stadiumMap.get(teamName, info)) {
-        startStadium = info.stadiumName.trimmed();
-    } else {
-        startStadium = teamName;
-    }
-    QString normalizedStart = StadiumGraph::normalizeStadiumName(startStadium);
-    qDebug() << "All stadiums in graph:" << stadiumGraph->getStadiums();
-    qDebug() << "Trying to start DFS at normalized stadium:" << normalizedStart;
-    if (!stadiumGraph->getStadiums().contains(normalizedStart)) {
-        QMessageBox::warning(this, "Error", teamName + " not found in the graph (normalized: " + normalizedStart + ").");
+        teamId = registry.teamId("San Francisco Giants");
+    }
+    int stadiumId = registry.stadiumForTeam(teamId);
+    int startNode = registry.nodeForStadium(stadiumId);
+    QString startStadium = registry.stadiumName(stadiumId);
+    if (startNode == StadiumRegistry::InvalidId) {
+        QString teamName = registry.teamName(teamId);
+        QMessageBox::warning(this, "Error", (teamName.isEmpty() ? QString("Selected team") : teamName)
+                             + " not found in the graph.");
         return;
     }
+    QString normalizedStart = registry.nodeName(startNode);
+    qDebug() << "Trying to start DFS at node" << startNode << normalizedStart;
     QVector<QString> path;
-    double distance = stadiumGraph->dfs(normalizedStart, path);
+    double distance = stadiumGraph->snapshot()->dfs(normalizedStart, path);
     if (distance < 0 || path.isEmpty()) {
         QMessageBox::warning(this, "Trip Error", "No path found from " + startStadium + ".");
         ui->tripSummaryText->setText("No path found from " + startStadium + ".");
         ui->totalDistanceLabel->setText("Total Distance: 0 miles");
         return;
     }
-    if (path.size() < stadiumGraph->getStadiums().size()) {
+    if (path.size() < registry.nodeCount()) {
         QMessageBox::warning(this, "Trip Warning", "Not all stadiums are reachable from " + startStadium + ".");
     }
     QString summary = "DFS Traversal (" + startStadium + "):\n";
@@ -183,36 +194,33 @@ void TripPlanner::on_dfsButton_clicked()
 
 void TripPlanner::on_bfsButton_clicked()
 {
-    // Use selected team from dfsBfsStartCombo, map to stadium name
-    QString teamName;
-    if (ui->dfsBfsStartCombo && ui->dfsBfsStartCombo->currentText().trimmed().size() > 0) {
-        teamName = ui->dfsBfsStartCombo->currentText().trimmed();
-    } else {
-        teamName = "Minnesota Twins";
-    }
-    StadiumInfo info;
-    QString startStadium;
-    if (stadiumMap.get(teamName, info)) {
-        startStadium = info.stadiumName.trimmed();
+    // Use selected team from dfsBfsStartCombo, resolved through the registry
+    int teamId = StadiumRegistry::InvalidId;
+    if (ui->dfsBfsStartCombo && ui->dfsBfsStartCombo->currentIndex() >= 0) {
+        teamId = ui->dfsBfsStartCombo->currentData().toInt();
     } else {
-        startStadium = teamName;
-    }
-    QString normalizedStart = StadiumGraph::normalizeStadiumName(startStadium);
-    qDebug() << "All stadiums in graph:" << stadiumGraph->getStadiums();
-    qDebug() << "Trying to start BFS at normalized stadium:" << normalizedStart;
-    if (!stadiumGraph->getStadiums().contains(normalizedStart)) {
-        QMessageBox::warning(this, "Error", teamName + " not found in the graph (normalized: " + normalizedStart + ").");
+        teamId = registry.teamId("Minnesota Twins");
+    }
+    int stadiumId = registry.stadiumForTeam(teamId);
+    int startNode = registry.nodeForStadium(stadiumId);
+    QString startStadium = registry.stadiumName(stadiumId);
+    if (startNode == StadiumRegistry::InvalidId) {
+        QString teamName = registry.teamName(teamId);
+        QMessageBox::warning(this, "Error", (teamName.isEmpty() ? QString("Selected team") : teamName)
+                             + " not found in the graph.");
         return;
     }
+    QString normalizedStart = registry.nodeName(startNode);
+    qDebug() << "Trying to start BFS at node" << startNode << normalizedStart;
     QVector<QString> path;
-    double distance = stadiumGraph->bfs(normalizedStart, path);
+    double distance = stadiumGraph->snapshot()->bfs(normalizedStart, path);
     if (distance < 0 || path.isEmpty()) {
         QMessageBox::warning(this, "Trip Error", "No path found from " + startStadium + ".");
         ui->tripSummaryText->setText("No path found from " + startStadium + ".");
         ui->totalDistanceLabel->setText("Total Distance: 0 miles");
         return;
     }
-    if (path.size() < stadiumGraph->getStadiums().size()) {
+    if (path.size() < registry.nodeCount()) {
         QMessageBox::warning(this, "Trip Warning", "Not all stadiums are reachable from " + startStadium + ".");
     }
     QString summary = "BFS Traversal (" + startStadium + "):\n";
@@ -236,22 +244,24 @@ void TripPlanner::on_filterLeagueCombo_currentIndexChanged(const QString &league
 }
 
 void TripPlanner::updateTripInfo() {
-    // TODO: Implement trip info updates
+    updateTotalDistance();
 }
 
 void TripPlanner::on_addStopButton_clicked() {
-    QList<QListWidgetItem*> selected = ui->availableStadiumsList->selectedItems();
-    if (selected.size() > 0) {
-        QString stadium = selected.first()->text();
+    QModelIndex selected = ui->availableStadiumsList->currentIndex();
+    if (selected.isValid()) {
+        int teamId = selected.data(TeamListModel::TeamIdRole).toInt();
         // Don't add duplicate stadiums
         bool exists = false;
         for (int i = 0; i < ui->tripStadiumsList->count(); ++i) {
-            if (ui->tripStadiumsList->item(i)->text() == stadium) {
+            if (ui->tripStadiumsList->item(i)->data(Qt::UserRole).toInt() == teamId) {
                 exists = true; break;
             }
         }
         if (!exists) {
-            ui->tripStadiumsList->addItem(stadium);
+            ui->tripStadiumsList->addItem(makeTeamItem(teamId));
+            currentTrip.addStop(registry.stadiumName(registry.stadiumForTeam(teamId)));
+            updateTotalDistance();
         }
         updateSouvenirTableForSelectedStadium();
     }
@@ -260,36 +270,22 @@ void TripPlanner::on_addStopButton_clicked() {
 void TripPlanner::on_removeStopButton_clicked() {
     QList<QListWidgetItem*> selected = ui->tripStadiumsList->selectedItems();
     for (QListWidgetItem* item : selected) {
-        delete ui->tripStadiumsList->takeItem(ui->tripStadiumsList->row(item));
+        int row = ui->tripStadiumsList->row(item);
+        currentTrip.removeStop(row);
+        delete ui->tripStadiumsList->takeItem(row);
     }
+    updateTotalDistance();
 }
 
 void TripPlanner::on_addSouvenirButton_clicked() {
-    // Store souvenirs for the current stadium, merging with existing
-    QString stadium;
-    if (ui->tripStadiumsList->selectedItems().size() > 0)
-        stadium = ui->tripStadiumsList->selectedItems().first()->text();
-    else if (ui->tripStadiumsList->count() > 0)
-        stadium = ui->tripStadiumsList->item(0)->text();
-    else
-        stadium = "";
-    if (stadium.isEmpty()) return;
-    QMap<QString, int> merged;
-    // Start with existing purchases
-    for (const auto& pair : souvenirCart[stadium]) {
-        merged[pair.first] += pair.second;
-    }
-    // Add new purchases
+    // Add the entered quantities for the current stadium to the cart
+    int teamId = selectedTripTeamId();
+    if (teamId == StadiumRegistry::InvalidId) return;
     for (int i = 0; i < ui->souvenirTable->rowCount(); ++i) {
-        QString name = ui->souvenirTable->item(i, 0)->text();
+        int itemId = ui->souvenirTable->item(i, 0)->data(Qt::UserRole).toInt();
         int qty = ui->souvenirTable->item(i, 2)->text().toInt();
-        if (qty > 0) merged[name] += qty;
+        if (qty > 0) souvenirCart.addQuantity(teamId, itemId, qty);
     }
-    QVector<QPair<QString, int>> mergedList;
-    for (auto it = merged.begin(); it != merged.end(); ++it) {
-        if (it.value() > 0) mergedList.append(qMakePair(it.key(), it.value()));
-    }
-    souvenirCart[stadium] = mergedList;
     updateOverallSouvenirSummary();
     QMessageBox::information(this, "Success", "Souvenir(s) added successfully!");
 }
@@ -313,31 +309,22 @@ void TripPlanner::on_greedyButton_clicked() {
 }
 
 void TripPlanner::updateSouvenirTableForSelectedStadium() {
-    // Use the selected stadium in tripStadiumsList
-    QString selectedTeam;
-    if (ui->tripStadiumsList->selectedItems().size() > 0)
-        selectedTeam = ui->tripStadiumsList->selectedItems().first()->text();
-    else if (ui->tripStadiumsList->count() > 0)
-        selectedTeam = ui->tripStadiumsList->item(0)->text();
-    else
-        selectedTeam = "";
-    StadiumInfo info;
-    if (!selectedTeam.isEmpty() && stadiumMap.get(selectedTeam, info)) {
-        ui->souvenirTable->setRowCount(info.souvenirs.size());
-        for (int i = 0; i < info.souvenirs.size(); ++i) {
-            const auto& souvenir = info.souvenirs[i];
-            QTableWidgetItem* nameItem = new QTableWidgetItem(souvenir.first);
-            nameItem->setFlags(nameItem->flags() & ~Qt::ItemIsEditable);
-            ui->souvenirTable->setItem(i, 0, nameItem);
-            QTableWidgetItem* priceItem = new QTableWidgetItem(QString::number(souvenir.second, 'f', 2));
-            priceItem->setFlags(priceItem->flags() & ~Qt::ItemIsEditable);
-            ui->souvenirTable->setItem(i, 1, priceItem);
-            QTableWidgetItem* qtyItem = new QTableWidgetItem("0");
-            qtyItem->setFlags(qtyItem->flags() | Qt::ItemIsEditable);
-            ui->souvenirTable->setItem(i, 2, qtyItem);
-        }
-    } else {
-        ui->souvenirTable->setRowCount(0);
+    // Use the selected stadium in tripStadiumsList; prices come from the cart's index
+    int teamId = selectedTripTeamId();
+    const QVector<int>& items = souvenirCart.itemsForTeam(teamId);
+    ui->souvenirTable->setRowCount(items.size());
+    for (int i = 0; i < items.size(); ++i) {
+        QTableWidgetItem* nameItem = new QTableWidgetItem(souvenirCart.itemName(items[i]));
+        nameItem->setData(Qt::UserRole, items[i]);
+        nameItem->setFlags(nameItem->flags() & ~Qt::ItemIsEditable);
+        ui->souvenirTable->setItem(i, 0, nameItem);
+        QTableWidgetItem* priceItem = new QTableWidgetItem(
+            SouvenirCart::formatCents(souvenirCart.priceCents(teamId, items[i])));
+        priceItem->setFlags(priceItem->flags() & ~Qt::ItemIsEditable);
+        ui->souvenirTable->setItem(i, 1, priceItem);
+        QTableWidgetItem* qtyItem = new QTableWidgetItem("0");
+        qtyItem->setFlags(qtyItem->flags() | Qt::ItemIsEditable);
+        ui->souvenirTable->setItem(i, 2, qtyItem);
     }
 }
 
@@ -361,62 +348,98 @@ void TripPlanner::on_bfsTargetButton_clicked() {
 }
 
 void TripPlanner::refreshStadiumLists() {
-    ui->startingStadiumCombo->clear();
-    ui->availableStadiumsList->clear();
-    if (ui->dfsBfsStartCombo) ui->dfsBfsStartCombo->clear();
+    // All pickers share the lazily populated team model; Qt::UserRole holds
+    // the registry team ID and labels are display only
+    ui->availableStadiumsList->setModel(teamModel);
+    ui->startingStadiumCombo->setModel(teamModel);
+    if (ui->dfsBfsStartCombo) ui->dfsBfsStartCombo->setModel(teamModel);
+}
 
-    QVector<QPair<QString, StadiumInfo>> entries = stadiumMap.getAllEntries();
-    QVector<QString> teamNames;
-    for (const auto& entry : entries) {
-        teamNames.append(entry.first);
-    }
-    std::sort(teamNames.begin(), teamNames.end());
-    for (const QString& team : teamNames) {
-        ui->availableStadiumsList->addItem(team);
-        ui->startingStadiumCombo->addItem(team);
-        if (ui->dfsBfsStartCombo) ui->dfsBfsStartCombo->addItem(team);
+void TripPlanner::selectAvailableTeam(int teamId) {
+    int row = teamModel->rowForTeam(teamId);
+    if (row >= 0) {
+        QModelIndex index = teamModel->index(row);
+        ui->availableStadiumsList->setCurrentIndex(index);
+        ui->availableStadiumsList->scrollTo(index);
     }
 }
 
 void TripPlanner::on_startingStadiumCombo_currentIndexChanged(const QString &stadium) {
     // Overwrite the first entry, keep the rest, no duplicates
-    QList<QString> tripStadiums;
-    if (!stadium.isEmpty()) tripStadiums.append(stadium);
-    for (int i = 1; i < ui->tripStadiumsList->count(); ++i) {
-        QString s = ui->tripStadiumsList->item(i)->text();
-        if (s != stadium) tripStadiums.append(s);
-    }
-    ui->tripStadiumsList->clear();
-    for (const QString& s : tripStadiums) ui->tripStadiumsList->addItem(s);
+    int startTeamId = StadiumRegistry::InvalidId;
+    if (!stadium.isEmpty() && ui->startingStadiumCombo->currentIndex() >= 0) {
+        startTeamId = ui->startingStadiumCombo->currentData().toInt();
+    }
+    // Edit the trip in place so only the legs touching the changed stops are recomputed
+    for (int i = ui->tripStadiumsList->count() - 1; i >= 1; --i) {
+        if (ui->tripStadiumsList->item(i)->data(Qt::UserRole).toInt() == startTeamId) {
+            currentTrip.removeStop(i);
+            delete ui->tripStadiumsList->takeItem(i);
+        }
+    }
+    if (ui->tripStadiumsList->count() > 0) {
+        currentTrip.removeStop(0);
+        delete ui->tripStadiumsList->takeItem(0);
+    }
+    if (startTeamId != StadiumRegistry::InvalidId) {
+        ui->tripStadiumsList->insertItem(0, makeTeamItem(startTeamId));
+        currentTrip.insertStop(0, registry.stadiumName(registry.stadiumForTeam(startTeamId)));
+    }
+    updateTotalDistance();
     updateSouvenirTableForSelectedStadium();
 }
 
+void TripPlanner::updateTotalDistance() {
+    // Totals are maintained by Trip as stops change; this only formats them
+    QString text = QString("Total Distance: %1 miles").arg(currentTrip.totalDistance(), 0, 'f', 2);
+    if (currentTrip.unreachableLegCount() > 0) {
+        text += QString(" (%1 leg(s) unreachable)").arg(currentTrip.unreachableLegCount());
+    }
+    ui->totalDistanceLabel->setText(text);
+}
+
+int TripPlanner::selectedTripTeamId() const {
+    if (ui->tripStadiumsList->selectedItems().size() > 0)
+        return ui->tripStadiumsList->selectedItems().first()->data(Qt::UserRole).toInt();
+    if (ui->tripStadiumsList->count() > 0)
+        return ui->tripStadiumsList->item(0)->data(Qt::UserRole).toInt();
+    return StadiumRegistry::InvalidId;
+}
+
+QListWidgetItem* TripPlanner::makeTeamItem(int teamId) const {
+    QListWidgetItem* item = new QListWidgetItem(registry.teamName(teamId));
+    item->setData(Qt::UserRole, teamId);
+    return item;
+}
+
 void TripPlanner::updateOverallSouvenirSummary() {
-    double totalCost = 0.0;
+    // Group cart lines by team for display; the total itself is maintained by the cart
+    QVector<int> lines(souvenirCart.lineCount());
+    for (int i = 0; i < lines.size(); ++i) lines[i] = i;
+    std::sort(lines.begin(), lines.end(), [this](int a, int b) {
+        int teamA = souvenirCart.lineTeam(a), teamB = souvenirCart.lineTeam(b);
+        if (teamA != teamB) return registry.teamName(teamA) < registry.teamName(teamB);
+        return souvenirCart.itemName(souvenirCart.lineItem(a)) < souvenirCart.itemName(souvenirCart.lineItem(b));
+    });
     QString summary;
-    for (auto it = souvenirCart.begin(); it != souvenirCart.end(); ++it) {
-        const QString& stadium = it.key();
-        const QVector<QPair<QString, int>>& items = it.value();
-        if (!items.isEmpty()) {
-            summary += stadium + ": ";
-            QStringList itemList;
-            StadiumInfo info;
-            stadiumMap.get(stadium, info);
-            for (const auto& pair : items) {
-                double price = 0.0;
-                for (const auto& souvenir : info.souvenirs) {
-                    if (souvenir.first == pair.first) price = souvenir.second;
-                }
-                double cost = price * pair.second;
-                totalCost += cost;
-                itemList << QString("%1 x%2 ($%3)").arg(pair.first).arg(pair.second).arg(cost, 0, 'f', 2);
-            }
-            summary += itemList.join(", ") + "\n";
+    QStringList itemList;
+    int currentTeam = StadiumRegistry::InvalidId;
+    for (int line : lines) {
+        int teamId = souvenirCart.lineTeam(line);
+        if (teamId != currentTeam) {
+            if (!itemList.isEmpty()) summary += itemList.join(", ") + "\n";
+            itemList.clear();
+            summary += registry.teamName(teamId) + ": ";
+            currentTeam = teamId;
         }
+        itemList << QString("%1 x%2 ($%3)").arg(souvenirCart.itemName(souvenirCart.lineItem(line)))
+                    .arg(souvenirCart.lineQuantity(line))
+                    .arg(SouvenirCart::formatCents(souvenirCart.lineTotalCents(line)));
     }
+    if (!itemList.isEmpty()) summary += itemList.join(", ") + "\n";
     if (summary.isEmpty()) summary = "No souvenirs selected.";
     ui->souvenirSummaryLabel->setText("Souvenir Summary: " + summary.trimmed());
-    ui->totalCostLabel->setText(QString("Total Cost: $%1").arg(totalCost, 0, 'f', 2));
+    ui->totalCostLabel->setText("Total Cost: $" + SouvenirCart::formatCents(souvenirCart.totalCents()));
 }
 
 void TripPlanner::updateAlgorithmUIVisibility() {
@@ -9,6 +9,11 @@
 #include "trip.h"
 #include "hashmap.h"
 #include "stadiumgraph.h"
+#include "stadiumregistry.h"
+#include "souvenircart.h"
+#include "teamlistmodel.h"
+#include "teamsearchindex.h"
+#include "asynctasks.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class TripPlanner; }
@@ -19,7 +24,9 @@ class TripPlanner : public QDialog
     Q_OBJECT
 
 public:
-    explicit TripPlanner(const HashMap<QString, StadiumInfo>& stadiumMap, StadiumGraph* stadiumGraph, QWidget *parent = nullptr);
+    explicit TripPlanner(const HashMap<QString, StadiumInfo>& stadiumMap, StadiumGraph* stadiumGraph,
+                         const StadiumRegistry& registry, TeamListModel* teamModel,
+                         const TeamSearchIndex& searchIndex, QWidget *parent = nullptr);
     ~TripPlanner();
     void refreshStadiumLists();
 
@@ -47,18 +54,25 @@ private slots:
     void on_startingStadiumCombo_currentIndexChanged(const QString &stadium);
     void on_planTripButton_clicked();
     void updateAlgorithmUIVisibility();
+    void selectAvailableTeam(int teamId);
 
 private:
     Ui::TripPlanner *ui;
     Trip currentTrip;
     const HashMap<QString, StadiumInfo>& stadiumMap;
     StadiumGraph* stadiumGraph;
-    QMap<QString, QVector<QPair<QString, int>>> souvenirCart; // stadium -> (souvenir, qty)
+    const StadiumRegistry& registry;
+    TeamListModel* teamModel;
+    SouvenirCart souvenirCart;
+    CancellationToken routeToken;  // cancels the pending shortest path query
     void setupUi();
+    void showShortestPath(const QVector<QString>& path, double distance);
     void updateStopList();
     void updateTotalCost();
     void updateTotalDistance();
     void updateOverallSouvenirSummary();
+    int selectedTripTeamId() const;
+    QListWidgetItem* makeTeamItem(int teamId) const;
 };
 
 #endif // TRIPPLANNER_H 
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "writebehindqueue.h"
+#include <QThread>
+#include <QMutexLocker>
+#include <QDebug>
+
+WriteBehindQueue::WriteBehindQueue(Writer writer, int maxDelayMs, int maxBatch, Reporter reporter)
+    : writer(std::move(writer))
+    , reporter(std::move(reporter))
+    , maxDelayMs(qMax(0, maxDelayMs))
+    , maxBatch(qMax(1, maxBatch))
+{
+    clock.start();
+    thread = QThread::create([this]() { run(); });
+    thread->start();
+}
+
+WriteBehindQueue::~WriteBehindQueue()
+{
+    {
+        QMutexLocker locker(&mutex);
+        stopping = true;
+        wake.wakeAll();
+    }
+    thread->wait();
+    delete thread;
+}
+
+void WriteBehindQueue::enqueue(const QVector<JournalRecord> &group)
+{
+    if (group.isEmpty()) {
+        return;
+    }
+    QMutexLocker locker(&mutex);
+    Group entry;
+    entry.records = group;
+    entry.enqueuedAt = clock.elapsed();
+    pending.append(entry);
+    pendingCount += group.size();
+    ++enqueued;
+    wake.wakeAll();
+}
+
+bool WriteBehindQueue::flush()
+{
+    QMutexLocker locker(&mutex);
+    if (QThread::currentThread() != thread) {
+        const quint64 target = enqueued;
+        ++flushWaiters;
+        wake.wakeAll();
+        while (written < target) {
+            drained.wait(&mutex);
+        }
+        --flushWaiters;
+    }
+    return failures == 0;
+}
+
+int WriteBehindQueue::pendingRecords() const
+{
+    QMutexLocker locker(&mutex);
+    return pendingCount;
+}
+
+int WriteBehindQueue::failedGroups() const
+{
+    QMutexLocker locker(&mutex);
+    return failures;
+}
+
+void WriteBehindQueue::run()
+{
+    QMutexLocker locker(&mutex);
+    for (;;) {
+        while (pending.isEmpty() && !stopping) {
+            wake.wait(&mutex);
+        }
+        if (pending.isEmpty()) {
+            return;
+        }
+
+        // Let a burst of edits share one transaction, but commit no later
+        // than maxDelayMs after the oldest one
+        while (!stopping && flushWaiters == 0 && pendingCount < maxBatch) {
+            const qint64 left = pending.first().enqueuedAt + maxDelayMs - clock.elapsed();
+            if (left <= 0) {
+                break;
+            }
+            wake.wait(&mutex, static_cast<unsigned long>(left));
+        }
+
+        QVector<Group> batch;
+        int records = 0;
+        while (!pending.isEmpty()
+               && (batch.isEmpty() || records + pending.first().records.size() <= maxBatch)) {
+            records += pending.first().records.size();
+            batch.append(pending.takeFirst());
+        }
+        pendingCount -= records;
+
+        locker.unlock();
+        const int failed = commit(batch);
+        locker.relock();
+
+        failures += failed;
+        written += batch.size();
+        drained.wakeAll();
+    }
+}
+
+int WriteBehindQueue::commit(const QVector<Group> &groups) const
+{
+    QVector<JournalRecord> records;
+    for (const Group &group : groups) {
+        records += group.records;
+    }
+    auto report = [this](const Group &group, bool ok) {
+        if (!ok) {
+            qDebug() << "Write-behind group of" << group.records.size() << "record(s) failed";
+        }
+        if (reporter) {
+            reporter(group.records, ok);
+        }
+    };
+    if (writer(records)) {
+        for (const Group &group : groups) {
+            report(group, true);
+        }
+        return 0;
+    }
+    if (groups.size() == 1) {
+        report(groups.first(), false);
+        return 1;
+    }
+
+    int failed = 0;
+    for (const Group &group : groups) {
+        const bool ok = writer(group.records);
+        report(group, ok);
+        if (!ok) {
+            ++failed;
+        }
+    }
+    return failed;
+}
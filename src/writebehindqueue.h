@@ -0,0 +1,73 @@
+#ifndef WRITEBEHINDQUEUE_H
+#define WRITEBEHINDQUEUE_H
+
+#include <QVector>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <functional>
+#include "changejournal.h"
+
+class QThread;
+
+// Commits edits to SQLite on a writer thread in grouped transactions.
+//
+// The caller applies each edit to its in-memory state first and enqueues it
+// here. The writer waits until maxDelayMs after the oldest pending edit, or
+// until maxBatch records are pending, so a burst of edits shares one
+// transaction. A group is never split across transactions. If a batch of
+// several groups fails, each group is retried on its own so one bad edit
+// does not drop the others.
+class WriteBehindQueue {
+public:
+    // Runs on the writer thread; commits the records in one transaction and
+    // returns false on failure
+    typedef std::function<bool(const QVector<JournalRecord>&)> Writer;
+    // Runs on the writer thread once per group, in enqueue order, with
+    // whether the group was committed
+    typedef std::function<void(const QVector<JournalRecord>&, bool)> Reporter;
+
+    explicit WriteBehindQueue(Writer writer, int maxDelayMs = 50, int maxBatch = 256,
+                              Reporter reporter = Reporter());
+    // Commits everything still queued, then stops the writer thread
+    ~WriteBehindQueue();
+
+    void enqueue(const QVector<JournalRecord> &group);
+
+    // Blocks until every group enqueued before the call has been written.
+    // Returns false if any group has failed since the queue started. Returns
+    // at once on the writer thread.
+    bool flush();
+
+    int pendingRecords() const;
+    int failedGroups() const;
+
+private:
+    struct Group {
+        QVector<JournalRecord> records;
+        qint64 enqueuedAt = 0;
+    };
+
+    void run();
+    int commit(const QVector<Group> &groups) const;
+
+    Writer writer;
+    Reporter reporter;
+    int maxDelayMs;
+    int maxBatch;
+
+    mutable QMutex mutex;
+    QWaitCondition wake;     // writer: new edits, a flush request or stop
+    QWaitCondition drained;  // flush(): a batch was written
+    QVector<Group> pending;
+    int pendingCount = 0;    // records in pending
+    quint64 enqueued = 0;    // groups ever enqueued
+    quint64 written = 0;     // groups committed or failed
+    int flushWaiters = 0;
+    int failures = 0;
+    bool stopping = false;
+    QElapsedTimer clock;
+    QThread *thread = nullptr;
+};
+
+#endif // WRITEBEHINDQUEUE_H
@@ -0,0 +1,10 @@
+QT += testlib
+QT -= gui
+
+TARGET = tst_compressedgraph
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+include(../../src/core.pri)
+
+SOURCES += tst_compressedgraph.cpp
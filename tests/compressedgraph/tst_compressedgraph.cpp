@@ -0,0 +1,107 @@
+#include <QtTest>
+#include <QMap>
+#include "compressedgraph.h"
+
+namespace {
+
+typedef QMap<int, QVector<QPair<int, double>>> SparseRows;
+
+// CSR rows for nodes 0 .. nodeCount - 1, empty where rows has no entry
+void buildRows(int nodeCount, const SparseRows& rows, QVector<int>& rowStart, QVector<int>& targets,
+               QVector<double>& weights)
+{
+    rowStart.reserve(nodeCount + 1);
+    for (int u = 0; u < nodeCount; ++u) {
+        rowStart.append(targets.size());
+        for (const auto& edge : rows.value(u)) {
+            targets.append(edge.first);
+            weights.append(edge.second);
+        }
+    }
+    rowStart.append(targets.size());
+}
+
+// (target, tenths of a mile) in decode order
+QVector<QPair<int, int>> decodeRow(const CompressedGraph& graph, int u)
+{
+    QVector<QPair<int, int>> edges;
+    graph.forEachEdge(u, [&edges](int v, float weight) {
+        edges.append(qMakePair(v, qRound(weight * 10.0f)));
+    });
+    return edges;
+}
+
+} // namespace
+
+class CompressedGraphTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void scalarAndSimdDecodeMatchInput();
+    void dropsSelfLoopsAndNonPositiveWeights();
+};
+
+void CompressedGraphTest::scalarAndSimdDecodeMatchInput()
+{
+    // Past 2^23 nodes a first target can sit 2^24 away in zigzag form, the
+    // only way to get a 4-byte target value; later deltas reach 3 bytes.
+    // Weights cover 1 to 4 bytes in tenths.
+    const int nodeCount = (1 << 23) + 2;
+    const int last = nodeCount - 1;
+    SparseRows rows;
+    rows[0] = {{1, 0.1}, {300, 30.0}, {70000, 100000.0}};            // 1, 2, 3-byte deltas
+    rows[5] = {{6, 2000000.0}};                                        // 4-byte weight
+    rows[6] = {{2, 1.0}, {3, 2.5}, {4, 40.0}, {5, 7000.0}};            // one full group
+    rows[7] = {{0, 12.3}, {1, 4.5}, {2, 6.7}, {3, 8.9}, {4, 0.2}};     // full group, then one
+    rows[last] = {{0, 250.0}, {1, 0.5}, {65536, 1.5}, {last - 1, 3.0}};  // 4-byte first target
+    QVector<QPair<int, double>> wide;
+    for (int i = 1; i <= 2 * CompressedGraph::BlockEdges + 3; ++i) {
+        wide.append(qMakePair(40000 + i * i, 0.1 * (i * 37 % 5000 + 1)));
+    }
+    rows[40000] = wide;  // three blocks, the last ending in a partial group
+
+    QVector<int> rowStart;
+    QVector<int> targets;
+    QVector<double> weights;
+    buildRows(nodeCount, rows, rowStart, targets, weights);
+    CompressedGraph graph;
+    QVERIFY(graph.build(rowStart, targets, weights));
+    QCOMPARE(graph.size(), nodeCount);
+    QCOMPARE(graph.edgeCount(), qint64(targets.size()));
+
+    for (bool simd : {false, true}) {
+        graph.setSimdEnabled(simd);
+        for (auto it = rows.constBegin(); it != rows.constEnd(); ++it) {
+            QVector<QPair<int, int>> expected;
+            for (const auto& edge : it.value()) {
+                expected.append(qMakePair(edge.first, qRound(edge.second * 10.0)));
+            }
+            QCOMPARE(graph.degree(it.key()), expected.size());
+            QCOMPARE(decodeRow(graph, it.key()), expected);
+        }
+        QVERIFY(decodeRow(graph, 1).isEmpty());
+        QVERIFY(decodeRow(graph, last - 1).isEmpty());
+    }
+}
+
+void CompressedGraphTest::dropsSelfLoopsAndNonPositiveWeights()
+{
+    SparseRows rows;
+    rows[0] = {{0, 5.0}, {1, 10.0}, {2, 0.0}, {3, -4.0}, {4, 0.01}};
+    QVector<int> rowStart;
+    QVector<int> targets;
+    QVector<double> weights;
+    buildRows(5, rows, rowStart, targets, weights);
+
+    CompressedGraph graph;
+    QVERIFY(graph.build(rowStart, targets, weights));
+    QCOMPARE(graph.edgeCount(), qint64(2));
+    // Weights round to tenths, never below one tenth
+    const QVector<QPair<int, int>> expected = {{1, 100}, {4, 1}};
+    QCOMPARE(decodeRow(graph, 0), expected);
+}
+
+QTEST_GUILESS_MAIN(CompressedGraphTest)
+
+#include "tst_compressedgraph.moc"
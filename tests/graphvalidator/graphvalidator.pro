@@ -0,0 +1,10 @@
+QT += testlib
+QT -= gui
+
+TARGET = tst_graphvalidator
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+include(../../src/core.pri)
+
+SOURCES += tst_graphvalidator.cpp
@@ -0,0 +1,206 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QTextStream>
+#include <algorithm>
+#include "graphvalidator.h"
+#include "stadiumgraph.h"
+
+namespace {
+
+struct Edge {
+    int from;
+    int to;
+    double weight;
+};
+
+// CSR rows for the directed edges, each row sorted by target; equal
+// targets keep their listed order
+struct Csr {
+    QVector<int> rowStart;
+    QVector<int> targets;
+    QVector<double> weights;
+};
+
+Csr buildCsr(int nodeCount, QVector<Edge> edges)
+{
+    std::stable_sort(edges.begin(), edges.end(), [](const Edge &a, const Edge &b) {
+        return a.from != b.from ? a.from < b.from : a.to < b.to;
+    });
+    Csr csr;
+    csr.rowStart.fill(0, nodeCount + 1);
+    for (const Edge &edge : edges) {
+        ++csr.rowStart[edge.from + 1];
+        csr.targets.append(edge.to);
+        csr.weights.append(edge.weight);
+    }
+    for (int u = 0; u < nodeCount; ++u) {
+        csr.rowStart[u + 1] += csr.rowStart[u];
+    }
+    return csr;
+}
+
+GraphValidationReport validate(const Csr &csr, const QVector<bool> &known = QVector<bool>(),
+                               int maxIssues = 1000)
+{
+    return GraphValidator::validate(csr.rowStart, csr.targets, csr.weights,
+                                    [](int u) { return QString("S%1").arg(u); }, known, maxIssues);
+}
+
+// One of each edge issue on four connected nodes
+Csr edgeIssueGraph()
+{
+    return buildCsr(4, {
+        {0, 1, 5.0}, {1, 0, 5.0},
+        {0, 2, 3.0}, {2, 0, 4.0},  // asymmetric
+        {1, 2, 6.0},               // no reverse
+        {2, 3, 2.0}, {2, 3, 7.0}, {3, 2, 2.0},  // listed twice
+        {3, 3, 1.0},               // self loop
+        {0, 3, 0.0}, {3, 0, 0.0}   // non-positive
+    });
+}
+
+bool writeFile(const QString &path, const QString &contents)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        return false;
+    }
+    QTextStream(&file) << contents;
+    return true;
+}
+
+} // namespace
+
+class GraphValidatorTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanGraphIsValid();
+    void edgeIssues();
+    void nodeIssues();
+    void issuesAreCapped();
+    void loaderReportsMergeConflicts();
+};
+
+void GraphValidatorTest::cleanGraphIsValid()
+{
+    GraphValidationReport report = validate(buildCsr(3, {
+        {0, 1, 1.0}, {1, 0, 1.0},
+        {1, 2, 2.0}, {2, 1, 2.0},
+        {0, 2, 3.0}, {2, 0, 3.0}
+    }), {true, true, true});
+    QVERIFY(report.isValid());
+    QCOMPARE(report.nodes, 3);
+    QCOMPARE(report.edges, 6);
+    QCOMPARE(report.components, 1);
+    QCOMPARE(report.largestComponent, 3);
+    QVERIFY(report.issues.isEmpty());
+}
+
+void GraphValidatorTest::edgeIssues()
+{
+    GraphValidationReport report = validate(edgeIssueGraph());
+    QVERIFY(!report.isValid());
+    QCOMPARE(report.count(GraphIssue::AsymmetricWeight), 1);
+    QCOMPARE(report.count(GraphIssue::MissingReverse), 1);
+    QCOMPARE(report.count(GraphIssue::ConflictingDuplicate), 1);
+    QCOMPARE(report.count(GraphIssue::SelfLoop), 1);
+    QCOMPARE(report.count(GraphIssue::NonPositiveWeight), 1);
+    QCOMPARE(report.count(GraphIssue::OrphanNode), 0);
+    QCOMPARE(report.count(GraphIssue::Disconnected), 0);
+    QCOMPARE(report.components, 1);
+    QCOMPARE(report.issues.size(), 5);
+
+    for (const GraphIssue &issue : report.issues) {
+        if (issue.kind == GraphIssue::AsymmetricWeight) {
+            QCOMPARE(issue.from, QString("S0"));
+            QCOMPARE(issue.to, QString("S2"));
+            QCOMPARE(issue.weight, 3.0);
+            QCOMPARE(issue.otherWeight, 4.0);
+        } else if (issue.kind == GraphIssue::ConflictingDuplicate) {
+            QCOMPARE(issue.from, QString("S2"));
+            QCOMPARE(issue.to, QString("S3"));
+            QCOMPARE(issue.weight, 2.0);
+            QCOMPARE(issue.otherWeight, 7.0);
+        } else if (issue.kind == GraphIssue::MissingReverse) {
+            QCOMPARE(issue.from, QString("S1"));
+            QCOMPARE(issue.to, QString("S2"));
+        }
+    }
+}
+
+void GraphValidatorTest::nodeIssues()
+{
+    // A path 0-1-2, a separate pair 3-4 and an orphan 5; S4 is unknown
+    GraphValidationReport report = validate(buildCsr(6, {
+        {0, 1, 1.0}, {1, 0, 1.0},
+        {1, 2, 1.0}, {2, 1, 1.0},
+        {3, 4, 1.0}, {4, 3, 1.0}
+    }), {true, true, true, true, false, true});
+    QCOMPARE(report.count(GraphIssue::OrphanNode), 1);
+    QCOMPARE(report.count(GraphIssue::UnknownName), 1);
+    // The orphan is not counted again as disconnected
+    QCOMPARE(report.count(GraphIssue::Disconnected), 2);
+    QCOMPARE(report.components, 3);
+    QCOMPARE(report.largestComponent, 3);
+
+    QStringList disconnected;
+    for (const GraphIssue &issue : report.issues) {
+        if (issue.kind == GraphIssue::OrphanNode) {
+            QCOMPARE(issue.from, QString("S5"));
+        } else if (issue.kind == GraphIssue::UnknownName) {
+            QCOMPARE(issue.from, QString("S4"));
+        } else if (issue.kind == GraphIssue::Disconnected) {
+            disconnected << issue.from;
+        }
+    }
+    QCOMPARE(disconnected, QStringList({"S3", "S4"}));
+}
+
+void GraphValidatorTest::issuesAreCapped()
+{
+    GraphValidationReport report = validate(edgeIssueGraph(), QVector<bool>(), 2);
+    QCOMPARE(report.issues.size(), 2);
+    QVERIFY(report.truncated);
+    // Counts are never capped
+    QCOMPARE(report.count(GraphIssue::SelfLoop), 1);
+    QCOMPARE(report.count(GraphIssue::NonPositiveWeight), 1);
+}
+
+void GraphValidatorTest::loaderReportsMergeConflicts()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString first = dir.filePath("first.csv");
+    const QString second = dir.filePath("second.csv");
+    QVERIFY(writeFile(first, "Originating Stadium,Destination Stadium,Distance\n"
+                             "Alpha Field,Beta Park,100\n"
+                             "Beta Park,Gamma Stadium,50\n"));
+    QVERIFY(writeFile(second, "Originating Stadium,Destination Stadium,Distance\n"
+                              "Beta Park,Alpha Field,120\n"
+                              "Beta Park,Gamma Stadium,50\n"));
+
+    // Refused outright under ErrorOnConflict
+    StadiumGraph strict;
+    QVERIFY(!strict.loadMultipleCSVs({first, second}, CsvMergeRule::ErrorOnConflict));
+
+    StadiumGraph graph;
+    QVERIFY(graph.loadMultipleCSVs({first, second}, CsvMergeRule::LastFileWins));
+    QCOMPARE(graph.getDistance("Alpha Field", "Beta Park"), 120.0);
+
+    // The identical Beta-Gamma row is not a conflict
+    GraphValidationReport report = graph.validate();
+    QCOMPARE(report.count(GraphIssue::ConflictingDuplicate), 1);
+    QCOMPARE(report.issues.size(), 1);
+    QCOMPARE(report.issues[0].weight, 100.0);
+    QCOMPARE(report.issues[0].otherWeight, 120.0);
+    QVERIFY(!report.isValid());
+
+    graph.clear();
+    QCOMPARE(graph.validate().count(GraphIssue::ConflictingDuplicate), 0);
+}
+
+QTEST_GUILESS_MAIN(GraphValidatorTest)
+#include "tst_graphvalidator.moc"
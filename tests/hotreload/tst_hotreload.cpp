@@ -0,0 +1,145 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QSqlQuery>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include "csvhotreloader.h"
+#include "database.h"
+
+namespace {
+
+const char *Header = "Team name,Stadium name,Seating capacity,Location,Playing surface,League,"
+                     "Date opened,Distance to center field,Ballpark typology,Roof Type";
+
+QString teamLine(const QString &teamName, int capacity)
+{
+    return QString("%1,%1 Park,%2,\"Springfield, Oregon\",Grass,National,2001,"
+                   "400 feet (122 m),Retro Modern,Open").arg(teamName).arg(capacity);
+}
+
+// Writes a team CSV and returns its canonical path, the key the reloader uses
+QString writeTeams(const QString &path, const QStringList &lines)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        return QString();
+    }
+    QTextStream out(&file);
+    out << Header << "\n";
+    for (const QString &line : lines) {
+        out << line << "\n";
+    }
+    file.close();
+    return QFileInfo(path).canonicalFilePath();
+}
+
+// Capacity in SQLite, or -1 when the team is not there
+int sqlCapacity(Database &db, const QString &teamName)
+{
+    QSqlQuery query(db.database());
+    query.prepare("SELECT capacity FROM teams WHERE team_name = :team");
+    query.bindValue(":team", teamName);
+    if (!query.exec() || !query.next()) {
+        return -1;
+    }
+    return query.value(0).toInt();
+}
+
+// Capacity in the stadium map, or -1 when the team is not there
+int mapCapacity(Database &db, const QString &teamName)
+{
+    StadiumInfo info = db.getStadiumInfo(teamName);
+    return info.teamName.isEmpty() ? -1 : info.seatingCapacity;
+}
+
+} // namespace
+
+class HotReloadTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void renameDeleteChangeAppliedOnce();
+    void droppedTeamFallsBackToOtherFile();
+};
+
+void HotReloadTest::renameDeleteChangeAppliedOnce()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = writeTeams(dir.filePath("teams.csv"), {
+        teamLine("Springfield Isotopes", 30000),
+        teamLine("Shelbyville Shelbyvillians", 25000),
+        teamLine("Capital City Capitals", 40000)
+    });
+    QVERIFY(!path.isEmpty());
+
+    Database db;
+    QVERIFY(db.initialize());
+    QVERIFY(db.importFromCSV({path}));
+    CsvHotReloader reloader(&db, nullptr);
+    QVERIFY(reloader.watchTeamFile(path));
+
+    // Rename the Isotopes, drop the Shelbyvillians, grow the Capitals
+    writeTeams(path, {
+        teamLine("Ogdenville Otters", 30000),
+        teamLine("Capital City Capitals", 45000)
+    });
+    ReloadStats stats;
+    QVERIFY(reloader.reloadNow(path, stats));
+    QCOMPARE(stats.inserted, 1);
+    QCOMPARE(stats.changed, 1);
+    QCOMPARE(stats.deleted, 2);
+
+    QCOMPARE(sqlCapacity(db, "Springfield Isotopes"), -1);
+    QCOMPARE(sqlCapacity(db, "Shelbyville Shelbyvillians"), -1);
+    QCOMPARE(sqlCapacity(db, "Ogdenville Otters"), 30000);
+    QCOMPARE(sqlCapacity(db, "Capital City Capitals"), 45000);
+    QCOMPARE(mapCapacity(db, "Springfield Isotopes"), -1);
+    QCOMPARE(mapCapacity(db, "Shelbyville Shelbyvillians"), -1);
+    QCOMPARE(mapCapacity(db, "Ogdenville Otters"), 30000);
+    QCOMPARE(mapCapacity(db, "Capital City Capitals"), 45000);
+
+    // The snapshot now matches the file, so nothing is applied twice
+    ReloadStats again;
+    QVERIFY(reloader.reloadNow(path, again));
+    QCOMPARE(again.inserted, 0);
+    QCOMPARE(again.changed, 0);
+    QCOMPARE(again.deleted, 0);
+}
+
+void HotReloadTest::droppedTeamFallsBackToOtherFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString first = writeTeams(dir.filePath("east.csv"), {
+        teamLine("Springfield Isotopes", 30000),
+        teamLine("Capital City Capitals", 40000)
+    });
+    const QString second = writeTeams(dir.filePath("west.csv"), {
+        teamLine("Capital City Capitals", 42000)
+    });
+    QVERIFY(!first.isEmpty() && !second.isEmpty());
+
+    Database db;
+    QVERIFY(db.initialize());
+    QVERIFY(db.importFromCSV({first}));
+    CsvHotReloader reloader(&db, nullptr);
+    QVERIFY(reloader.watchTeamFile(first));
+    QVERIFY(reloader.watchTeamFile(second));
+    QCOMPARE(sqlCapacity(db, "Capital City Capitals"), 40000);
+
+    // The Capitals leave the first file but the second still lists them
+    writeTeams(first, {teamLine("Springfield Isotopes", 30000)});
+    ReloadStats stats;
+    QVERIFY(reloader.reloadNow(first, stats));
+    QCOMPARE(stats.inserted, 0);
+    QCOMPARE(stats.changed, 1);
+    QCOMPARE(stats.deleted, 0);
+    QCOMPARE(sqlCapacity(db, "Capital City Capitals"), 42000);
+    QCOMPARE(mapCapacity(db, "Capital City Capitals"), 42000);
+}
+
+QTEST_GUILESS_MAIN(HotReloadTest)
+#include "tst_hotreload.moc"
@@ -0,0 +1,10 @@
+QT += testlib
+QT -= gui
+
+TARGET = tst_journal
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+include(../../src/core.pri)
+
+SOURCES += tst_journal.cpp
@@ -0,0 +1,199 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "changejournal.h"
+#include "database.h"
+#include "journalapplier.h"
+
+namespace {
+
+const char *Team = "New York Yankees";
+
+double souvenirPrice(Database &db, const QString &itemName)
+{
+    for (const auto &souvenir : db.getSouvenirs(Team)) {
+        if (souvenir.first == itemName) {
+            return souvenir.second;
+        }
+    }
+    return -1.0;
+}
+
+// Writes a journal with one souvenir add and one bulk price change
+quint64 writeJournal(const QString &path)
+{
+    ChangeJournal journal;
+    if (!journal.open(path)) {
+        return 0;
+    }
+    journal.souvenirAdded(Team, "Foam finger", 9.99);
+    SouvenirPriceUpdate update;
+    update.itemName = "Baseball cap";
+    update.teams = QStringList{Team};
+    update.percentChange = 10.0;
+    journal.souvenirPricesUpdated(update);
+    return journal.journalId();
+}
+
+} // namespace
+
+class JournalTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void replayTwiceAppliesNothing();
+    void replayAddOfExistingSouvenir();
+    void readStopsAtCorruptRecord();
+    void readStopsAtTornRecord();
+    void reopenDropsTornTail();
+};
+
+void JournalTest::replayTwiceAppliesNothing()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString journalPath = dir.filePath("kiosk1.journal");
+    const quint64 journalId = writeJournal(journalPath);
+    QVERIFY(journalId != 0);
+
+    // Two runs of the program against the same database file
+    const QString dbPath = dir.filePath("kiosk2.db");
+    {
+        Database db(dbPath);
+        QVERIFY(db.initialize());
+        JournalApplier applier(&db, nullptr);
+        JournalReplayResult result = applier.applyFile(journalPath);
+        QVERIFY(result.success);
+        QCOMPARE(result.applied, 2);
+        QCOMPARE(souvenirPrice(db, "Foam finger"), 9.99);
+        QCOMPARE(souvenirPrice(db, "Baseball cap"), 21.99);
+
+        result = applier.applyFile(journalPath);
+        QVERIFY(result.success);
+        QCOMPARE(result.applied, 0);
+        QCOMPARE(result.skipped, 2);
+    }
+    {
+        Database db(dbPath);
+        QVERIFY(db.initialize());
+        JournalApplier applier(&db, nullptr);
+        QCOMPARE(applier.lastAppliedSequence(journalId), quint64(2));
+        JournalReplayResult result = applier.applyFile(journalPath);
+        QVERIFY(result.success);
+        QCOMPARE(result.applied, 0);
+        QCOMPARE(result.skipped, 2);
+        QCOMPARE(souvenirPrice(db, "Foam finger"), 9.99);
+        QCOMPARE(souvenirPrice(db, "Baseball cap"), 21.99);
+    }
+}
+
+void JournalTest::replayAddOfExistingSouvenir()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString journalPath = dir.filePath("kiosk1.journal");
+    {
+        ChangeJournal journal;
+        QVERIFY(journal.open(journalPath));
+        journal.souvenirAdded(Team, "Baseball cap", 5.00);
+        journal.souvenirUpdated(Team, "Team pennant", 12.50);
+    }
+
+    Database db;
+    QVERIFY(db.initialize());
+    JournalApplier applier(&db, nullptr);
+    JournalReplayResult result = applier.applyFile(journalPath);
+    QVERIFY(result.success);
+    QCOMPARE(result.lastSequence, quint64(2));
+    QCOMPARE(souvenirPrice(db, "Baseball cap"), 19.99);
+    QCOMPARE(souvenirPrice(db, "Team pennant"), 12.50);
+}
+
+void JournalTest::readStopsAtCorruptRecord()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("kiosk.journal");
+    const quint64 journalId = writeJournal(path);
+
+    // Flip the last byte, part of the final record's CRC
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.seek(file.size() - 1));
+    char last = 0;
+    QVERIFY(file.getChar(&last));
+    QVERIFY(file.seek(file.size() - 1));
+    QVERIFY(file.putChar(char(last ^ 0x5a)));
+    file.close();
+
+    quint64 readId = 0;
+    QVector<JournalRecord> records;
+    bool truncated = false;
+    QVERIFY(ChangeJournal::readFile(path, readId, records, &truncated));
+    QCOMPARE(readId, journalId);
+    QVERIFY(truncated);
+    QCOMPARE(records.size(), 1);
+    QCOMPARE(records[0].sequence, quint64(1));
+    QVERIFY(records[0].type == JournalRecord::SouvenirAdd);
+    QCOMPARE(records[0].itemName, QString("Foam finger"));
+}
+
+void JournalTest::readStopsAtTornRecord()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("kiosk.journal");
+    writeJournal(path);
+    const qint64 intactBytes = QFileInfo(path).size();
+
+    // A crash mid-write: a length prefix and part of a body
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::Append));
+    QVERIFY(file.write(QByteArray::fromHex("0000004000000000")) == 8);
+    file.close();
+
+    quint64 readId = 0;
+    QVector<JournalRecord> records;
+    bool truncated = false;
+    qint64 validBytes = 0;
+    QVERIFY(ChangeJournal::readFile(path, readId, records, &truncated, &validBytes));
+    QVERIFY(truncated);
+    QCOMPARE(records.size(), 2);
+    QCOMPARE(validBytes, intactBytes);
+}
+
+void JournalTest::reopenDropsTornTail()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("kiosk.journal");
+    const quint64 journalId = writeJournal(path);
+    const qint64 intactBytes = QFileInfo(path).size();
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::Append));
+        QVERIFY(file.write(QByteArray(5, '\x7f')) == 5);
+    }
+
+    {
+        ChangeJournal journal;
+        QVERIFY(journal.open(path));
+        QCOMPARE(journal.journalId(), journalId);
+        QCOMPARE(journal.lastSequence(), quint64(2));
+        QCOMPARE(QFileInfo(path).size(), intactBytes);
+        journal.souvenirDeleted(Team, "Foam finger");
+    }
+
+    quint64 readId = 0;
+    QVector<JournalRecord> records;
+    bool truncated = true;
+    QVERIFY(ChangeJournal::readFile(path, readId, records, &truncated));
+    QVERIFY(!truncated);
+    QCOMPARE(records.size(), 3);
+    QCOMPARE(records[2].sequence, quint64(3));
+    QVERIFY(records[2].type == JournalRecord::SouvenirDelete);
+}
+
+QTEST_GUILESS_MAIN(JournalTest)
+
+#include "tst_journal.moc"
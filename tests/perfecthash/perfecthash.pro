@@ -0,0 +1,10 @@
+QT += testlib
+QT -= gui
+
+TARGET = tst_perfecthash
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+include(../../src/core.pri)
+
+SOURCES += tst_perfecthash.cpp
@@ -0,0 +1,92 @@
+#include <QtTest>
+#include "perfecthash.h"
+
+namespace {
+
+// Normalized-looking names, with a few longer than NameKey's inline
+// capacity and a few outside ASCII
+QVector<QString> makeKeys(int count)
+{
+    QVector<QString> keys;
+    keys.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        switch (i % 5) {
+        case 3:
+            keys.append(QString("ballparkwithaverylongname%1").arg(i));
+            break;
+        case 4:
+            keys.append(QString("estádio%1").arg(i));
+            break;
+        default:
+            keys.append(QString("stadium%1").arg(i * 7919));
+            break;
+        }
+    }
+    return keys;
+}
+
+} // namespace
+
+class PerfectHashTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void findsEveryKey_data();
+    void findsEveryKey();
+    void emptyTable();
+    void duplicateKeysFail();
+};
+
+void PerfectHashTest::findsEveryKey_data()
+{
+    QTest::addColumn<int>("count");
+    for (int count : {1, 2, 3, 4, 30, 1000, 50000}) {
+        QTest::addRow("%d keys", count) << count;
+    }
+}
+
+void PerfectHashTest::findsEveryKey()
+{
+    QFETCH(int, count);
+    const QVector<QString> keys = makeKeys(count);
+    MinimalPerfectHash hash;
+    QVERIFY(hash.build(keys));
+    QVERIFY(hash.isBuilt());
+    QCOMPARE(hash.size(), count);
+
+    for (int i = 0; i < count; ++i) {
+        QCOMPARE(hash.find(keys[i]), i);
+        QCOMPARE(hash.find(NameKey(keys[i])), i);
+        QCOMPARE(hash.key(i).toString(), keys[i]);
+    }
+    // Keys outside the set land in some slot and fail its verification
+    for (int i = 0; i < 2000; ++i) {
+        const QString missing = QString("missing%1").arg(i);
+        QCOMPARE(hash.find(missing), -1);
+        QCOMPARE(hash.find(NameKey(missing)), -1);
+    }
+    QCOMPARE(hash.find(QString()), -1);
+}
+
+void PerfectHashTest::emptyTable()
+{
+    MinimalPerfectHash hash;
+    QCOMPARE(hash.find(QString("stadium")), -1);
+    QVERIFY(hash.build(QVector<QString>()));
+    QVERIFY(hash.isBuilt());
+    QCOMPARE(hash.size(), 0);
+    QCOMPARE(hash.find(QString("stadium")), -1);
+}
+
+void PerfectHashTest::duplicateKeysFail()
+{
+    MinimalPerfectHash hash;
+    QVERIFY(!hash.build(QVector<QString>{"fenwaypark", "wrigleyfield", "fenwaypark"}));
+    QVERIFY(!hash.isBuilt());
+    QCOMPARE(hash.find(QString("fenwaypark")), -1);
+}
+
+QTEST_GUILESS_MAIN(PerfectHashTest)
+
+#include "tst_perfecthash.moc"
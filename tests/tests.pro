@@ -0,0 +1,9 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    compressedgraph \
+    graphvalidator \
+    hotreload \
+    journal \
+    perfecthash \
+    writebehind
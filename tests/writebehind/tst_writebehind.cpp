@@ -0,0 +1,181 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QSqlQuery>
+#include <QMutex>
+#include <QThread>
+#include "writebehindqueue.h"
+#include "changejournal.h"
+#include "database.h"
+
+namespace {
+
+const char *Team = "New York Yankees";
+
+QVector<JournalRecord> group(const QString &itemName, int records = 1)
+{
+    QVector<JournalRecord> result;
+    for (int i = 0; i < records; ++i) {
+        JournalRecord record;
+        record.type = JournalRecord::SouvenirAdd;
+        record.teamName = Team;
+        record.itemName = itemName;
+        result.append(record);
+    }
+    return result;
+}
+
+// Stands in for SQLite: a transaction commits all of its records, or none
+// of them if any is named "bad"
+struct FakeStore {
+    QMutex mutex;
+    QStringList committed;
+    QVector<int> transactionSizes;
+
+    bool write(const QVector<JournalRecord> &records)
+    {
+        QMutexLocker locker(&mutex);
+        transactionSizes.append(records.size());
+        for (const JournalRecord &record : records) {
+            if (record.itemName == "bad") {
+                return false;
+            }
+        }
+        for (const JournalRecord &record : records) {
+            committed << record.itemName;
+        }
+        return true;
+    }
+
+    QStringList committedItems()
+    {
+        QMutexLocker locker(&mutex);
+        return committed;
+    }
+};
+
+double souvenirPrice(Database &db, const QString &itemName)
+{
+    for (const auto &souvenir : db.getSouvenirs(Team)) {
+        if (souvenir.first == itemName) {
+            return souvenir.second;
+        }
+    }
+    return -1.0;
+}
+
+} // namespace
+
+class WriteBehindTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void failingGroupKeepsNeighbours();
+    void batchesNeverSplitGroups();
+    void flushBlocksUntilCommitted();
+    void failedGroupReloadsTeam();
+};
+
+void WriteBehindTest::failingGroupKeepsNeighbours()
+{
+    FakeStore store;
+    QMutex reportMutex;
+    QStringList reported;
+    {
+        // A long delay, so the three groups share the batch flush() starts
+        WriteBehindQueue queue([&store](const QVector<JournalRecord> &records) {
+            return store.write(records);
+        }, 60000, 256, [&](const QVector<JournalRecord> &records, bool committed) {
+            QMutexLocker locker(&reportMutex);
+            reported << records.first().itemName + (committed ? "+" : "-");
+        });
+        queue.enqueue(group("cap"));
+        queue.enqueue(group("bad"));
+        queue.enqueue(group("pennant"));
+        QVERIFY(!queue.flush());
+        QCOMPARE(queue.failedGroups(), 1);
+        QCOMPARE(queue.pendingRecords(), 0);
+    }
+    QCOMPARE(store.committed, QStringList({"cap", "pennant"}));
+    // The shared transaction, then each group on its own
+    QCOMPARE(store.transactionSizes, QVector<int>({3, 1, 1, 1}));
+    QCOMPARE(reported, QStringList({"cap+", "bad-", "pennant+"}));
+}
+
+void WriteBehindTest::batchesNeverSplitGroups()
+{
+    FakeStore store;
+    {
+        WriteBehindQueue queue([&store](const QVector<JournalRecord> &records) {
+            return store.write(records);
+        }, 60000, 2);
+        queue.enqueue(group("cap"));
+        queue.enqueue(group("jersey", 2));
+        queue.enqueue(group("pennant"));
+        QVERIFY(queue.flush());
+    }
+    QCOMPARE(store.transactionSizes, QVector<int>({1, 2, 1}));
+    QCOMPARE(store.committed, QStringList({"cap", "jersey", "jersey", "pennant"}));
+}
+
+void WriteBehindTest::flushBlocksUntilCommitted()
+{
+    FakeStore store;
+    WriteBehindQueue queue([&store](const QVector<JournalRecord> &records) {
+        QThread::msleep(50);  // a slow commit
+        return store.write(records);
+    }, 60000);
+    queue.enqueue(group("cap"));
+
+    // Nothing is written before the delay runs out or someone flushes
+    QThread::msleep(20);
+    QVERIFY(store.committedItems().isEmpty());
+    QCOMPARE(queue.pendingRecords(), 1);
+
+    QVERIFY(queue.flush());
+    QCOMPARE(store.committedItems(), QStringList({"cap"}));
+    QCOMPARE(queue.pendingRecords(), 0);
+}
+
+void WriteBehindTest::failedGroupReloadsTeam()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString journalPath = dir.filePath("kiosk.journal");
+    ChangeJournal journal;
+    QVERIFY(journal.open(journalPath));
+
+    Database db;
+    QVERIFY(db.initialize());
+    db.setChangeJournal(&journal);
+    db.enableWriteBehind(60000);
+
+    // A row only SQLite knows about: the queued add of the same souvenir
+    // passes the map check and then fails on the primary key
+    QSqlQuery query(db.database());
+    QVERIFY(query.exec(QString("INSERT INTO souvenirs (team_name, item_name, price) "
+                               "VALUES ('%1', 'Ghost', 3.5)").arg(Team)));
+
+    QSignalSpy failed(&db, &Database::writeFailed);
+    QVERIFY(db.addSouvenir(Team, "Foam finger", 9.99));
+    QVERIFY(db.addSouvenir(Team, "Ghost", 1.0));
+    QCOMPARE(souvenirPrice(db, "Ghost"), 1.0);
+
+    QVERIFY(!db.flushWrites());
+    QTRY_COMPARE(failed.count(), 1);
+    QCOMPARE(failed.first().first().toStringList(), QStringList({Team}));
+    // The failed edit is gone from the map, its neighbour is kept
+    QCOMPARE(souvenirPrice(db, "Ghost"), 3.5);
+    QCOMPARE(souvenirPrice(db, "Foam finger"), 9.99);
+
+    // Only the committed group reached the journal
+    QVERIFY(journal.flush());
+    quint64 journalId = 0;
+    QVector<JournalRecord> records;
+    QVERIFY(ChangeJournal::readFile(journalPath, journalId, records));
+    QCOMPARE(records.size(), 1);
+    QCOMPARE(records[0].itemName, QString("Foam finger"));
+}
+
+QTEST_GUILESS_MAIN(WriteBehindTest)
+#include "tst_writebehind.moc"
@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+"""Compile the bundled team and distance CSVs into src/defaultdata.cpp.
+
+The generated file holds constexpr tables that Database and StadiumGraph
+load at startup without opening or parsing any file. Rows are cleaned the
+same way as Database::parseTeamRow and StadiumGraph::parseDistanceRow, and
+stadium names are stored pre-normalized for the graph.
+
+Run through qmake with `make defaultdata`, or directly:
+    python3 tools/embed_defaults.py --teams "MLB Information.csv" \
+        --distances "Distance between stadiums.csv" --output src/defaultdata.cpp
+"""
+
+import argparse
+import datetime
+import os
+import re
+import sys
+
+UNKNOWN_DAY = -2147483648
+
+
+def read_lines(path):
+    with open(path, encoding="utf-8-sig", newline="") as f:
+        return f.read().splitlines()
+
+
+def split_team_line(line):
+    # Same quote handling as Database::parseTeamRow
+    fields, current, in_quotes = [], [], False
+    for ch in line:
+        if ch == '"':
+            in_quotes = not in_quotes
+        elif ch == "," and not in_quotes:
+            fields.append("".join(current).strip())
+            current = []
+        else:
+            current.append(ch)
+    fields.append("".join(current).strip())
+    return [f.replace('"', "") for f in fields]
+
+
+def feet_from_string(text):
+    match = re.search(r"\d+", text)
+    return int(match.group(0)[:6]) if match else 0
+
+
+def epoch_day(text):
+    text = text.strip()
+    try:
+        date = datetime.date.fromisoformat(text)
+    except ValueError:
+        match = re.search(r"(?<!\d)\d{4}(?!\d)", text)
+        if not match:
+            return UNKNOWN_DAY
+        date = datetime.date(int(match.group(0)), 1, 1)
+    return (date - datetime.date(1970, 1, 1)).days
+
+
+def parse_team_row(line):
+    fields = split_team_line(line)
+    if len(fields) < 10 or not fields[0].strip():
+        return None
+    capacity = int(re.sub(r"[^0-9]", "", fields[2]) or 0)
+    date_opened = fields[6].strip()
+    year = re.search(r"\b\d{4}\b", date_opened)
+    if year:
+        date_opened = year.group(0)
+    center_field = feet_from_string(fields[7].strip())
+    if center_field <= 0 or center_field > 1000:
+        center_field = 0
+    return {
+        "teamName": fields[0].strip(),
+        "stadiumName": fields[1].strip(),
+        "location": fields[3].strip(),
+        "surface": fields[4].strip() or "Unknown",
+        "league": fields[5].strip() or "Unknown",
+        "dateOpened": date_opened,
+        "typology": fields[8].strip() or "Unknown",
+        "roof": fields[9].strip() or "Unknown",
+        "capacity": max(capacity, 0),
+        "openedDay": epoch_day(date_opened),
+        "centerField": center_field,
+    }
+
+
+def normalize_stadium_name(name):
+    # Same as StadiumGraph::normalizeStadiumName
+    return re.sub(r"[^a-z0-9]", "", name.strip().lower())
+
+
+def parse_distance_row(line):
+    parts = line.strip().split(",")
+    if len(parts) < 3:
+        return None
+    source, target = normalize_stadium_name(parts[0]), normalize_stadium_name(parts[1])
+    try:
+        miles = float(parts[2].strip())
+    except ValueError:
+        return None
+    if not source or not target or miles <= 0:
+        return None
+    return source, target, miles
+
+
+def literal(text):
+    out = []
+    for ch in text:
+        if ch in '"\\':
+            out.append("\\" + ch)
+        elif 32 <= ord(ch) < 127:
+            out.append(ch)
+        else:
+            out.append("\\u%04x" % ord(ch))
+    return 'u"%s"' % "".join(out)
+
+
+def generate(team_files, distance_files):
+    teams = {}
+    for path in team_files:
+        for line in read_lines(path)[1:]:
+            row = parse_team_row(line)
+            # First file wins, like importing with existing teams skipped
+            if row and row["teamName"] not in teams:
+                teams[row["teamName"]] = row
+
+    distances = {}
+    for path in distance_files:
+        for line in read_lines(path):
+            row = parse_distance_row(line)
+            if row:
+                distances[(row[0], row[1])] = row[2]
+
+    sources = ", ".join(os.path.basename(p) for p in team_files + distance_files)
+    lines = [
+        "// Generated by tools/embed_defaults.py from %s." % sources,
+        "// Do not edit; regenerate with `make defaultdata` after changing the CSVs.",
+        "",
+        '#include "defaultdata.h"',
+        "",
+        "namespace {",
+        "",
+        "constexpr DefaultTeamRecord Teams[] = {",
+    ]
+    for row in teams.values():
+        strings = ", ".join(literal(row[k]) for k in (
+            "teamName", "stadiumName", "location", "surface", "league",
+            "dateOpened", "typology", "roof"))
+        lines.append("    {%s, %d, %d, %d}," % (strings, row["capacity"], row["openedDay"], row["centerField"]))
+    lines += [
+        "};",
+        "",
+        "constexpr DefaultDistanceRecord Distances[] = {",
+    ]
+    for (source, target), miles in distances.items():
+        lines.append("    {%s, %s, %r}," % (literal(source), literal(target), miles))
+    lines += [
+        "};",
+        "",
+        "} // namespace",
+        "",
+        "namespace DefaultData {",
+        "",
+        "const DefaultTeamRecord *teams() { return Teams; }",
+        "int teamCount() { return int(sizeof(Teams) / sizeof(Teams[0])); }",
+        "const DefaultDistanceRecord *distances() { return Distances; }",
+        "int distanceCount() { return int(sizeof(Distances) / sizeof(Distances[0])); }",
+        "",
+        "} // namespace DefaultData",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--teams", nargs="+", required=True)
+    parser.add_argument("--distances", nargs="+", required=True)
+    parser.add_argument("--output", required=True)
+    args = parser.parse_args()
+
+    source = generate(args.teams, args.distances)
+    # Leave the file untouched when nothing changed so it is not rebuilt
+    if os.path.exists(args.output):
+        with open(args.output, encoding="utf-8") as f:
+            if f.read() == source:
+                return 0
+    with open(args.output, "w", encoding="utf-8", newline="\n") as f:
+        f.write(source)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())